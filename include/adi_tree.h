@@ -34,4 +34,7 @@ public:
     void remove(uint32_t id);
 
     const adi_node_t* get_root();
+
+    // heap bytes held by the tree nodes and the keys of the ids
+    size_t memory_used() const;
 };
@@ -2,6 +2,8 @@
 #include "query_analytics.h"
 #include "option.h"
 #include "raft_server.h"
+#include <array>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -90,6 +92,22 @@ struct event_cache_t {
     }
 };
 
+// Search query recorded for analytics, waiting to be merged into the QueryAnalytics of its rules
+struct buffered_query_t {
+    std::string query_collection;
+    std::string query;
+    std::string expanded_query;
+    std::string user_id;
+    uint64_t timestamp_us;
+    bool live_query;
+    bool nohits;
+};
+
+struct query_buffer_t {
+    std::mutex mutex;
+    std::vector<buffered_query_t> queries;
+};
+
 class AnalyticsManager {
 private:
     mutable std::mutex mutex;
@@ -99,6 +117,23 @@ private:
 
     const size_t QUERY_COMPACTION_INTERVAL_S = 30;
 
+    const size_t QUERY_BUFFER_MERGE_INTERVAL_S = 2;
+
+    static constexpr size_t NUM_QUERY_BUFFERS = 16;
+    static constexpr size_t MAX_BUFFERED_QUERIES = 4096;
+
+    // Searches only append to these buffers (sharded on the calling thread) and never touch `mutex`: the buffers
+    // are merged into the QueryAnalytics instances by `run()`, in the order the queries were made.
+    std::array<query_buffer_t, NUM_QUERY_BUFFERS> query_buffers;
+
+    // buffers that filled up between two merges, handed over to `run()` as they are
+    std::mutex full_query_buffers_mutex;
+    std::vector<std::vector<buffered_query_t>> full_query_buffers;
+    std::atomic<bool> has_full_query_buffers{false};
+
+    // size of query_collection_mapping, read by searches without locking
+    std::atomic<size_t> num_query_collections{0};
+
     struct suggestion_config_t {
         std::string name;
         std::string suggestion_collection;
@@ -169,6 +204,11 @@ private:
 
     std::string get_sub_event_type(const std::string& event_type);
 
+    void buffer_query(const std::string& query_collection, const std::string& query,
+                      const std::string& expanded_query, bool live_query, const std::string& user_id, bool nohits);
+
+    void merge_query_buffers();
+
 public:
 
     static constexpr const char* ANALYTICS_RULE_PREFIX = "$AR";
@@ -232,5 +272,7 @@ public:
 
     std::unordered_map<std::string, QueryAnalytics*> get_nohits_queries();
 
+    void get_query_buffer_stats(nlohmann::json& result);
+
     void resetToggleRateLimit(bool toggle);
 };
@@ -4,11 +4,58 @@
 #include "json.hpp"
 #include "logger.h"
 #include "tsconfig.h"
+#include "thread_local_vars.h"
 #include <mutex>
 #include <string>
 #include <shared_mutex>
 #include <mutex>
 #include <fstream>
+#include <atomic>
+#include <array>
+
+// Lock-free histogram of durations in microseconds. Each power of two is split into `SUB_BUCKETS` linear buckets,
+// so a percentile is off by at most 25% while recording a value is a couple of relaxed atomic increments.
+class latency_histogram_t {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 2;
+    static constexpr size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t MAX_EXPONENT = 40;
+    static constexpr size_t NUM_BUCKETS = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_us{0};
+
+public:
+    // bucket `i` holds the durations in (`upper_bound(i - 1)`, `upper_bound(i)`]
+    static size_t bucket_index(uint64_t duration_us);
+
+    static uint64_t upper_bound(size_t index);
+
+    void record(uint64_t duration_us);
+
+    uint64_t get_count() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t get_sum_us() const {
+        return sum_us.load(std::memory_order_relaxed);
+    }
+
+    // number of recorded durations that are at most `duration_us`, which is exact for bucket upper bounds
+    uint64_t count_at_most(uint64_t duration_us) const;
+
+    // upper bound of the bucket holding the given percentile (0 - 100)
+    uint64_t percentile(double p) const;
+};
+
+enum write_stage_t {
+    WRITE_STAGE_VALIDATE,
+    WRITE_STAGE_INDEX,
+    WRITE_STAGE_STORE,
+    NUM_WRITE_STAGES
+};
 
 class AppMetrics {
 private:
@@ -25,6 +72,14 @@ private:
     std::string access_log_path;
     std::ofstream access_log;
 
+    // cumulative since start, like Prometheus counters
+    std::array<latency_histogram_t, NUM_SEARCH_STAGES> search_stage_latencies;
+    std::array<latency_histogram_t, NUM_WRITE_STAGES> write_stage_latencies;
+    latency_histogram_t search_latency;
+
+    static void append_prometheus_histogram(const std::string& name, const std::string& stage,
+                                            const latency_histogram_t& histogram, std::string& out);
+
     AppMetrics() {
         current_counts = new spp::sparse_hash_map<std::string, uint64_t>();
         counts = new spp::sparse_hash_map<std::string, uint64_t>();
@@ -55,6 +110,12 @@ public:
 
     static const uint64_t METRICS_REFRESH_INTERVAL_MS = 10 * 1000;
 
+    static constexpr const char* SEARCH_STAGE_NAMES[NUM_SEARCH_STAGES] = {
+        "parse", "embed", "filter", "token_search", "grouping", "facets", "hit_fetch", "highlight", "serialization"
+    };
+
+    static constexpr const char* WRITE_STAGE_NAMES[NUM_WRITE_STAGES] = {"validate", "index", "store"};
+
     static AppMetrics & get_instance() {
         static AppMetrics instance;
         return instance;
@@ -75,6 +136,28 @@ public:
 
     void increment_write_metrics(uint64_t route_hash, uint64_t duration);
 
+    void record_search_stage(search_stage_t stage, uint64_t duration_us) {
+        search_stage_latencies[stage].record(duration_us);
+    }
+
+    // records the stages that the search that just ran on this thread entered, from `search_stage_us`
+    void record_search(uint64_t duration_us);
+
+    void record_write_stage(write_stage_t stage, uint64_t duration_us) {
+        write_stage_latencies[stage].record(duration_us);
+    }
+
+    const latency_histogram_t& get_search_stage_latency(search_stage_t stage) const {
+        return search_stage_latencies[stage];
+    }
+
+    const latency_histogram_t& get_write_stage_latency(write_stage_t stage) const {
+        return write_stage_latencies[stage];
+    }
+
+    // latency histograms in the Prometheus text exposition format
+    std::string get_prometheus_metrics() const;
+
     void write_access_log(const uint64_t epoch_millis, const char* remote_ip, const std::string& path);
 
     void flush_access_log();
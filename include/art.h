@@ -120,9 +120,13 @@ struct token_leaf {
 /**
  * Main struct, points to root.
  */
+struct art_prefix_topk;
+
 typedef struct {
     art_node *root;
     uint64_t size;
+    uint64_t version;   // bumped whenever a key is added or removed, i.e. whenever nodes can be reallocated
+    art_prefix_topk* prefix_topk;   // best scoring leaves of short key prefixes
 } art_tree;
 
 /*
@@ -243,6 +247,14 @@ art_leaf* art_maximum(art_tree *t);
  */
 int art_iter(art_tree *t, art_callback cb, void *data);
 
+/**
+ * Estimates the heap memory held by the tree.
+ * @arg t The tree
+ * @arg node_bytes Out: bytes held by the inner nodes, the leaves and the prefix top-k lists
+ * @arg posting_bytes Out: bytes held by the posting lists of the leaves
+ */
+void art_memory_used(const art_tree *t, uint64_t* node_bytes, uint64_t* posting_bytes);
+
 /**
  * Iterates through the entries pairs in the map,
  * invoking a callback for each that matches a given prefix.
@@ -272,6 +284,24 @@ int art_fuzzy_search_i(art_tree *t, const unsigned char *term, const int term_le
                      filter_result_iterator_t* const filter_result_iterator,
                      std::vector<art_leaf *> &results, std::set<std::string>& exclude_leaves);
 
+/**
+ * Collects the nodes whose subtrees hold the keys that are within a fuzzy distance of max_cost from term.
+ * The nodes stay valid only as long as t->version is unchanged.
+ */
+void art_fuzzy_nodes(const art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                     const int max_cost, const bool prefix, std::vector<const art_node*>& nodes);
+
+/**
+ * Same as art_fuzzy_search_i() but picks the top leaves from nodes previously collected by art_fuzzy_nodes() with the
+ * same min_cost and max_cost.
+ */
+int art_fuzzy_search_nodes(art_tree *t, const std::vector<const art_node*>& nodes,
+                           const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
+                           const size_t max_words, const token_ordering token_order,
+                           const bool prefix, bool last_token, const std::string& prev_token,
+                           filter_result_iterator_t* const filter_result_iterator,
+                           std::vector<art_leaf *> &results, std::set<std::string>& exclude_leaves);
+
 void encode_int32(int32_t n, unsigned char *chars);
 
 void encode_int64(int64_t n, unsigned char *chars);
@@ -120,6 +120,9 @@ private:
     // maps tag name => override_ids
     std::map<std::string, std::set<std::string>> override_tags;
 
+    // looks up the overrides that could match a query
+    OverrideIndex override_index;
+
     std::string default_sorting_field;
 
     const float max_memory_ratio;
@@ -474,6 +477,8 @@ public:
 
     const Index* _get_index() const;
 
+    Index* _get_index();
+
     bool facet_value_to_string(const facet &a_facet, const facet_count_t &facet_count, nlohmann::json &document,
                                std::string &value) const;
 
@@ -498,6 +503,8 @@ public:
 
     nlohmann::json get_summary_json() const;
 
+    nlohmann::json get_memory_usage() const;
+
     size_t batch_index_in_memory(std::vector<index_record>& index_records, const size_t remote_embedding_batch_size,
                                  const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries, const bool generate_embeddings);
 
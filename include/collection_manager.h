@@ -175,6 +175,9 @@ public:
 
     locked_resource_view_t<Collection> get_collection_with_id(uint32_t collection_id) const;
 
+    // per-collection totals of the estimated memory used by the in-memory structures
+    nlohmann::json get_memory_usage() const;
+
     Option<nlohmann::json> get_collection_summaries(uint32_t limit = 0 , uint32_t offset = 0) const;
 
     Option<nlohmann::json> drop_collection(const std::string& collection_name,
@@ -25,6 +25,8 @@ bool del_drop_collection(const std::shared_ptr<http_req>& req, const std::shared
 
 bool get_collection_summary(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
 
+bool get_collection_memory(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
+
 // Documents
 
 bool get_search(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
@@ -121,6 +123,10 @@ bool get_metrics_json(const std::shared_ptr<http_req>& req, const std::shared_pt
 
 bool get_stats_json(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
 
+bool get_prometheus_metrics(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
+
+bool get_memory_json(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
+
 bool get_status(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
 
 // operations
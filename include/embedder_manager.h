@@ -6,6 +6,9 @@
 #include <unordered_map>
 #include <openssl/md5.h>
 #include <fstream>
+#include <chrono>
+#include <atomic>
+#include "lru/lru.hpp"
 #include "logger.h"
 #include "http_client.h"
 #include "option.h"
@@ -32,6 +35,11 @@ struct text_embedding_model {
     text_embedding_model() = default;
 };
 
+struct query_embedding_cache_entry_t {
+    std::vector<float> embedding;
+    std::chrono::steady_clock::time_point expires_at;
+};
+
 // Singleton class
 class EmbedderManager {
 public:
@@ -45,6 +53,14 @@ public:
     Option<TextEmbedder*> get_text_embedder(const nlohmann::json& model_config);
     Option<ImageEmbedder*> get_image_embedder(const nlohmann::json& model_config);
 
+    // Embeds a search query, serving repeated queries from the query embedding cache.
+    embedding_res_t embed_query(const nlohmann::json& model_config, TextEmbedder* embedder, const std::string& query,
+                                const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries);
+
+    void clear_query_embedding_cache();
+
+    void get_query_embedding_cache_stats(nlohmann::json& result);
+
     void delete_text_embedder(const std::string& model_path);
     void delete_all_text_embedders();
 
@@ -63,6 +79,9 @@ public:
     inline static const std::string MODEL_CONFIG_FILE = "config.json";
     inline static std::string model_dir = "";
 
+    static constexpr size_t QUERY_EMBEDDING_CACHE_SIZE = 4096;
+    static constexpr uint64_t DEFAULT_QUERY_CACHE_TTL_S = 3600;
+
     static const std::string get_absolute_model_path(const std::string& model_name);
     static const std::string get_absolute_vocab_path(const std::string& model_name, const std::string& vocab_file_name);
     static const std::string get_absolute_config_path(const std::string& model_name);
@@ -96,6 +115,14 @@ private:
     std::unordered_map<std::string, text_embedding_model> public_models;
     std::mutex text_embedders_mutex, image_embedders_mutex;
 
+    // (model key, query) -> embedding
+    std::mutex query_embedding_cache_mutex;
+    LRU::Cache<std::string, query_embedding_cache_entry_t> query_embedding_cache{QUERY_EMBEDDING_CACHE_SIZE};
+    std::atomic<uint64_t> query_embedding_cache_hits{0};
+    std::atomic<uint64_t> query_embedding_cache_misses{0};
+
+    static std::string get_model_key(const nlohmann::json& model_config);
+
     static Option<std::string> get_namespace(const std::string& model_name);
 };
 
@@ -139,6 +139,9 @@ public:
 
     size_t get_facet_count(const std::string& field_name);
 
+    // heap bytes held by the value and hash indices of the field
+    size_t memory_used(const std::string& field_name) const;
+
     size_t intersect(facet& a_facet, const field& facet_field,
                      bool has_facet_query,
                      bool estimate_facets,
@@ -70,6 +70,8 @@ namespace fields {
     // For e.g. e5-small model requires prefix "passage:" for indexing and "query:" for querying
     static const std::string indexing_prefix = "indexing_prefix";
     static const std::string query_prefix = "query_prefix";
+    // seconds for which embeddings of search queries are cached, 0 disables caching for the model
+    static const std::string query_cache_ttl = "query_cache_ttl";
     static const std::string api_key = "api_key";
     static const std::string model_config = "model_config";
 
@@ -742,6 +744,9 @@ struct facet {
 
     uint32_t orig_index;
 
+    // time spent counting the values of this facet, summed across the threads that worked on it
+    uint64_t compute_time_us = 0;
+
     bool get_range(int64_t key, std::pair<int64_t, std::string>& range_pair) {
         if(facet_range_map.empty()) {
             LOG (ERROR) << "Facet range is not defined!!!";
@@ -5,10 +5,14 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <atomic>
 #include "num_tree.h"
+#include "numeric_range_trie.h"
 #include "option.h"
 #include "posting_list.h"
 #include "id_list.h"
+#include "json.hpp"
 
 class Index;
 struct filter_node_t;
@@ -216,12 +220,21 @@ struct filter_result_t {
     constexpr uint16_t function_call_modulo = 10;
     constexpr uint16_t string_filter_ids_threshold = 3;
     constexpr uint16_t bool_filter_ids_threshold = 3;
+    constexpr uint16_t numeric_filter_ids_threshold = 3;
 #else
     constexpr uint16_t function_call_modulo = 16'384;
     constexpr uint16_t string_filter_ids_threshold = 20'000;
     constexpr uint16_t bool_filter_ids_threshold = 20'000;
+    constexpr uint16_t numeric_filter_ids_threshold = 20'000;
 #endif
 
+/// A sub-expression of AND that is estimated to match this many times more ids than its sibling is iterated rather than
+/// materialized, when its filter supports iteration.
+constexpr uint32_t prefer_iteration_selectivity_ratio = 16;
+
+/// Estimated number of ids matched by each node of a filter tree.
+using filter_estimates_t = std::unordered_map<filter_node_t const*, uint32_t>;
+
 struct filter_result_iterator_timeout_info {
     filter_result_iterator_timeout_info(uint64_t search_begin_us, uint64_t search_stop_us);
 
@@ -263,10 +276,46 @@ private:
     /// Used in case of a single boolean filter matching more than `bool_filter_ids_threshold` ids.
     num_tree_t::iterator_t bool_iterator = num_tree_t::iterator_t(nullptr, NUM_COMPARATOR::EQUALS, 0);
 
+    /// Used in case of a single comparison on a range indexed numeric field matching more than
+    /// `numeric_filter_ids_threshold` ids, so that the matched ids need not be materialized.
+    NumericTrie::iterator_t numeric_iterator;
+
     bool delete_filter_node = false;
 
     std::unique_ptr<filter_result_iterator_timeout_info> timeout_info;
 
+    /// Time taken to build and initialize this node, including its sub-nodes.
+    uint64_t init_time_us = 0;
+
+    /// Number of ids this node is estimated to match, set by the parent node while planning the evaluation of its
+    /// sub-expressions. UINT32_MAX for the root node.
+    uint32_t estimated_ids_length = UINT32_MAX;
+
+    /// Set when the AND sibling of this node is estimated to match far fewer ids.
+    bool prefer_iteration = false;
+
+    /// Set when this node was not evaluated since its AND sibling does not match any document.
+    bool is_skipped = false;
+
+    /// Creates the sub-iterators of an operator node and then initializes this node. `estimates` holds the estimate of
+    /// every node of the filter tree.
+    void build(const filter_estimates_t& estimates);
+
+    /// Creates the sub-iterators of an operator node. The sub-expressions of AND are evaluated in the ascending order of
+    /// their estimated matches, and the second one is skipped if the first one does not match any document.
+    void init_sub_iterators(const filter_estimates_t& estimates);
+
+    /// Estimates the number of ids matched by the sub-expression from the sizes of the id lists in the index, without
+    /// evaluating it. Filters that cannot be estimated are assumed to match every document. The estimate of every node
+    /// of the sub-expression is stored in `estimates`, so that each leaf is estimated only once.
+    uint32_t estimate_filter_ids_length(filter_node_t const* const node, filter_estimates_t& estimates) const;
+
+    /// Estimates the number of ids matched by a filter that is not an operator.
+    [[nodiscard]] uint32_t estimate_leaf_filter_ids_length(filter_node_t const* const node) const;
+
+    /// Returns true if the sub-expression can be left unevaluated without hiding an error its evaluation would report.
+    [[nodiscard]] bool can_skip(filter_node_t const* const node) const;
+
     /// Initializes the state of iterator node after it's creation.
     void init();
 
@@ -306,6 +355,11 @@ public:
     /// Initialization status of the iterator.
     Option<bool> status = Option(true);
 
+#ifdef TEST_BUILD
+    /// Number of filters that were estimated while planning filter trees.
+    static inline std::atomic<uint32_t> num_leaf_estimates = 0;
+#endif
+
     /// Holds the upper-bound of the number of seq ids this iterator would match.
     /// Useful in a scenario where we need to differentiate between filter iterator not matching any document v/s filter
     /// iterator reaching it's end. (is_valid would be false in both these cases)
@@ -330,6 +384,14 @@ public:
     /// Recursively computes the result of each node and stores the final result in the root node.
     void compute_iterators();
 
+    /// Returns true when the matching ids are already materialized, making `to_filter_id_array` a copy.
+    bool is_computed() const {
+        return is_filter_result_initialized;
+    }
+
+    /// Returns the iterator tree along with the estimated cardinality and initialization time of each node.
+    nlohmann::json get_profile() const;
+
     /// Returns a tri-state:
     ///     0: id is not valid
     ///     1: id is valid
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <s2/s2cap.h>
+#include <s2/s2loop.h>
+#include <s2/s2latlng_rect.h>
+
+/// Verifies packed lat/lng points (see `GeoPoint::pack_lat_lng`) against the region of a geo filter in batches.
+///
+/// The micro-degree coordinates of four points at a time are compared in SSE lanes against the region's bounding
+/// box, which rejects the points lying outside it. For circles, the points inside a box inscribed in the circle are
+/// accepted as well. Only the points left undecided are unpacked and tested with the exact S2 containment check, so
+/// the result is identical to calling `S2Region::Contains` on every point.
+class geo_point_verifier_t {
+private:
+    const S2Region* region;
+
+    // Bounds are exclusive and in micro-degrees. An empty box is represented by lo >= hi.
+    int32_t outer_lat_lo = 0, outer_lat_hi = 0, outer_lng_lo = 0, outer_lng_hi = 0;
+    int32_t inner_lat_lo = 0, inner_lat_hi = 0, inner_lng_lo = 0, inner_lng_hi = 0;
+
+    void set_outer_bounds(const S2LatLngRect& rect_bound);
+
+    void set_inner_bounds(const S2Cap& cap);
+
+    bool contains_exact(int64_t packed_lat_lng) const;
+
+    // 0: outside, 1: inside, -1: undecided
+    int classify(int64_t packed_lat_lng) const;
+
+public:
+    explicit geo_point_verifier_t(const S2Cap& cap);
+
+    explicit geo_point_verifier_t(const S2Loop& loop);
+
+    /// Sets `matches[i]` to 1 when `packed_lat_lngs[i]` lies within the region and to 0 otherwise.
+    void verify(const int64_t* packed_lat_lngs, size_t num_points, uint8_t* matches) const;
+};
@@ -2,6 +2,9 @@
 
 #include <string>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
 #include <curl/curl.h>
 #include "http_data.h"
 #include "http_server.h"
@@ -14,6 +17,20 @@ private:
     static std::string api_key;
     static std::string ca_cert_path;
 
+    // Easy handles of finished blocking requests are kept around for reuse: a reset handle retains its live
+    // connections, so keep-alive connections, DNS lookups and TLS sessions survive across requests.
+    static constexpr size_t MAX_IDLE_HANDLES = 32;
+    static std::mutex idle_handles_mutex;
+    static std::vector<CURL*> idle_handles;
+
+    // DNS and TLS session caches shared by all pooled handles
+    static CURLSH* share_handle;
+    static std::mutex share_mutexes[CURL_LOCK_DATA_LAST];
+
+    static std::atomic<uint64_t> num_requests;
+    static std::atomic<uint64_t> num_reused_handles;
+    static std::atomic<uint64_t> num_reused_connections;
+
     HttpClient() = default;
 
     ~HttpClient() = default;
@@ -30,6 +47,14 @@ private:
 
     static size_t curl_write_download(void *ptr, size_t size, size_t nmemb, FILE *stream);
 
+    static CURL* acquire_handle();
+
+    static void release_handle(CURL* curl);
+
+    static void share_lock(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr);
+
+    static void share_unlock(CURL* curl, curl_lock_data data, void* userptr);
+
     static CURL* init_curl(const std::string& url, std::string& response, const size_t timeout_ms = 0);
 
     static CURL* init_curl_async(const std::string& url, deferred_req_res_t* req_res, curl_slist*& chunk,
@@ -52,6 +77,11 @@ public:
 
     void init(const std::string & api_key);
 
+    // must be called before curl_global_cleanup()
+    void dispose();
+
+    static void get_pool_stats(nlohmann::json& result);
+
     static long download_file(const std::string& url, const std::string& file_path);
 
     static long get_response(const std::string& url, std::string& response,
@@ -35,6 +35,8 @@ struct compact_id_list_t {
 
     [[nodiscard]] uint32_t num_ids() const;
 
+    [[nodiscard]] size_t memory_used() const;
+
     size_t intersect_count(const uint32_t* res_ids, size_t res_ids_len);
 };
 
@@ -86,6 +88,8 @@ public:
 
     static uint32_t num_ids(const void* obj);
 
+    static size_t memory_used(const void* obj);
+
     static uint32_t first_id(const void* obj);
 
     static bool contains(const void* obj, uint32_t id);
@@ -32,6 +32,7 @@
 #include "filter.h"
 #include "facet_index.h"
 #include "numeric_range_trie.h"
+#include "lru/lru.hpp"
 
 static constexpr size_t ARRAY_FACET_DIM = 4;
 using facet_map_t = spp::sparse_hash_map<uint32_t, facet_hash_values_t>;
@@ -42,6 +43,18 @@ using array_mapped_single_val_facet_t = std::array<single_val_facet_map_t*, ARRA
 static constexpr size_t ARRAY_INFIX_DIM = 4;
 using array_mapped_infix_t = std::vector<tsl::htrie_set<char>*>;
 
+// A join whose referenced side matches at least `reference_bitmap_join_min_ids` documents, and at least
+// 1/`reference_bitmap_join_scan_ratio` of the documents of this collection, scans the reference helper column in
+// chunks of `reference_bitmap_join_chunk_size` documents instead of looking up the documents of every referenced id.
+#ifdef TEST_BUILD
+    constexpr uint32_t reference_bitmap_join_min_ids = 2;
+    constexpr uint32_t reference_bitmap_join_chunk_size = 4;
+#else
+    constexpr uint32_t reference_bitmap_join_min_ids = 10'000;
+    constexpr uint32_t reference_bitmap_join_chunk_size = 16'384;
+#endif
+constexpr uint32_t reference_bitmap_join_scan_ratio = 8;
+
 struct token_t {
     size_t position;
     std::string value;
@@ -318,6 +331,16 @@ struct hnsw_index_t {
     // ensures that this index is not dropped when it's being repaired
     std::mutex repair_m;
 
+    // Batches of at least this many records are bulk built: all cores add points, with the index write lock held
+    // so that searches only see the graph once the whole batch is in.
+    static constexpr size_t BULK_BUILD_MIN_BATCH = 500;
+    static constexpr size_t BULK_BUILD_CHUNK_SIZE = 32;
+    static constexpr size_t BULK_BUILD_REPORT_INTERVAL = 100'000;
+
+    // throughput of bulk builds, reported every `BULK_BUILD_REPORT_INTERVAL` points
+    std::atomic<size_t> num_bulk_built_points = 0;
+    std::atomic<uint64_t> bulk_build_time_us = 0;
+
     hnsw_index_t(size_t num_dim, size_t init_size, vector_distance_type_t distance_type, size_t M = 16, size_t ef_construction = 200) :
         space(new hnswlib::InnerProductSpace(num_dim)),
         vecdex(new hnswlib::HierarchicalNSW<float>(space, init_size, M, ef_construction, 100, true)),
@@ -331,6 +354,20 @@ struct hnsw_index_t {
         delete space;
     }
 
+    // heap bytes held by the graph: the preallocated level 0 arena of vectors and links, the per element
+    // bookkeeping (link list pointer, level and lock), the links of the upper levels and the label lookup
+    size_t memory_used() const {
+        const size_t max_elements = vecdex->max_elements_;
+        size_t bytes = max_elements * (vecdex->size_data_per_element_ + sizeof(void*) + sizeof(int) + sizeof(std::mutex));
+
+        const size_t num_elements = vecdex->cur_element_count;
+        for(size_t i = 0; i < num_elements; i++) {
+            bytes += vecdex->element_levels_[i] * vecdex->size_links_per_element_;
+        }
+
+        return bytes + vecdex->label_lookup_.size() * (2 * sizeof(size_t) + 2 * sizeof(void*));
+    }
+
     // needed for cosine similarity
     static void normalize_vector(const std::vector<float>& src, std::vector<float>& norm_dest) {
         float norm = 0.0f;
@@ -344,6 +381,35 @@ struct hnsw_index_t {
     }
 };
 
+// Caches the ART nodes matched by the fuzzy lookup of a (token, cost, prefix) combination on a field, so that
+// repeated tokens (e.g. autocomplete prefixes) skip the trie traversal. Since an entry holds node pointers, it is
+// served only while the tree's version still matches the one it was computed against.
+struct typo_candidate_cache_t {
+    static constexpr size_t CAPACITY = 4096;
+    static constexpr size_t MAX_CACHED_NODES = 1024;
+
+    struct entry_t {
+        const art_tree* tree = nullptr;
+        uint64_t version = 0;
+        std::vector<const art_node*> nodes;
+    };
+
+    std::mutex mutex;
+    LRU::Cache<std::string, entry_t> entries;
+
+    typo_candidate_cache_t(): entries(CAPACITY) {
+
+    }
+
+    void get_nodes(const std::string& tree_name, const art_tree* t, const unsigned char* term, int term_len,
+                   int cost, bool prefix, std::vector<const art_node*>& nodes);
+
+    void clear() {
+        std::unique_lock lk(mutex);
+        entries.clear();
+    }
+};
+
 struct group_by_field_it_t {
     std::string field_name;
     posting_list_t::iterator_t it;
@@ -383,6 +449,9 @@ private:
 
     spp::sparse_hash_map<std::string, art_tree*> search_index;
 
+    // must be cleared whenever an art tree is destroyed, since a new tree can be allocated at the same address
+    mutable typo_candidate_cache_t typo_candidate_cache;
+
     spp::sparse_hash_map<std::string, num_tree_t*> numerical_index;
 
     // reference_helper_field => (seq_id => ref_seq_ids)
@@ -509,7 +578,8 @@ private:
                                        std::array<spp::sparse_hash_map<uint32_t, int64_t, Hasher32>*, 3>& field_values,
                                        const std::vector<size_t>& geopoint_indices,
                                        std::set<uint64>& query_hashes,
-                                       std::vector<uint32_t>& id_buff, const std::string& collection_name = "") const;
+                                       std::vector<uint32_t>& id_buff, const std::string& collection_name = "",
+                                       const size_t concurrency = 1) const;
 
     static void popular_fields_of_token(const spp::sparse_hash_map<std::string, art_tree*>& search_index,
                                         const std::string& previous_token,
@@ -519,6 +589,12 @@ private:
 
     bool field_is_indexed(const std::string& field_name) const;
 
+    /// Joins the referenced ids with the documents of this collection by testing the reference helper field of every
+    /// document against a bitmap of the referenced ids. Chunks of documents are scanned in parallel.
+    Option<filter_result_t> do_bitmap_join_with_reference_ids(const std::string& reference_helper_field_name,
+                                                              const std::string& ref_collection_name,
+                                                              const filter_result_t& ref_filter_result) const;
+
     static void tokenize_string(const std::string& text,
                                 const field& a_field,
                                 const std::vector<char>& symbols_to_index,
@@ -556,6 +632,11 @@ private:
 
     std::vector<group_by_field_it_t> get_group_by_field_iterators(const std::vector<std::string>&, bool is_reverse=false) const;
 
+    // Text (or image) that is embedded into `embedding_field` for the given document
+    static std::string get_embedding_source(const field& embedding_field, const nlohmann::json& document,
+                                            const tsl::htrie_map<char, field>& search_schema,
+                                            const std::string& indexing_prefix, bool& is_image_embedding);
+
     static void batch_embed_fields(std::vector<index_record*>& documents,
                                    const tsl::htrie_map<char, field>& embedding_fields,
                                    const tsl::htrie_map<char, field> & search_schema, const size_t remote_embedding_batch_size = 200,
@@ -574,6 +655,9 @@ public:
     enum {COMBINATION_MAX_LIMIT = 10000};
     enum {COMBINATION_MIN_LIMIT = 10};
 
+    // text match candidates are scored in parallel partitions of at least this many documents
+    enum {SEARCH_PARTITION_MIN_SIZE = 5000};
+
     enum {NUM_CANDIDATES_DEFAULT_MIN = 4};
     enum {NUM_CANDIDATES_DEFAULT_MAX = 10};
 
@@ -581,6 +665,12 @@ public:
     // in the query that have the least individual hits one by one until enough results are found.
     static const int DROP_TOKENS_THRESHOLD = 1;
 
+    // geo k-nearest-neighbour search starts with a cap of this radius around the sort origin
+    static constexpr double GEO_KNN_INITIAL_RADIUS_METERS = 1000;
+
+    // caps larger than half the earth's circumference cover every point
+    static constexpr double GEO_KNN_MAX_RADIUS_METERS = 20'040'000;
+
     Index() = delete;
 
     Index(const std::string& name,
@@ -627,6 +717,8 @@ public:
 
     const spp::sparse_hash_map<std::string, art_tree *>& _get_search_index() const;
 
+    void _set_thread_pool(ThreadPool* pool);
+
     const spp::sparse_hash_map<std::string, num_tree_t*>& _get_numerical_index() const;
 
     const spp::sparse_hash_map<std::string, NumericTrie*>& _get_range_index() const;
@@ -729,6 +821,8 @@ public:
 
     void index_field_in_memory(const field& afield, std::vector<index_record>& iter_batch);
 
+    void bulk_build_vector_index(const field& afield, std::vector<index_record>& iter_batch);
+
     template<class T>
     void iterate_and_index_numerical_field(std::vector<index_record>& iter_batch, const field& afield, T func);
 
@@ -757,6 +851,20 @@ public:
 
     // the following methods are not synchronized because their parent calls are synchronized or they are const/static
 
+    std::vector<std::pair<float, size_t>> hybrid_vector_search(const vector_query_t& vector_query, size_t fetch_size,
+                                                               filter_result_iterator_t* filter_result_iterator,
+                                                               const uint32_t* excluded_result_ids,
+                                                               size_t excluded_result_ids_size) const;
+
+    /// For a wildcard query whose primary sort is ascending distance from a geopoint, collects the filtered ids
+    /// lying within a cap around that point, growing the cap until it holds at least `k` ids. Every id outside the
+    /// final cap is farther away than every id inside it, so only the returned ids need to be scored. Returns false
+    /// when the cap stops being cheaper than scanning all the filter ids.
+    bool geo_knn_candidates(const sort_by& geo_sort_field, size_t k,
+                            filter_result_iterator_t* const filter_result_iterator,
+                            const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
+                            filter_result_t& candidates) const;
+
     Option<bool> search_wildcard(filter_node_t const* const& filter_tree_root,
                                  const std::map<size_t, std::map<size_t, uint32_t>>& included_ids_map,
                                  const std::vector<sort_by>& sort_fields, Topster* topster, Topster* curated_topster,
@@ -807,6 +915,10 @@ public:
 
     size_t num_seq_ids() const;
 
+    /// Estimates the bytes held by each in-memory structure of the index, in total and per field.
+    /// Walks every structure, so it takes time proportional to the size of the index.
+    nlohmann::json get_memory_usage() const;
+
     void handle_exclusion(const size_t num_search_fields, std::vector<query_tokens_t>& field_query_tokens,
                           const std::vector<search_field_t>& search_fields, uint32_t*& exclude_token_ids,
                           size_t& exclude_token_ids_size) const;
@@ -916,7 +1028,8 @@ public:
                                                    std::array<spp::sparse_hash_map<uint32_t, int64_t, Hasher32>*, 3>& field_values,
                                                    const std::vector<size_t>& geopoint_indices,
                                                    const std::string& collection_name = "",
-                                                   bool enable_typos_for_numerical_tokens = true) const;
+                                                   bool enable_typos_for_numerical_tokens = true,
+                                                   const size_t concurrency = 1) const;
 
     void find_across_fields(const token_t& previous_token,
                             const std::string& previous_token_str,
@@ -957,7 +1070,8 @@ public:
                                       const std::vector<size_t>& geopoint_indices,
                                       std::vector<uint32_t>& id_buff,
                                       uint32_t*& all_result_ids, size_t& all_result_ids_len,
-                                      const std::string& collection_name = "") const;
+                                      const std::string& collection_name = "",
+                                      const size_t concurrency = 1) const;
 
     void
     search_fields(const std::vector<filter>& filters,
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// B+-tree that maps int64_t keys to opaque values (id lists), used by `num_tree_t`.
+///
+/// Keys and values are stored contiguously in fixed-capacity nodes and the leaves are linked in both directions, so
+/// range scans walk sorted arrays instead of chasing a pointer per key. Nodes are searched with a branchless binary
+/// search. Deletions only unlink nodes that become empty: underfull nodes are left alone, since the separator keys
+/// of the inner nodes remain valid bounds after keys are removed from below them.
+class int64_btree_t {
+public:
+    static constexpr uint16_t LEAF_CAPACITY = 64;
+    static constexpr uint16_t INNER_CAPACITY = 64;
+
+    // leaves are bulk loaded to this many keys, leaving room for later inserts
+    static constexpr uint16_t BULK_LOAD_LEAF_FILL = 56;
+
+private:
+    struct node_t {
+        bool is_leaf;
+        uint16_t count = 0;
+        int64_t keys[LEAF_CAPACITY > INNER_CAPACITY ? LEAF_CAPACITY : INNER_CAPACITY];
+
+        explicit node_t(bool is_leaf): is_leaf(is_leaf) {}
+    };
+
+    struct leaf_t: node_t {
+        void* values[LEAF_CAPACITY];
+        leaf_t* prev = nullptr;
+        leaf_t* next = nullptr;
+
+        leaf_t(): node_t(true) {}
+    };
+
+    struct inner_t: node_t {
+        // children[i] holds the keys in [keys[i-1], keys[i])
+        node_t* children[INNER_CAPACITY + 1];
+
+        inner_t(): node_t(false) {}
+    };
+
+    node_t* root = nullptr;
+    leaf_t* head = nullptr;
+    leaf_t* tail = nullptr;
+
+    size_t num_keys = 0;
+    size_t num_leaves = 0;
+    size_t num_inners = 0;
+
+    /// Number of keys less than `key`.
+    static uint16_t lower_bound_index(const int64_t* keys, uint16_t count, int64_t key);
+
+    /// Number of keys less than or equal to `key`.
+    static uint16_t upper_bound_index(const int64_t* keys, uint16_t count, int64_t key);
+
+    leaf_t* find_leaf(int64_t key) const;
+
+    /// Returns the new right sibling of `node` if it had to be split, with its smallest key in `split_key`.
+    node_t* insert(node_t* node, int64_t key, void* value, int64_t& split_key);
+
+    /// Returns true if `node` became empty and was freed.
+    bool erase(node_t* node, int64_t key, bool& erased);
+
+    void unlink_leaf(leaf_t* leaf);
+
+    static void destroy(node_t* node);
+
+public:
+    class iterator_t {
+        leaf_t* leaf = nullptr;
+        uint16_t index = 0;
+
+        friend class int64_btree_t;
+
+        iterator_t(leaf_t* leaf, uint16_t index): leaf(leaf), index(index) {}
+
+    public:
+        iterator_t() = default;
+
+        [[nodiscard]] bool valid() const {
+            return leaf != nullptr;
+        }
+
+        [[nodiscard]] int64_t key() const {
+            return leaf->keys[index];
+        }
+
+        [[nodiscard]] void*& value() const {
+            return leaf->values[index];
+        }
+
+        void next() {
+            if(++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+
+        void prev() {
+            if(index == 0) {
+                leaf = leaf->prev;
+                index = (leaf == nullptr) ? 0 : leaf->count - 1;
+            } else {
+                index--;
+            }
+        }
+
+        bool operator==(const iterator_t& other) const {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const iterator_t& other) const {
+            return !(*this == other);
+        }
+    };
+
+    int64_btree_t() = default;
+
+    int64_btree_t(const int64_btree_t&) = delete;
+
+    int64_btree_t& operator=(const int64_btree_t&) = delete;
+
+    ~int64_btree_t();
+
+    [[nodiscard]] bool empty() const {
+        return num_keys == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return num_keys;
+    }
+
+    /// Returns the slot holding the value of `key`, or nullptr when the key is absent.
+    [[nodiscard]] void** find(int64_t key) const;
+
+    /// Inserts a key that is not present in the tree yet.
+    void insert(int64_t key, void* value);
+
+    /// Removes `key` and returns true if it was present. The value is not freed.
+    bool erase(int64_t key);
+
+    /// Builds the tree from key/value pairs sorted by unique keys. The tree must be empty.
+    void bulk_load(const std::vector<std::pair<int64_t, void*>>& sorted_kvs);
+
+    /// Iterator to the first key that is not less than `key`.
+    [[nodiscard]] iterator_t lower_bound(int64_t key) const;
+
+    [[nodiscard]] iterator_t begin() const {
+        return iterator_t(num_keys == 0 ? nullptr : head, 0);
+    }
+
+    /// Iterator to the largest key, for walking the tree backwards with `prev()`.
+    [[nodiscard]] iterator_t last() const {
+        return num_keys == 0 ? iterator_t() : iterator_t(tail, tail->count - 1);
+    }
+
+    [[nodiscard]] static iterator_t end() {
+        return iterator_t();
+    }
+
+    /// Heap bytes held by the nodes of the tree, excluding the values.
+    [[nodiscard]] size_t memory_used() const {
+        return num_leaves * sizeof(leaf_t) + num_inners * sizeof(inner_t);
+    }
+};
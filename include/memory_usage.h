@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Estimates of the heap memory held by standard containers, used to report the memory used by the indices.
+// They count the allocations a container makes for its elements, not the allocator's own bookkeeping.
+
+// node of a red-black tree (std::map, std::set): color and 3 links, followed by the value
+static constexpr size_t TREE_NODE_OVERHEAD = 4 * sizeof(void*);
+
+// node of a std::list: 2 links, followed by the value
+static constexpr size_t LIST_NODE_OVERHEAD = 2 * sizeof(void*);
+
+template <class Map>
+size_t tree_map_memory_used(const Map& map) {
+    return map.size() * (TREE_NODE_OVERHEAD + sizeof(typename Map::value_type));
+}
+
+// std::unordered_map: a node with the value, a link and the cached hash per element, and a pointer per bucket
+template <class Map>
+size_t hash_map_memory_used(const Map& map) {
+    return map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*)) + map.bucket_count() * sizeof(void*);
+}
+
+// spp::sparse_hash_map: the values are packed into groups that only spend a couple of bits per empty bucket
+template <class Map>
+size_t sparse_hash_map_memory_used(const Map& map) {
+    return map.size() * sizeof(typename Map::value_type) + map.bucket_count() / 4;
+}
+
+// strings that fit the small string buffer do not allocate
+inline size_t string_memory_used(const std::string& str) {
+    return str.capacity() > 15 ? str.capacity() + 1 : 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <map>
+#include <functional>
+#include "int64_btree.h"
 #include "sparsepp.h"
 #include "sorted_array.h"
 #include "array_utils.h"
@@ -9,17 +10,13 @@
 
 class num_tree_t {
 private:
-    std::map<int64_t, void*> int64map;
+    int64_btree_t int64tree;
 
     [[nodiscard]] bool range_inclusive_contains(const int64_t& start, const int64_t& end, const uint32_t& id) const;
 
     [[nodiscard]] bool contains(const int64_t& value, const uint32_t& id) const {
-        if (int64map.count(value) == 0) {
-            return false;
-        }
-
-        auto ids = int64map.at(value);
-        return ids_t::contains(ids, id);
+        void** ids = int64tree.find(value);
+        return ids != nullptr && ids_t::contains(*ids, id);
     }
 
 public:
@@ -28,10 +25,17 @@ public:
 
     void insert(int64_t value, uint32_t id, bool is_facet=false);
 
+    /// Inserts a batch of (value, seq_id) pairs, sorting them in place. An empty tree is bulk loaded.
+    void insert_batch(std::vector<std::pair<int64_t, uint32_t>>& value_ids);
+
     void range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len);
 
     void approx_range_inclusive_search_count(int64_t start, int64_t end, uint32_t& ids_len);
 
+    /// Calls `func(value, ids)` for every value in [start, end], in ascending order of value.
+    void range_inclusive_for_each(int64_t start, int64_t end,
+                                  const std::function<void(int64_t, const std::vector<uint32_t>&)>& func) const;
+
     void range_inclusive_contains(const int64_t& start, const int64_t& end,
                                   const uint32_t& context_ids_length,
                                   uint32_t* const& context_ids,
@@ -48,6 +52,9 @@ public:
 
     size_t size();
 
+    // heap bytes held by the tree and its id lists
+    size_t memory_used() const;
+
     void seq_ids_outside_top_k(size_t k, std::vector<uint32_t>& seq_ids);
 
     void contains(const NUM_COMPARATOR& comparator, const int64_t& value,
@@ -60,6 +60,12 @@ class NumericTrie {
 
         uint32_t get_ids_length();
 
+        [[nodiscard]] void* get_seq_ids() const {
+            return seq_ids;
+        }
+
+        size_t memory_used() const;
+
         void search_range(const int64_t& low, const int64_t& high, const char& max_level,
                           uint32_t*& ids, uint32_t& ids_length);
 
@@ -95,25 +101,39 @@ public:
         delete positive_trie;
     }
 
+    /// Lazily merges the id lists of the matched nodes in ascending order of id, without materializing the union.
     class iterator_t {
+        /// Cursor over the id list of a matched node. Compact lists are read in place, full lists block by block.
         struct match_state {
-            uint32_t* ids = nullptr;
-            uint32_t ids_length = 0;
+            void* seq_ids = nullptr;
             uint32_t index = 0;
+            id_list_t::iterator_t id_list_it = id_list_t::iterator_t(nullptr, nullptr, nullptr, false);
 
-            explicit match_state(uint32_t*& ids, uint32_t& ids_length) : ids(ids), ids_length(ids_length) {}
+            explicit match_state(void* seq_ids);
 
-            ~match_state() {
-                delete [] ids;
-            }
+            void reset();
+            [[nodiscard]] bool valid() const;
+            [[nodiscard]] uint32_t id() const;
+            void next();
+            void skip_to(uint32_t id);
         };
 
         std::vector<match_state*> matches;
 
+        /// Min-heap over the current id of the matches that are not exhausted.
+        std::vector<match_state*> heap;
+
+        static bool heap_compare(const match_state* a, const match_state* b) {
+            return a->id() > b->id();
+        }
+
+        void build_heap();
         void set_seq_id();
 
     public:
 
+        iterator_t() = default;
+
         explicit iterator_t(std::vector<Node*>& matches);
 
         ~iterator_t() {
@@ -125,7 +145,10 @@ public:
         iterator_t& operator=(iterator_t&& obj) noexcept;
 
         uint32_t seq_id = 0;
-        bool is_valid = true;
+        bool is_valid = false;
+
+        /// Sum of the lengths of the matched id lists. Overcounts ids present in more than one list (array fields).
+        uint32_t approx_filter_ids_length = 0;
 
         void next();
         void skip_to(uint32_t id);
@@ -166,4 +189,7 @@ public:
     void seq_ids_outside_top_k(const size_t& k, std::vector<uint32_t>& result);
 
     size_t size();
+
+    // heap bytes held by the nodes of the trie and their id lists
+    size_t memory_used() const;
 };
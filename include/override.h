@@ -1,5 +1,8 @@
 #pragma once
 #include <string>
+#include <set>
+#include <memory>
+#include <unordered_map>
 #include <json.hpp>
 #include "option.h"
 
@@ -57,3 +60,53 @@ struct override_t {
 
     nlohmann::json to_json() const;
 };
+
+// Indexes override rules so that the overrides which could possibly match a query can be looked up
+// without evaluating every rule defined on the collection. The candidates returned are a superset of
+// the matching overrides: `Collection::does_override_match` remains the source of truth.
+class OverrideIndex {
+private:
+    struct token_node_t {
+        std::unordered_map<std::string, std::unique_ptr<token_node_t>> children;
+        // ids of `contains` rules whose phrase ends on this node
+        std::set<std::string> override_ids;
+    };
+
+    // normalized query => ids of `exact` rules
+    std::unordered_map<std::string, std::set<std::string>> exact_index;
+
+    // token trie of `contains` rule phrases
+    token_node_t contains_root;
+
+    // rule filter_by => ids of rules that only have a `filter_by` condition
+    std::unordered_map<std::string, std::set<std::string>> filter_index;
+
+    // rules with only tags: they can match only via tags (or a wildcard tag)
+    std::set<std::string> wildcard_tag_ids;
+
+    // rules that cannot be indexed and must be evaluated for every query, e.g. dynamic rules
+    // and rules with a dynamic `filter_by` that must always be handed over to the index
+    std::set<std::string> unconditional_ids;
+
+    static bool split_phrase(const std::string& phrase, std::vector<std::string>& tokens);
+
+    static bool remove_phrase(token_node_t* node, const std::vector<std::string>& tokens, size_t index,
+                              const std::string& id);
+
+    void collect_contains(const std::vector<std::string>& tokens, std::set<std::string>& override_ids) const;
+
+    static void collect_all(const token_node_t* node, std::set<std::string>& override_ids);
+
+public:
+
+    static bool is_tags_only(const override_t& override);
+
+    void add(const override_t& override);
+
+    void remove(const override_t& override);
+
+    // Populates ids of all the overrides (in id order) that can possibly match the given query and filter.
+    // Overrides that match only via explicit tags are not included: they are looked up via the tag map.
+    void get_candidates(const std::string& query, const std::string& filter_query,
+                        std::set<std::string>& override_ids) const;
+};
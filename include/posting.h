@@ -37,6 +37,8 @@ struct compact_posting_list_t {
 
     [[nodiscard]] uint32_t num_ids() const;
 
+    [[nodiscard]] size_t memory_used() const;
+
     bool contains_atleast_one(const uint32_t* target_ids, size_t target_ids_size);
 };
 
@@ -84,6 +86,8 @@ public:
 
     static uint32_t num_ids(const void* obj);
 
+    static size_t memory_used(const void* obj);
+
     static uint32_t first_id(const void* obj);
 
     static bool contains(const void* obj, uint32_t id);
@@ -167,6 +167,9 @@ public:
 
     size_t num_ids() const;
 
+    // heap bytes held by the list, including its blocks and their compressed arrays
+    size_t memory_used() const;
+
     uint32_t first_id();
 
     block_t* block_of(uint32_t id);
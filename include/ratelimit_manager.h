@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -142,6 +144,13 @@ struct rate_limit_exceed_t {
 };
 
 
+// Request counters and exceeds of the entities whose counter keys hash to the same shard
+struct request_counter_shard_t {
+    std::mutex mutex;
+    LRU::Cache<std::string, request_counter_t> request_counts;
+    std::unordered_map<std::string, rate_limit_exceed_t> exceeds;
+};
+
 // Hash function for rate_limit_entity_t
 namespace std {
     template <>
@@ -214,7 +223,9 @@ class RateLimitManager
     private:    
 
         RateLimitManager() {
-            rate_limit_request_counts.capacity(10000);
+            for(auto& shard: request_counter_shards) {
+                shard.request_counts.capacity(MAX_REQUEST_COUNTERS / NUM_REQUEST_COUNTER_SHARDS);
+            }
         }
 
         // Store for rate limit rules
@@ -240,13 +251,20 @@ class RateLimitManager
         inline static uint32_t last_ban_id = 0;
 
         // ID of latest added throttle
-        inline static uint32_t last_throttle_id = 0;
+        inline static std::atomic<uint32_t> last_throttle_id{0};
 
         // Store for rate_limit_rule_t
         std::unordered_map<uint64_t,rate_limit_rule_t> rule_store;
 
-        // LRU Cache to store rate limit and request counts for entities
-        LRU::Cache<std::string, request_counter_t> rate_limit_request_counts;
+        static constexpr size_t MAX_REQUEST_COUNTERS = 10000;
+        static constexpr size_t NUM_REQUEST_COUNTER_SHARDS = 16;
+
+        // Request counts and exceeds for entities, sharded on the request counter key so that requests only
+        // need a shared lock on rate_limit_mutex
+        std::array<request_counter_shard_t, NUM_REQUEST_COUNTER_SHARDS> request_counter_shards;
+
+        // Number of rules in rule_store, read without locking to skip rule lookup when there are no rules
+        std::atomic<size_t> num_rules{0};
 
         // Unordered map to point rules from rule store for entities
         std::unordered_map<rate_limit_entity_t, std::vector<rate_limit_rule_t*>> rate_limit_entities;
@@ -254,10 +272,7 @@ class RateLimitManager
         // Unordered map to store banned entities
         std::unordered_map<std::string, rate_limit_status_t> throttled_entities;
 
-        // Hash map to store exceeds
-        std::unordered_map<std::string, rate_limit_exceed_t> rate_limit_exceeds;
-
-        // Mutex to protect access to ip_rate_limits and api_key_rate_limits
+        // Mutex to protect access to rules and throttled entities
         std::shared_mutex rate_limit_mutex;
 
         // Helper function to ban an entity temporarily
@@ -293,8 +308,17 @@ class RateLimitManager
         // Helper function to get request counter key according to rule type
         static const std::string get_request_counter_key(const rate_limit_rule_t& rule, const rate_limit_entity_t& ip_entity, const rate_limit_entity_t& api_key_entity);
 
-        // Fill bucket rule for the given entity
-        void fill_bucket(const rate_limit_entity_t& target_entity, const rate_limit_entity_t& other_entity, std::vector<rate_limit_rule_t*> &rules_bucket);
+        // Pick the rule with the highest priority among the rules of the given entity
+        void fill_bucket(const rate_limit_entity_t& target_entity, const rate_limit_entity_t& other_entity, const rate_limit_rule_t*& top_rule);
+
+        // Get the rule with the highest priority that applies to the given entities
+        const rate_limit_rule_t* get_top_rule(const rate_limit_entity_t& api_key_entity, const rate_limit_entity_t& ip_entity);
+
+        // Get the shard holding the request counter of the given key
+        request_counter_shard_t& get_request_counter_shard(const std::string& request_counter_key);
+
+        // Count the request against the rule, returns true if the request is rate limited
+        bool count_request(const rate_limit_rule_t& rule, const std::string& request_counter_key, bool& auto_ban);
 
         // Singleton instance
         inline static RateLimitManager *instance;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+// Adds the time spent until the end of the scope to the given counter
+struct elapsed_time_timer_t {
+    uint64_t& elapsed_us;
+    const std::chrono::steady_clock::time_point begin;
+
+    explicit elapsed_time_timer_t(uint64_t& elapsed_us): elapsed_us(elapsed_us),
+                                                         begin(std::chrono::steady_clock::now()) {}
+
+    ~elapsed_time_timer_t() {
+        elapsed_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+    }
+};
+
+// Per-operator trace of a single search request, collected only when the request is made with `profile=true`.
+// It is written by the thread that runs the search; work that is forked off to the thread pool is aggregated
+// back into it by that thread.
+struct search_profile_t {
+    // bounds the size of the trace for queries that expand into many typo and prefix candidates
+    static constexpr size_t MAX_TOKEN_CANDIDATES = 100;
+
+    nlohmann::json filter_tree;
+
+    // one entry per query suggestion: its tokens, the ids matching each token per field and the number of matches
+    nlohmann::json token_candidates = nlohmann::json::array();
+    size_t num_dropped_token_candidates = 0;
+
+    // summed across the threads that scored the candidates in parallel
+    uint64_t scoring_time_us = 0;
+
+    // facet field -> time spent counting its values across all the threads
+    std::vector<std::pair<std::string, uint64_t>> facet_times_us;
+
+    void add_token_candidates(nlohmann::json&& candidates);
+
+    nlohmann::json to_json() const;
+};
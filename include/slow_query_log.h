@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// Writes the records of slow searches to a size-rotated file on a background thread, so that searches only pay for
+// queueing a line. When the writer falls behind, new records are dropped instead of blocking the searches.
+class SlowQueryLog {
+private:
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+
+    std::atomic<bool> quit = false;
+
+    std::string log_path;
+    size_t max_file_size_bytes = DEFAULT_MAX_FILE_SIZE_BYTES;
+
+    std::ofstream log_file;
+    size_t log_file_size = 0;
+
+    std::deque<std::string> pending_records;
+    std::atomic<size_t> num_dropped_records = 0;
+
+    SlowQueryLog() {}
+
+    ~SlowQueryLog() {}
+
+    void open_log_file();
+
+    // moves `log_path` to `log_path.1`, `log_path.1` to `log_path.2` and so on, discarding the oldest file
+    void rotate();
+
+    void write_records(std::deque<std::string>& records);
+
+public:
+
+    static constexpr size_t DEFAULT_MAX_FILE_SIZE_BYTES = 64 * 1024 * 1024;
+    static constexpr size_t NUM_ROTATED_FILES = 3;
+    static constexpr size_t MAX_PENDING_RECORDS = 10 * 1000;
+
+    static SlowQueryLog& get_instance() {
+        static SlowQueryLog instance;
+        return instance;
+    }
+
+    SlowQueryLog(SlowQueryLog const&) = delete;
+
+    void operator=(SlowQueryLog const&) = delete;
+
+    // records are accepted only after the log is initialized with a path
+    void init(const std::string& path, size_t max_file_size_bytes = DEFAULT_MAX_FILE_SIZE_BYTES);
+
+    bool is_enabled() const;
+
+    // returns false when the record was dropped
+    bool log(std::string&& record);
+
+    size_t get_num_dropped_records() const;
+
+    void run();
+
+    void stop();
+};
@@ -7,6 +7,7 @@
 #include "option.h"
 #include "tokenizer.h"
 #include "store.h"
+#include "lru/lru.hpp"
 
 struct synonym_t {
     std::string id;
@@ -52,6 +53,15 @@ private:
     spp::sparse_hash_map<std::string, synonym_t> synonym_definitions;
     spp::sparse_hash_map<uint64_t, std::vector<std::string>> synonym_index;
 
+    // number of tokens in the longest indexed phrase: longer token windows can never match
+    size_t max_phrase_len = 0;
+
+    // query tokens => expanded synonyms, cleared whenever synonyms change
+    mutable std::mutex cache_mutex;
+    mutable LRU::Cache<std::string, std::vector<std::vector<std::string>>> synonym_cache;
+
+    void update_max_phrase_len();
+
     void synonym_reduction_internal(const std::vector<std::string>& tokens,
                                     size_t start_window_size,
                                     size_t start_index_pos,
@@ -63,7 +73,9 @@ public:
 
     static constexpr const char* COLLECTION_SYNONYM_PREFIX = "$CY";
 
-    SynonymIndex(Store* store): store(store) { }
+    static constexpr size_t SYNONYM_CACHE_SIZE = 1024;
+
+    SynonymIndex(Store* store): store(store), synonym_cache(SYNONYM_CACHE_SIZE) { }
 
     static std::string get_synonym_key(const std::string & collection_name, const std::string & synonym_id);
 
@@ -4,6 +4,10 @@
 #include <core/session/onnxruntime_cxx_api.h>
 #include <tokenizer/bert_tokenizer.hpp>
 #include <vector>
+#include <deque>
+#include <future>
+#include <thread>
+#include <condition_variable>
 #include "option.h"
 #include "text_embedder_tokenizer.h"
 #include "text_embedder_remote.h"
@@ -38,6 +42,12 @@ class TextEmbedder {
             return tokenizer_->get_tokenizer_type();
         }
     private:
+        // a query waiting to be embedded by the local model's batching scheduler
+        struct pending_embedding_t {
+            std::string text;
+            std::promise<embedding_res_t> result;
+        };
+
         std::shared_ptr<Ort::Session> session_;
         std::shared_ptr<Ort::Env> env_;
         encoded_input_t Encode(const std::string& text);
@@ -46,7 +56,18 @@ class TextEmbedder {
         std::unique_ptr<RemoteEmbedder> remote_embedder_;
         std::string vocab_file_name;
         static std::vector<float> mean_pooling(const std::vector<std::vector<float>>& input, const std::vector<int64_t>& attention_mask);
+        embedding_res_t embed_local(const std::string& text);
+        std::vector<embedding_res_t> batch_embed_local(const std::vector<std::string>& inputs, const size_t batch_size);
+        void run_batch_scheduler();
         std::string output_tensor_name;
         size_t num_dim;
         std::mutex mutex_;
+
+        // Concurrent Embed() calls on a local model are queued and coalesced into a single session run by
+        // `batch_scheduler_`, which waits up to `local-embedding-batch-wait-us` to fill a batch.
+        std::mutex pending_mutex_;
+        std::condition_variable pending_cv_;
+        std::deque<std::shared_ptr<pending_embedding_t>> pending_embeddings_;
+        bool quit_scheduler_ = false;
+        std::thread batch_scheduler_;
 };
@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <functional>
 #include "http_client.h"
 #include "raft_server.h"
 #include "option.h"
@@ -35,6 +36,15 @@ class RemoteEmbedder {
         virtual std::vector<embedding_res_t> batch_embed(const std::vector<std::string>& inputs, const size_t remote_embedding_batch_size = 200,
                                                          const size_t remote_embedding_timeout_ms = 60000, const size_t remote_embedding_num_tries = 2) = 0;
         static const std::string get_model_key(const nlohmann::json& model_config);
+
+        // number of sub-batches of a single batch_embed() call that are sent to the remote API at the same time
+        static constexpr size_t MAX_CONCURRENT_BATCHES = 4;
+
+        // Splits `inputs` into chunks of `batch_size` and runs `embed_batch` on up to `max_concurrent_batches` chunks
+        // in parallel. Results are returned in input order.
+        static std::vector<embedding_res_t> embed_in_batches(const std::vector<std::string>& inputs, size_t batch_size,
+                                                             const std::function<std::vector<embedding_res_t>(const std::vector<std::string>&)>& embed_batch,
+                                                             size_t max_concurrent_batches = MAX_CONCURRENT_BATCHES);
         static void init(ReplicationState* rs) {
             raft_server = rs;
         }
@@ -89,6 +99,8 @@ class GCPEmbedder : public RemoteEmbedder {
     private:
         std::string project_id;
         std::string access_token;
+        // guards `access_token`, which is refreshed by concurrently running sub-batches
+        std::mutex access_token_mutex;
         std::string refresh_token;
         std::string client_id;
         std::string client_secret;
@@ -98,6 +110,8 @@ class GCPEmbedder : public RemoteEmbedder {
         inline static const std::string GCP_EMBEDDING_PREDICT = ":predict";
         inline static const std::string GCP_AUTH_TOKEN_URL = "https://oauth2.googleapis.com/token";
         static Option<std::string> generate_access_token(const std::string& refresh_token, const std::string& client_id, const std::string& client_secret);
+        std::string get_access_token();
+        Option<std::string> refresh_access_token(const std::string& expired_token);
         static std::string get_gcp_embedding_url(const std::string& project_id, const std::string& model_name) {
             return GCP_EMBEDDING_BASE_URL + project_id + GCP_EMBEDDING_PATH + model_name + GCP_EMBEDDING_PREDICT;
         }
@@ -1,4 +1,7 @@
+#pragma once
+
 #include <chrono>
+#include <cstdint>
 
 extern thread_local int64_t write_log_index;
 
@@ -6,4 +9,55 @@ extern thread_local int64_t write_log_index;
 // NOTE: if you fork off main search thread, care must be taken to initialize these from parent thread values
 extern thread_local uint64_t search_begin_us;
 extern thread_local uint64_t search_stop_us;
-extern thread_local bool search_cutoff;
\ No newline at end of file
+extern thread_local bool search_cutoff;
+
+struct search_profile_t;
+
+// Trace of the search request running on this thread, or nullptr when it was not asked for
+extern thread_local search_profile_t* search_profile;
+
+enum search_stage_t {
+    SEARCH_STAGE_PARSE,
+    SEARCH_STAGE_EMBED,
+    SEARCH_STAGE_FILTER,
+    SEARCH_STAGE_TOKEN_SEARCH,
+    SEARCH_STAGE_GROUPING,
+    SEARCH_STAGE_FACETS,
+    SEARCH_STAGE_HIT_FETCH,
+    SEARCH_STAGE_HIGHLIGHT,
+    SEARCH_STAGE_SERIALIZATION,
+    NUM_SEARCH_STAGES
+};
+
+// Time spent in each stage by the search request running on this thread (in microseconds)
+extern thread_local uint64_t search_stage_us[NUM_SEARCH_STAGES];
+
+// Stages entered by the search request running on this thread, as `1 << stage` bits
+extern thread_local uint32_t search_stages_entered;
+
+// Documents matched by the filters and text match candidates scored by the search request running on this thread
+extern thread_local uint64_t search_num_filter_ids;
+extern thread_local uint64_t search_num_scored_candidates;
+
+// Adds the time spent until `stop()` or the end of the scope to the given stage of the current search
+struct search_stage_timer_t {
+    const search_stage_t stage;
+    const std::chrono::steady_clock::time_point begin;
+    bool stopped = false;
+
+    explicit search_stage_timer_t(search_stage_t stage): stage(stage), begin(std::chrono::steady_clock::now()) {
+        search_stages_entered |= (1U << stage);
+    }
+
+    void stop() {
+        if(!stopped) {
+            search_stage_us[stage] += std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - begin).count();
+            stopped = true;
+        }
+    }
+
+    ~search_stage_timer_t() {
+        stop();
+    }
+};
@@ -80,6 +80,14 @@ private:
 
     bool enable_search_logging;
 
+    std::atomic<uint32_t> local_embedding_max_batch_size;
+
+    std::atomic<uint32_t> local_embedding_batch_wait_us;
+
+    std::atomic<uint32_t> num_search_partitions;
+
+    std::atomic<int> slow_query_log_time_ms;
+
 protected:
 
     Config() {
@@ -113,6 +121,13 @@ protected:
         this->enable_lazy_filter = false;
 
         this->enable_search_logging = false;
+
+        this->local_embedding_max_batch_size = 8;
+        this->local_embedding_batch_wait_us = 2000;
+
+        this->num_search_partitions = 4;
+
+        this->slow_query_log_time_ms = -1;
     }
 
     Config(Config const&) {
@@ -183,6 +198,10 @@ public:
         this->log_slow_searches_time_ms = log_slow_searches_time_ms;
     }
 
+    void set_slow_query_log_time_ms(int slow_query_log_time_ms) {
+        this->slow_query_log_time_ms = slow_query_log_time_ms;
+    }
+
     void set_healthy_read_lag(size_t healthy_read_lag) {
         this->healthy_read_lag = healthy_read_lag;
     }
@@ -354,6 +373,18 @@ public:
         return this->enable_search_logging;
     }
 
+    size_t get_local_embedding_max_batch_size() const {
+        return this->local_embedding_max_batch_size;
+    }
+
+    size_t get_local_embedding_batch_wait_us() const {
+        return this->local_embedding_batch_wait_us;
+    }
+
+    size_t get_num_search_partitions() const {
+        return this->num_search_partitions;
+    }
+
     int get_disk_used_max_percentage() const {
         return this->disk_used_max_percentage;
     }
@@ -370,6 +401,18 @@ public:
         return this->log_dir + "/typesense-access.log";
     }
 
+    int get_slow_query_log_time_ms() const {
+        return this->slow_query_log_time_ms;
+    }
+
+    std::string get_slow_query_log_path() const {
+        if(this->log_dir.empty()) {
+            return "";
+        }
+
+        return this->log_dir + "/typesense-slow-queries.log";
+    }
+
     bool get_enable_lazy_filter() const {
         return enable_lazy_filter;
     }
@@ -409,6 +452,18 @@ public:
         this->enable_search_logging = enable_search_logging;
     }
 
+    void set_local_embedding_max_batch_size(uint32_t max_batch_size) {
+        this->local_embedding_max_batch_size = max_batch_size;
+    }
+
+    void set_local_embedding_batch_wait_us(uint32_t batch_wait_us) {
+        this->local_embedding_batch_wait_us = batch_wait_us;
+    }
+
+    void set_num_search_partitions(uint32_t num_partitions) {
+        this->num_search_partitions = num_partitions;
+    }
+
     // validation
 
     Option<bool> is_valid() {
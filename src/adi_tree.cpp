@@ -1,6 +1,7 @@
 #include <cstdint>
 #include <vector>
 #include "adi_tree.h"
+#include "memory_usage.h"
 #include "logger.h"
 
 struct adi_node_t {
@@ -282,3 +283,21 @@ adi_tree_t::~adi_tree_t() {
 const adi_node_t* adi_tree_t::get_root() {
     return root;
 }
+
+static size_t node_memory_used(const adi_node_t* node) {
+    size_t bytes = sizeof(adi_node_t) + node->num_children * (sizeof(char) + sizeof(adi_node_t*));
+    for(size_t i = 0; i < node->num_children; i++) {
+        bytes += node_memory_used(node->children[i]);
+    }
+
+    return bytes;
+}
+
+size_t adi_tree_t::memory_used() const {
+    size_t bytes = sizeof(adi_tree_t) + sparse_hash_map_memory_used(id_keys) + node_memory_used(root);
+    for(const auto& id_key: id_keys) {
+        bytes += string_memory_used(id_key.second);
+    }
+
+    return bytes;
+}
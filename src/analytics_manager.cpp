@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <mutex>
 #include <thread>
 #include "analytics_manager.h"
@@ -189,6 +190,8 @@ Option<bool> AnalyticsManager::create_index(nlohmann::json &payload, bool upsert
         query_collection_mapping[query_coll].push_back(suggestion_collection);
     }
 
+    num_query_collections = query_collection_mapping.size();
+
     if(payload["type"] == POPULAR_QUERIES_TYPE) {
         QueryAnalytics* popularQueries = new QueryAnalytics(limit);
         popularQueries->set_expand_query(suggestion_config.expand_query);
@@ -322,6 +325,8 @@ Option<bool> AnalyticsManager::remove_index(const std::string &name) {
         query_collection_mapping.erase(query_collection);
     }
 
+    num_query_collections = query_collection_mapping.size();
+
     if(popular_queries.count(suggestion_collection) != 0) {
         delete popular_queries[suggestion_collection];
         popular_queries.erase(suggestion_collection);
@@ -354,19 +359,109 @@ Option<bool> AnalyticsManager::remove_index(const std::string &name) {
 void AnalyticsManager::add_suggestion(const std::string &query_collection,
                                       const std::string& query, const std::string& expanded_query,
                                       const bool live_query, const std::string& user_id) {
-    // look up suggestion collections for the query collection
-    std::unique_lock lock(mutex);
-    const auto& suggestion_collections_it = query_collection_mapping.find(query_collection);
-    if(suggestion_collections_it != query_collection_mapping.end()) {
+    buffer_query(query_collection, query, expanded_query, live_query, user_id, false);
+}
+
+void AnalyticsManager::buffer_query(const std::string& query_collection, const std::string& query,
+                                    const std::string& expanded_query, bool live_query,
+                                    const std::string& user_id, bool nohits) {
+    if(num_query_collections == 0) {
+        return ;
+    }
+
+    uint64_t now_ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto& buffer = query_buffers[std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_QUERY_BUFFERS];
+    std::vector<buffered_query_t> full_queries;
+
+    {
+        std::unique_lock lock(buffer.mutex);
+        buffer.queries.push_back(buffered_query_t{query_collection, query, expanded_query, user_id, now_ts_us,
+                                                  live_query, nohits});
+
+        if(buffer.queries.size() < MAX_BUFFERED_QUERIES) {
+            return ;
+        }
+
+        full_queries.swap(buffer.queries);
+    }
+
+    // wake up run() to merge the full buffer instead of waiting for the merge interval
+    {
+        std::unique_lock lock(full_query_buffers_mutex);
+        full_query_buffers.push_back(std::move(full_queries));
+    }
+
+    has_full_query_buffers = true;
+    cv.notify_all();
+}
+
+void AnalyticsManager::merge_query_buffers() {
+    // lock is held by caller
+    std::vector<buffered_query_t> queries;
+
+    {
+        std::unique_lock lock(full_query_buffers_mutex);
+        for(auto& full_queries: full_query_buffers) {
+            queries.insert(queries.end(), std::make_move_iterator(full_queries.begin()),
+                           std::make_move_iterator(full_queries.end()));
+        }
+
+        full_query_buffers.clear();
+        has_full_query_buffers = false;
+    }
+
+    for(auto& buffer: query_buffers) {
+        std::unique_lock lock(buffer.mutex);
+        queries.insert(queries.end(), std::make_move_iterator(buffer.queries.begin()),
+                       std::make_move_iterator(buffer.queries.end()));
+        buffer.queries.clear();
+    }
+
+    // a user's queries can be spread across the buffers of several threads, while the prefix compaction of
+    // live queries depends on their order
+    std::stable_sort(queries.begin(), queries.end(), [](const buffered_query_t& a, const buffered_query_t& b) {
+        return a.timestamp_us < b.timestamp_us;
+    });
+
+    for(const auto& q: queries) {
+        // look up suggestion collections for the query collection
+        const auto& suggestion_collections_it = query_collection_mapping.find(q.query_collection);
+        if(suggestion_collections_it == query_collection_mapping.end()) {
+            continue;
+        }
+
+        auto& query_analytics = q.nohits ? nohits_queries : popular_queries;
+
         for(const auto& suggestion_collection: suggestion_collections_it->second) {
-            const auto& popular_queries_it = popular_queries.find(suggestion_collection);
-            if(popular_queries_it != popular_queries.end()) {
-                popular_queries_it->second->add(query, expanded_query, live_query, user_id);
+            const auto& query_analytics_it = query_analytics.find(suggestion_collection);
+            if(query_analytics_it != query_analytics.end()) {
+                query_analytics_it->second->add(q.query, q.expanded_query,
+                                                q.live_query, q.user_id, q.timestamp_us);
             }
         }
     }
 }
 
+void AnalyticsManager::get_query_buffer_stats(nlohmann::json& result) {
+    size_t num_buffered_queries = 0;
+
+    for(auto& buffer: query_buffers) {
+        std::unique_lock lock(buffer.mutex);
+        num_buffered_queries += buffer.queries.size();
+    }
+
+    {
+        std::unique_lock lock(full_query_buffers_mutex);
+        for(const auto& full_queries: full_query_buffers) {
+            num_buffered_queries += full_queries.size();
+        }
+    }
+
+    result["analytics_buffered_queries"] = num_buffered_queries;
+}
+
 Option<bool> AnalyticsManager::add_event(const std::string& client_ip, const std::string& event_type,
                                          const std::string& event_name, const nlohmann::json& event_json) {
     std::unique_lock lock(mutex);
@@ -465,17 +560,7 @@ Option<bool> AnalyticsManager::add_event(const std::string& client_ip, const std
 
 void AnalyticsManager::add_nohits_query(const std::string &query_collection, const std::string &query,
                                         bool live_query, const std::string &user_id) {
-    // look up suggestion collections for the query collection
-    std::unique_lock lock(mutex);
-    const auto& suggestion_collections_it = query_collection_mapping.find(query_collection);
-    if(suggestion_collections_it != query_collection_mapping.end()) {
-        for(const auto& suggestion_collection: suggestion_collections_it->second) {
-            const auto& noresults_queries_it = nohits_queries.find(suggestion_collection);
-            if(noresults_queries_it != nohits_queries.end()) {
-                noresults_queries_it->second->add(query, query, live_query, user_id);
-            }
-        }
-    }
+    buffer_query(query_collection, query, query, live_query, user_id, true);
 }
 
 void AnalyticsManager::run(ReplicationState* raft_server) {
@@ -484,7 +569,9 @@ void AnalyticsManager::run(ReplicationState* raft_server) {
 
     while(!quit) {
         std::unique_lock lk(mutex);
-        cv.wait_for(lk, std::chrono::seconds(QUERY_COMPACTION_INTERVAL_S), [&] { return quit.load(); });
+        cv.wait_for(lk, std::chrono::seconds(QUERY_BUFFER_MERGE_INTERVAL_S), [&] {
+            return quit.load() || has_full_query_buffers.load();
+        });
 
         //LOG(INFO) << "QuerySuggestions::run";
 
@@ -493,6 +580,8 @@ void AnalyticsManager::run(ReplicationState* raft_server) {
             break;
         }
 
+        merge_query_buffers();
+
         auto now_ts_seconds = std::chrono::duration_cast<std::chrono::seconds>(
                 std::chrono::system_clock::now().time_since_epoch()).count();
 
@@ -678,6 +767,7 @@ void AnalyticsManager::dispose() {
     suggestion_configs.clear();
 
     query_collection_mapping.clear();
+    num_query_collections = 0;
 
     counter_events.clear();
 
@@ -700,11 +790,13 @@ void AnalyticsManager::init(Store* store, const std::string& analytics_dir) {
 
 std::unordered_map<std::string, QueryAnalytics*> AnalyticsManager::get_popular_queries() {
     std::unique_lock lk(mutex);
+    merge_query_buffers();
     return popular_queries;
 }
 
 std::unordered_map<std::string, QueryAnalytics*> AnalyticsManager::get_nohits_queries() {
     std::unique_lock lk(mutex);
+    merge_query_buffers();
     return nohits_queries;
 }
 
@@ -1,5 +1,6 @@
 #include "app_metrics.h"
 #include "core_api.h"
+#include <cmath>
 
 void AppMetrics::increment_write_metrics(uint64_t route_hash, uint64_t duration) {
     if(is_doc_import_route(route_hash)) {
@@ -130,3 +131,124 @@ void AppMetrics::flush_access_log() {
         access_log << std::flush;
     }
 }
+
+size_t latency_histogram_t::bucket_index(uint64_t duration_us) {
+    // buckets are inclusive of their upper bound, so that powers of two are bucket boundaries
+    const uint64_t value = (duration_us == 0) ? 0 : duration_us - 1;
+    if(value < SUB_BUCKETS) {
+        return value;
+    }
+
+    const size_t exponent = 63 - __builtin_clzll(value);
+    if(exponent > MAX_EXPONENT) {
+        return NUM_BUCKETS - 1;
+    }
+
+    const size_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t latency_histogram_t::upper_bound(size_t index) {
+    if(index < SUB_BUCKETS) {
+        return index + 1;
+    }
+
+    const size_t exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    const size_t sub_bucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return uint64_t(SUB_BUCKETS + sub_bucket + 1) << (exponent - SUB_BUCKET_BITS);
+}
+
+void latency_histogram_t::record(uint64_t duration_us) {
+    buckets[bucket_index(duration_us)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(duration_us, std::memory_order_relaxed);
+}
+
+uint64_t latency_histogram_t::count_at_most(uint64_t duration_us) const {
+    const size_t last_index = bucket_index(duration_us);
+    uint64_t total = 0;
+
+    for(size_t i = 0; i <= last_index; i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+uint64_t latency_histogram_t::percentile(double p) const {
+    const uint64_t total = get_count();
+    if(total == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(total * p / 100)));
+    uint64_t seen = 0;
+
+    for(size_t i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if(seen >= rank) {
+            return upper_bound(i);
+        }
+    }
+
+    return upper_bound(NUM_BUCKETS - 1);
+}
+
+void AppMetrics::record_search(uint64_t duration_us) {
+    for(size_t stage = 0; stage < NUM_SEARCH_STAGES; stage++) {
+        // a stage that the search skipped would otherwise drag its percentiles down with 0us samples
+        if(stage != SEARCH_STAGE_SERIALIZATION && (search_stages_entered & (1U << stage)) != 0) {
+            search_stage_latencies[stage].record(search_stage_us[stage]);
+        }
+    }
+
+    search_latency.record(duration_us);
+}
+
+void AppMetrics::append_prometheus_histogram(const std::string& name, const std::string& stage,
+                                             const latency_histogram_t& histogram, std::string& out) {
+    // powers of two from 64us to ~16.8s are bucket boundaries, so the cumulative counts are exact
+    static constexpr size_t MIN_BOUND_EXPONENT = 6;
+    static constexpr size_t MAX_BOUND_EXPONENT = 24;
+
+    const std::string labels = stage.empty() ? "" : "stage=\"" + stage + "\",";
+    char le[32];
+
+    for(size_t exponent = MIN_BOUND_EXPONENT; exponent <= MAX_BOUND_EXPONENT; exponent++) {
+        const uint64_t bound_us = uint64_t(1) << exponent;
+        snprintf(le, sizeof(le), "%g", bound_us / 1000000.0);
+        out += name + "_bucket{" + labels + "le=\"" + le + "\"} " +
+               std::to_string(histogram.count_at_most(bound_us)) + "\n";
+    }
+
+    const uint64_t count = histogram.get_count();
+    snprintf(le, sizeof(le), "%g", histogram.get_sum_us() / 1000000.0);
+
+    out += name + "_bucket{" + labels + "le=\"+Inf\"} " + std::to_string(count) + "\n";
+    out += name + "_sum" + (stage.empty() ? "" : "{stage=\"" + stage + "\"}") + " " + le + "\n";
+    out += name + "_count" + (stage.empty() ? "" : "{stage=\"" + stage + "\"}") + " " + std::to_string(count) + "\n";
+}
+
+std::string AppMetrics::get_prometheus_metrics() const {
+    std::string out;
+
+    out += "# HELP typesense_search_duration_seconds Time taken by search requests.\n";
+    out += "# TYPE typesense_search_duration_seconds histogram\n";
+    append_prometheus_histogram("typesense_search_duration_seconds", "", search_latency, out);
+
+    out += "# HELP typesense_search_stage_duration_seconds Time taken by each stage of search requests.\n";
+    out += "# TYPE typesense_search_stage_duration_seconds histogram\n";
+    for(size_t stage = 0; stage < NUM_SEARCH_STAGES; stage++) {
+        append_prometheus_histogram("typesense_search_stage_duration_seconds", SEARCH_STAGE_NAMES[stage],
+                                    search_stage_latencies[stage], out);
+    }
+
+    out += "# HELP typesense_write_stage_duration_seconds Time taken by each stage of indexing a write batch.\n";
+    out += "# TYPE typesense_write_stage_duration_seconds histogram\n";
+    for(size_t stage = 0; stage < NUM_WRITE_STAGES; stage++) {
+        append_prometheus_histogram("typesense_write_stage_duration_seconds", WRITE_STAGE_NAMES[stage],
+                                    write_stage_latencies[stage], out);
+    }
+
+    return out;
+}
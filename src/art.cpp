@@ -17,12 +17,14 @@
 #include <limits>
 #include <queue>
 #include <list>
+#include <unordered_map>
 #include <stdint.h>
 #include <posting.h>
 #include <or_iterator.h>
 #include "art.h"
 #include "logger.h"
 #include "array_utils.h"
+#include "memory_usage.h"
 #include "filter_result_iterator.h"
 
 /**
@@ -44,8 +46,42 @@
 
 enum recurse_progress { RECURSE, ABORT, ITERATE };
 
+/*
+ * Levenshtein cost rows of the path being traversed, indexed by the number of key characters consumed (offset by 1,
+ * since row 0 is also used as the row that precedes it). Every row on the path is computed exactly once and siblings
+ * simply overwrite the rows below their parent, so rows never have to be copied during the traversal.
+ *
+ * Costs are clipped to `cap`: the traversal only compares costs against `max_cost` and against the small constants
+ * in `fuzzy_search_state`, all of which are below `cap`. Since a cell can never be cheaper than its distance to the
+ * diagonal, only the band of cells within `cap` of the diagonal has to be computed: every other cell stays at `cap`.
+ */
+struct fuzzy_rows_t {
+    const int columns;
+    const int cap;
+    std::vector<int> cells;
+
+    fuzzy_rows_t(const int term_len, const int max_cost): columns(term_len + 1), cap(std::max(max_cost, 4) + 1) {
+        reserve(term_len + max_cost + 2);
+        for(int r = 0; r < 2; r++) {
+            for(int column = 0; column < columns; column++) {
+                cells[r * columns + column] = std::min(column, cap);
+            }
+        }
+    }
+
+    void reserve(const int num_rows) {
+        if(size_t(num_rows * columns) > cells.size()) {
+            cells.resize(num_rows * columns, cap);
+        }
+    }
+
+    int* row(const int row_index) {
+        return &cells[row_index * columns];
+    }
+};
+
 static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *n, int depth, const unsigned char *term,
-                              const int term_len, const int* irow, const int* jrow, const int min_cost,
+                              const int term_len, fuzzy_rows_t& rows, int row_index, const int min_cost,
                               const int max_cost, const bool prefix, std::vector<const art_node *> &results);
 
 void art_int_fuzzy_recurse(art_node *n, int depth, const unsigned char* int_str, int int_str_len,
@@ -137,6 +173,8 @@ static art_node* alloc_node(uint8_t type) {
 int art_tree_init(art_tree *t) {
     t->root = NULL;
     t->size = 0;
+    t->version = 0;
+    t->prefix_topk = nullptr;
     return 0;
 }
 
@@ -205,6 +243,8 @@ static void destroy_node(art_node *n) {
  */
 int art_tree_destroy(art_tree *t) {
     destroy_node(t->root);
+    delete t->prefix_topk;
+    t->prefix_topk = nullptr;
     return 0;
 }
 
@@ -727,6 +767,194 @@ static void* recursive_insert(art_node* n, art_node** ref, const unsigned char*
     return NULL;
 }
 
+/*
+ * Keeps the leaves with the highest max_score for every key prefix of up to PREFIX_LEN bytes, so that short prefix
+ * queries (e.g. `q=a` during autocomplete) don't have to walk the large subtrees below the upper nodes of the tree.
+ *
+ * Every list holds the top leaves of its prefix in descending order of score. When a list is not `complete`, the
+ * prefix has more leaves than the list holds, but none of them scores higher than the last leaf of the list.
+ * The lists are keyed by prefix rather than attached to nodes, since nodes are reallocated as they grow and shrink.
+ */
+struct art_prefix_topk {
+    static constexpr size_t PREFIX_LEN = 2;
+    static constexpr size_t K = 32;
+
+    struct list_t {
+        std::vector<art_leaf*> leaves;
+        bool complete = true;
+    };
+
+    std::unordered_map<std::string, list_t> lists;
+};
+
+static void topk_add_leaf(art_prefix_topk::list_t& list, art_leaf* leaf) {
+    auto it = std::find(list.leaves.begin(), list.leaves.end(), leaf);
+
+    if(it == list.leaves.end()) {
+        if(!list.complete && (list.leaves.empty() || leaf->max_score < list.leaves.back()->max_score)) {
+            // might rank below one of the leaves that are not in the list
+            return ;
+        }
+
+        list.leaves.push_back(leaf);
+        it = list.leaves.end() - 1;
+    }
+
+    // score of a leaf only grows, so it can only move towards the front
+    while(it != list.leaves.begin() && (*(it - 1))->max_score < (*it)->max_score) {
+        std::iter_swap(it - 1, it);
+        it--;
+    }
+
+    if(list.leaves.size() > art_prefix_topk::K) {
+        list.leaves.pop_back();
+        list.complete = false;
+    }
+}
+
+static void topk_collect(const art_node* n, std::vector<art_leaf*>& heap) {
+    if(!n) {
+        return ;
+    }
+
+    if(IS_LEAF(n)) {
+        // min-heap on score, bounded to K+1 leaves so that overflow can be detected
+        heap.push_back((art_leaf *) LEAF_RAW(n));
+        std::push_heap(heap.begin(), heap.end(), compare_art_leaf_score);
+        if(heap.size() > art_prefix_topk::K + 1) {
+            std::pop_heap(heap.begin(), heap.end(), compare_art_leaf_score);
+            heap.pop_back();
+        }
+        return ;
+    }
+
+    int idx;
+    switch (n->type) {
+        case NODE4:
+            for (int i=0; i < n->num_children; i++) {
+                topk_collect(((art_node4*)n)->children[i], heap);
+            }
+            break;
+
+        case NODE16:
+            for (int i=0; i < n->num_children; i++) {
+                topk_collect(((art_node16*)n)->children[i], heap);
+            }
+            break;
+
+        case NODE48:
+            for (int i=0; i < 256; i++) {
+                idx = ((art_node48*)n)->keys[i];
+                if (!idx) continue;
+                topk_collect(((art_node48*)n)->children[idx-1], heap);
+            }
+            break;
+
+        case NODE256:
+            for (int i=0; i < 256; i++) {
+                topk_collect(((art_node256*)n)->children[i], heap);
+            }
+            break;
+
+        default:
+            abort();
+    }
+}
+
+// Returns the node (or tagged leaf) whose subtree holds exactly the keys that begin with the given short prefix
+static const art_node* find_prefix_node(const art_tree* t, const unsigned char* prefix, int prefix_len) {
+    const art_node* n = t->root;
+    int depth = 0;
+
+    while(n) {
+        if(IS_LEAF(n)) {
+            art_leaf* l = (art_leaf *) LEAF_RAW(n);
+            if(l->key_len < (uint32_t) prefix_len || memcmp(l->key, prefix, prefix_len) != 0) {
+                return nullptr;
+            }
+            return n;
+        }
+
+        int num_partial = min(min(MAX_PREFIX_LEN, n->partial_len), prefix_len - depth);
+        if(memcmp(n->partial, prefix + depth, num_partial) != 0) {
+            return nullptr;
+        }
+
+        if(depth + n->partial_len >= prefix_len) {
+            return n;
+        }
+
+        depth += n->partial_len;
+        art_node** child = find_child((art_node *) n, prefix[depth]);
+        n = child ? *child : nullptr;
+        depth++;
+    }
+
+    return nullptr;
+}
+
+static void topk_on_insert(art_tree* t, const unsigned char* key, int key_len) {
+    art_leaf* leaf = (art_leaf *) art_search(t, key, key_len);
+    if(leaf == nullptr) {
+        return ;
+    }
+
+    if(t->prefix_topk == nullptr) {
+        t->prefix_topk = new art_prefix_topk();
+    }
+
+    // key_len includes the terminating \0
+    const int max_prefix_len = min(art_prefix_topk::PREFIX_LEN, key_len - 1);
+    for(int prefix_len = 1; prefix_len <= max_prefix_len; prefix_len++) {
+        std::string prefix((const char*) key, prefix_len);
+        topk_add_leaf(t->prefix_topk->lists[prefix], leaf);
+    }
+}
+
+static void topk_on_delete(art_tree* t, const art_leaf* leaf) {
+    if(t->prefix_topk == nullptr) {
+        return ;
+    }
+
+    const int max_prefix_len = min(art_prefix_topk::PREFIX_LEN, leaf->key_len - 1);
+    for(int prefix_len = 1; prefix_len <= max_prefix_len; prefix_len++) {
+        std::string prefix((const char*) leaf->key, prefix_len);
+        auto list_it = t->prefix_topk->lists.find(prefix);
+        if(list_it == t->prefix_topk->lists.end()) {
+            continue;
+        }
+
+        auto& list = list_it->second;
+        auto it = std::find(list.leaves.begin(), list.leaves.end(), leaf);
+        if(it == list.leaves.end()) {
+            continue;
+        }
+
+        list.leaves.erase(it);
+
+        if(list.complete) {
+            if(list.leaves.empty()) {
+                t->prefix_topk->lists.erase(list_it);
+            }
+            continue;
+        }
+
+        if(list.leaves.size() < art_prefix_topk::K / 2) {
+            // refill from the subtree: this has to happen only after K/2 of the top leaves have been deleted
+            std::vector<art_leaf*> heap;
+            topk_collect(find_prefix_node(t, leaf->key, prefix_len), heap);
+            std::sort(heap.begin(), heap.end(), compare_art_leaf_score);
+
+            list.complete = (heap.size() <= art_prefix_topk::K);
+            if(!list.complete) {
+                heap.pop_back();
+            }
+
+            list.leaves = std::move(heap);
+        }
+    }
+}
+
 /**
  * Inserts a new value into the ART tree
  * @arg t The tree
@@ -748,7 +976,12 @@ void* art_inserts(art_tree *t, const unsigned char *key, int key_len, const int6
     std::list<art_node*> path;
     bool frequency_based_ordering = (docs_max_score == USE_FREQUENCY_SCORE);
     void *old = recursive_insert(t->root, &t->root, key, key_len, docs_max_score, documents, 0, path, &old_val);
-    if (!old_val) t->size++;
+    if (!old_val) {
+        t->size++;
+        t->version++;
+    }
+
+    topk_on_insert(t, key, key_len);
 
     if(frequency_based_ordering) {
         for(art_node* n: path) {
@@ -927,6 +1160,8 @@ void* art_delete(art_tree *t, const unsigned char *key, int key_len) {
     art_leaf *l = recursive_delete(t->root, &t->root, key, key_len, 0);
     if (l) {
         t->size--;
+        t->version++;
+        topk_on_delete(t, l);
         void *old = l->values;
         free(l);
         return old;
@@ -1304,6 +1539,66 @@ int art_iter(art_tree *t, art_callback cb, void *data) {
     return recursive_iter(t->root, cb, data);
 }
 
+static void recursive_memory_used(const art_node *n, uint64_t* node_bytes, uint64_t* posting_bytes) {
+    if (!n) return;
+    if (IS_LEAF(n)) {
+        const art_leaf *l = (const art_leaf *) LEAF_RAW(n);
+        *node_bytes += sizeof(art_leaf) + l->key_len;
+        *posting_bytes += posting_t::memory_used(l->values);
+        return;
+    }
+
+    switch (n->type) {
+        case NODE4:
+            *node_bytes += sizeof(art_node4);
+            for (int i=0; i < n->num_children; i++) {
+                recursive_memory_used(((const art_node4*)n)->children[i], node_bytes, posting_bytes);
+            }
+            break;
+
+        case NODE16:
+            *node_bytes += sizeof(art_node16);
+            for (int i=0; i < n->num_children; i++) {
+                recursive_memory_used(((const art_node16*)n)->children[i], node_bytes, posting_bytes);
+            }
+            break;
+
+        case NODE48:
+            *node_bytes += sizeof(art_node48);
+            for (int i=0; i < 256; i++) {
+                int idx = ((const art_node48*)n)->keys[i];
+                if (!idx) continue;
+                recursive_memory_used(((const art_node48*)n)->children[idx-1], node_bytes, posting_bytes);
+            }
+            break;
+
+        case NODE256:
+            *node_bytes += sizeof(art_node256);
+            for (int i=0; i < 256; i++) {
+                recursive_memory_used(((const art_node256*)n)->children[i], node_bytes, posting_bytes);
+            }
+            break;
+
+        default:
+            abort();
+    }
+}
+
+void art_memory_used(const art_tree *t, uint64_t* node_bytes, uint64_t* posting_bytes) {
+    *node_bytes = sizeof(art_tree);
+    *posting_bytes = 0;
+
+    recursive_memory_used(t->root, node_bytes, posting_bytes);
+
+    if(t->prefix_topk != nullptr) {
+        *node_bytes += sizeof(art_prefix_topk) + hash_map_memory_used(t->prefix_topk->lists);
+        for(const auto& prefix_list: t->prefix_topk->lists) {
+            *node_bytes += string_memory_used(prefix_list.first) +
+                           prefix_list.second.leaves.capacity() * sizeof(art_leaf*);
+        }
+    }
+}
+
 /**
  * Checks if a leaf prefix matches
  * @return 0 on success.
@@ -1403,21 +1698,28 @@ void print_row(const int* row, const int row_len) {
     printf("\n");
 }
 
-static inline void copyIntArray2(const int *src, int *dest, const int len) {
-    for(int t=0; t<len; t++) {
-        dest[t] = src[t];
-    }
-}
-
+// Computes the cost row for key char `c` on top of the row at `row_index`, and then moves `row_index` to it
 static inline void levenshtein_dist(const int depth, const unsigned char p, const unsigned char c,
                                     const unsigned char* term, const int term_len,
-                                    const int* irow, const int* jrow, int* krow) {
-    krow[0] = jrow[0] + 1;
+                                    fuzzy_rows_t& rows, int& row_index) {
+    rows.reserve(row_index + 2);
+
+    const int* irow = rows.row(row_index - 1);
+    const int* jrow = rows.row(row_index);
+    int* krow = rows.row(row_index + 1);
+
+    const int cap = rows.cap;
+    const int key_len = row_index;  // number of key chars consumed once `c` is included
+
+    krow[0] = std::min(jrow[0] + 1, cap);
 
     // Calculate levenshtein distance incrementally (term => b, column => j, c => a[i], p => a[i-1], irow => d[i-1]):
     // https://en.wikipedia.org/wiki/Damerau%E2%80%93Levenshtein_distance#Optimal_string_alignment_distance
 
-    for(int column=1; column<=term_len; column++) {
+    const int start_column = std::max(1, key_len - cap + 1);
+    const int end_column = std::min(term_len, key_len + cap - 1);
+
+    for(int column=start_column; column<=end_column; column++) {
         int cost = (c == term[column-1]) ? 0 : 1;  // column-1 used because of zero-based char array
 
         int delete_cost = jrow[column] + 1;
@@ -1429,11 +1731,15 @@ static inline void levenshtein_dist(const int depth, const unsigned char p, cons
         if(depth > 1 && column > 1 && c == term[column-1-1] && p == term[column-1]) {
             krow[column] = std::min(krow[column], irow[column-2] + 1);
         }
+
+        krow[column] = std::min(krow[column], cap);
     }
+
+    row_index++;
 }
 
 static inline void art_fuzzy_children(unsigned char p, const art_node *n, int depth, const unsigned char *term, const int term_len,
-                                      const int* irow, const int* jrow, const int min_cost, const int max_cost,
+                                      fuzzy_rows_t& rows, const int row_index, const int min_cost, const int max_cost,
                                       const bool prefix, std::vector<const art_node *> &results) {
     char child_char;
     art_node* child;
@@ -1445,7 +1751,7 @@ static inline void art_fuzzy_children(unsigned char p, const art_node *n, int de
                 child_char = ((art_node4*)n)->keys[i];
                 printf("4!child_char: %c, %d, depth: %d\n", child_char, child_char, depth);
                 child = ((art_node4*)n)->children[i];
-                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, irow, jrow, min_cost, max_cost, prefix, results);
+                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, rows, row_index, min_cost, max_cost, prefix, results);
             }
             break;
         case NODE16:
@@ -1454,7 +1760,7 @@ static inline void art_fuzzy_children(unsigned char p, const art_node *n, int de
                 child_char = ((art_node16*)n)->keys[i];
                 printf("16!child_char: %c, depth: %d\n", child_char, depth);
                 child = ((art_node16*)n)->children[i];
-                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, irow, jrow, min_cost, max_cost, prefix, results);
+                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, rows, row_index, min_cost, max_cost, prefix, results);
             }
             break;
         case NODE48:
@@ -1465,7 +1771,7 @@ static inline void art_fuzzy_children(unsigned char p, const art_node *n, int de
                 child = ((art_node48*)n)->children[ix - 1];
                 child_char = (char)i;
                 printf("48!child_char: %c, depth: %d, ix: %d\n", child_char, depth, ix);
-                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, irow, jrow, min_cost, max_cost, prefix, results);
+                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, rows, row_index, min_cost, max_cost, prefix, results);
             }
             break;
         case NODE256:
@@ -1475,7 +1781,7 @@ static inline void art_fuzzy_children(unsigned char p, const art_node *n, int de
                 child_char = (char) i;
                 printf("256!child_char: %c, depth: %d\n", child_char, depth);
                 child = ((art_node256*)n)->children[i];
-                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, irow, jrow, min_cost, max_cost, prefix, results);
+                art_fuzzy_recurse(p, child_char, child, depth, term, term_len, rows, row_index, min_cost, max_cost, prefix, results);
             }
             break;
         default:
@@ -1483,13 +1789,6 @@ static inline void art_fuzzy_children(unsigned char p, const art_node *n, int de
     }
 }
 
-static inline void rotate(int &i, int &j, int &k) {
-    int old_i = i;
-    i = j;
-    j = k;
-    k = old_i;
-}
-
 // -1: return without adding, 0 : continue iteration, 1: return after adding
 static inline int fuzzy_search_state(const bool prefix, int key_index, unsigned char p, unsigned char c,
                                      const unsigned char* query, const int query_len,
@@ -1595,21 +1894,11 @@ static inline int fuzzy_search_state(const bool prefix, int key_index, unsigned
 }
 
 static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *n, int depth, const unsigned char *term,
-                              const int term_len, const int* irow, const int* jrow, const int min_cost,
+                              const int term_len, fuzzy_rows_t& rows, int row_index, const int min_cost,
                               const int max_cost, const bool prefix, std::vector<const art_node *> &results) {
 
     if (!n) return ;
 
-    const int columns = term_len+1;
-    int i=0, j=1, k=2;
-    int row0[columns];
-    int row1[columns];
-    int row2[columns];
-    int* rows[3] = {row0, row1, row2};
-
-    copyIntArray2(irow, rows[i], columns);
-    copyIntArray2(jrow, rows[j], columns);
-
     if(depth == -1) {
         // root node
         depth = 0;
@@ -1618,11 +1907,10 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
         bool last_key_char = (c == '\0');
 
         if(!prefix || !last_key_char) {
-            levenshtein_dist(depth, p, c, term, term_len, rows[i], rows[j], rows[k]);
-            rotate(i, j, k);
+            levenshtein_dist(depth, p, c, term, term_len, rows, row_index);
         }
 
-        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows[j], min_cost, max_cost);
+        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows.row(row_index), min_cost, max_cost);
         if(1 == action) {
             results.push_back(n);
             return;
@@ -1651,7 +1939,7 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
 
         if(depth >= iter_len) {
             // when a preceding partial node completely contains the whole leaf (e.g. "[raspberr]y" on "raspberries")
-            int action = fuzzy_search_state(prefix, depth, '\0', '\0', term, term_len, rows[j], min_cost, max_cost);
+            int action = fuzzy_search_state(prefix, depth, '\0', '\0', term, term_len, rows.row(row_index), min_cost, max_cost);
             if(action == 1) {
                 results.push_back(n);
             }
@@ -1665,15 +1953,13 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
             bool last_key_char = (c == '\0');
 
             if(!prefix || !last_key_char) {
-                levenshtein_dist(depth, p, c, term, term_len, rows[i], rows[j], rows[k]);
+                levenshtein_dist(depth, p, c, term, term_len, rows, row_index);
 
                 printf("leaf char: %c\n", l->key[depth]);
                 printf("cost: %d, depth: %d, term_len: %d\n", temp_cost, depth, term_len);
-
-                rotate(i, j, k);
             }
 
-            int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows[j], min_cost, max_cost);
+            int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows.row(row_index), min_cost, max_cost);
             if(action == 1) {
                 results.push_back(n);
                 return;
@@ -1698,10 +1984,9 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
     for (int idx = 0; idx < partial_len; idx++) {
         c = n->partial[idx];
 
-        levenshtein_dist(depth, p, c, term, term_len, rows[i], rows[j], rows[k]);
-        rotate(i, j, k);
+        levenshtein_dist(depth, p, c, term, term_len, rows, row_index);
 
-        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows[j], min_cost, max_cost);
+        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows.row(row_index), min_cost, max_cost);
         if(action == 1) {
             results.push_back(n);
             return;
@@ -1718,10 +2003,9 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
     // Some intermediate path may have been left out if partial_len is truncated: progress the levenshtein matrix
     while(partial_len < n->partial_len && depth < term_len) {
         c = term[depth];
-        levenshtein_dist(depth, p, c, term, term_len, rows[i], rows[j], rows[k]);
-        rotate(i, j, k);
+        levenshtein_dist(depth, p, c, term, term_len, rows, row_index);
 
-        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows[j], min_cost, max_cost);
+        int action = fuzzy_search_state(prefix, depth, p, c, term, term_len, rows.row(row_index), min_cost, max_cost);
         if(action == 1) {
             results.push_back(n);
             return;
@@ -1736,7 +2020,7 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
         partial_len++;
     }
 
-    art_fuzzy_children(c, n, depth, term, term_len, rows[i], rows[j], min_cost, max_cost, prefix, results);
+    art_fuzzy_children(c, n, depth, term, term_len, rows, row_index, min_cost, max_cost, prefix, results);
 }
 
 /**
@@ -1749,24 +2033,20 @@ int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len,
                      std::vector<art_leaf *> &results, std::set<std::string>& exclude_leaves) {
 
     std::vector<const art_node*> nodes;
-    int irow[term_len + 1];
-    int jrow[term_len + 1];
-    for (int i = 0; i <= term_len; i++){
-        irow[i] = jrow[i] = i;
-    }
+    fuzzy_rows_t rows(term_len, max_cost);
 
     //auto begin = std::chrono::high_resolution_clock::now();
 
     if(IS_LEAF(t->root)) {
         art_leaf *l = (art_leaf *) LEAF_RAW(t->root);
-        art_fuzzy_recurse(0, l->key[0], t->root, 0, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
+        art_fuzzy_recurse(0, l->key[0], t->root, 0, term, term_len, rows, 1, min_cost, max_cost, prefix, nodes);
     } else {
         if(t->root == nullptr) {
             return 0;
         }
 
         // send depth as -1 to indicate that this is a root node
-        art_fuzzy_recurse(0, 0, t->root, -1, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
+        art_fuzzy_recurse(0, 0, t->root, -1, term, term_len, rows, 1, min_cost, max_cost, prefix, nodes);
     }
 
     //long long int time_micro = microseconds(std::chrono::high_resolution_clock::now() - begin).count();
@@ -1822,6 +2102,64 @@ int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len,
     return 0;
 }
 
+/*
+ * Answers a cost 0 prefix query from the precomputed top leaves of the prefix, picking the leaves in the same order
+ * as `art_topk_iter` would. Returns false when the list cannot tell the whole answer, and the caller has to fall
+ * back on iterating the subtree (leaves that were already added are skipped by then via `exclude_leaves`).
+ */
+static bool art_topk_from_prefix(const art_tree* t, const unsigned char* term, const int term_len,
+                                 const size_t max_words, const art_leaf* exact_leaf, const std::string& prev_token,
+                                 filter_result_iterator_t* const filter_result_iterator,
+                                 std::set<std::string>& exclude_leaves, std::vector<art_leaf*>& results) {
+    if(t->prefix_topk == nullptr || term_len == 0 || size_t(term_len) > art_prefix_topk::PREFIX_LEN ||
+       max_words * 4 > art_prefix_topk::K) {
+        return false;
+    }
+
+    auto list_it = t->prefix_topk->lists.find(std::string((const char*) term, term_len));
+    if(list_it == t->prefix_topk->lists.end()) {
+        return false;
+    }
+
+    auto prev_leaf = static_cast<art_leaf*>(
+            art_search(t, reinterpret_cast<const unsigned char*>(prev_token.c_str()), prev_token.size() + 1)
+    );
+
+    for(art_leaf* leaf: list_it->second.leaves) {
+        if(results.size() >= max_words * 4) {
+            return true;
+        }
+
+        validate_and_add_leaf(leaf, prev_token, prev_leaf, exact_leaf, filter_result_iterator,
+                              exclude_leaves, results);
+        filter_result_iterator->reset();
+
+        if(filter_result_iterator->validity == filter_result_iterator_t::timed_out) {
+            search_cutoff = true;
+            return true;
+        }
+    }
+
+    return results.size() >= max_words * 4 || list_it->second.complete;
+}
+
+void art_fuzzy_nodes(const art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                     const int max_cost, const bool prefix, std::vector<const art_node*>& nodes) {
+    if(t->root == nullptr) {
+        return;
+    }
+
+    fuzzy_rows_t rows(term_len, max_cost);
+
+    if(IS_LEAF(t->root)) {
+        art_leaf *l = (art_leaf *) LEAF_RAW(t->root);
+        art_fuzzy_recurse(0, l->key[0], t->root, 0, term, term_len, rows, 1, min_cost, max_cost, prefix, nodes);
+    } else {
+        // send depth as -1 to indicate that this is a root node
+        art_fuzzy_recurse(0, 0, t->root, -1, term, term_len, rows, 1, min_cost, max_cost, prefix, nodes);
+    }
+}
+
 int art_fuzzy_search_i(art_tree *t, const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
                        const size_t max_words, const token_ordering token_order,
                        const bool prefix, bool last_token, const std::string& prev_token,
@@ -1829,37 +2167,38 @@ int art_fuzzy_search_i(art_tree *t, const unsigned char *term, const int term_le
                        std::vector<art_leaf *> &results, std::set<std::string>& exclude_leaves) {
 
     std::vector<const art_node*> nodes;
-    int irow[term_len + 1];
-    int jrow[term_len + 1];
-    for (int i = 0; i <= term_len; i++){
-        irow[i] = jrow[i] = i;
-    }
 
     //auto begin = std::chrono::high_resolution_clock::now();
 
-    if(IS_LEAF(t->root)) {
-        art_leaf *l = (art_leaf *) LEAF_RAW(t->root);
-        art_fuzzy_recurse(0, l->key[0], t->root, 0, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
-    } else {
-        if(t->root == nullptr) {
-            return 0;
-        }
-
-        // send depth as -1 to indicate that this is a root node
-        art_fuzzy_recurse(0, 0, t->root, -1, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
-    }
+    art_fuzzy_nodes(t, term, term_len, min_cost, max_cost, prefix, nodes);
 
     //long long int time_micro = microseconds(std::chrono::high_resolution_clock::now() - begin).count();
     //!LOG(INFO) << "Time taken for fuzz: " << time_micro << "us, size of nodes: " << nodes.size();
 
+    return art_fuzzy_search_nodes(t, nodes, term, term_len, min_cost, max_cost, max_words, token_order, prefix,
+                                  last_token, prev_token, filter_result_iterator, results, exclude_leaves);
+}
+
+int art_fuzzy_search_nodes(art_tree *t, const std::vector<const art_node*>& nodes,
+                           const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
+                           const size_t max_words, const token_ordering token_order,
+                           const bool prefix, bool last_token, const std::string& prev_token,
+                           filter_result_iterator_t* const filter_result_iterator,
+                           std::vector<art_leaf *> &results, std::set<std::string>& exclude_leaves) {
+
     //auto begin = std::chrono::high_resolution_clock::now();
 
     size_t key_len = prefix ? term_len + 1 : term_len;
     art_leaf* exact_leaf = (art_leaf *) art_search(t, term, key_len);
     //LOG(INFO) << "exact_leaf: " << exact_leaf << ", term: " << term << ", term_len: " << term_len;
 
-    for(auto node: nodes) {
-        art_topk_iter(node, token_order, max_words,
+    // the precomputed top leaves only hold exact prefix matches, so typo matches still need the nodes to be walked
+    const bool from_prefix_topk = (token_order == MAX_SCORE && prefix && max_cost == 0) &&
+                                  art_topk_from_prefix(t, term, term_len, max_words, exact_leaf, prev_token,
+                                                       filter_result_iterator, exclude_leaves, results);
+
+    for(size_t i = 0; !from_prefix_topk && i < nodes.size(); i++) {
+        art_topk_iter(nodes[i], token_order, max_words,
                       exact_leaf, last_token, prev_token,
                       filter_result_iterator,
                       t, exclude_leaves, results);
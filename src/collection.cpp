@@ -7,6 +7,7 @@
 #include <art.h>
 #include <rocksdb/write_batch.h>
 #include <system_metrics.h>
+#include <app_metrics.h>
 #include <tokenizer.h>
 #include <collection_manager.h>
 #include <regex>
@@ -427,6 +428,16 @@ Option<doc_seq_id_t> Collection::to_doc(const std::string & json_str, nlohmann::
     }
 }
 
+nlohmann::json Collection::get_memory_usage() const {
+    std::shared_lock lock(mutex);
+
+    nlohmann::json json_response = index->get_memory_usage();
+    json_response["name"] = name;
+    json_response["num_documents"] = num_documents.load();
+
+    return json_response;
+}
+
 nlohmann::json Collection::get_summary_json() const {
     std::shared_lock lock(mutex);
 
@@ -753,6 +764,8 @@ void Collection::batch_index(std::vector<index_record>& index_records, std::vect
 
     batch_index_in_memory(index_records, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries, true);
 
+    auto store_begin = std::chrono::high_resolution_clock::now();
+
     // store only documents that were indexed in-memory successfully
     for(auto& index_record: index_records) {
         nlohmann::json res;
@@ -840,6 +853,10 @@ void Collection::batch_index(std::vector<index_record>& index_records, std::vect
         json_out[index_record.position] = res.dump(-1, ' ', false,
                                                    nlohmann::detail::error_handler_t::ignore);
     }
+
+    AppMetrics::get_instance().record_write_stage(WRITE_STAGE_STORE,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - store_begin).count());
 }
 
 Option<uint32_t> Collection::index_in_memory(nlohmann::json &document, uint32_t seq_id,
@@ -1009,6 +1026,18 @@ void Collection::curate_results(string& actual_query, const string& filter_query
             query = StringUtils::join(tokens, " ");
         }
 
+        // overrides outside of this set can never match the query, so they don't have to be evaluated
+        std::set<std::string> candidate_ids;
+        override_index.get_candidates(query, filter_query, candidate_ids);
+
+        // a matched override can remove tokens from the query, which the overrides after it are matched against
+        auto refresh_candidates = [&](const std::string& previous_query) {
+            if(query != previous_query) {
+                candidate_ids.clear();
+                override_index.get_candidates(query, filter_query, candidate_ids);
+            }
+        };
+
         if(!tags.empty()) {
             bool all_tags_found = false;
             std::set<std::string> found_overrides;
@@ -1026,7 +1055,12 @@ void Collection::curate_results(string& actual_query, const string& filter_query
 
                         const auto& override = override_it->second;
 
+                        if(candidate_ids.count(id) == 0 && !OverrideIndex::is_tags_only(override)) {
+                            continue;
+                        }
+
                         if(override.rule.tags == tags) {
+                            const std::string previous_query = query;
                             bool match_found = does_override_match(override, query, excluded_set, actual_query,
                                                                    filter_query, already_segmented, true, false,
                                                                    pinned_hits, hidden_hits, included_ids,
@@ -1039,6 +1073,7 @@ void Collection::curate_results(string& actual_query, const string& filter_query
                                 if(override.stop_processing) {
                                     break;
                                 }
+                                refresh_candidates(previous_query);
                             }
                         }
                     }
@@ -1065,6 +1100,11 @@ void Collection::curate_results(string& actual_query, const string& filter_query
                         }
 
                         const auto& override = override_it->second;
+
+                        if(candidate_ids.count(id) == 0 && !OverrideIndex::is_tags_only(override)) {
+                            continue;
+                        }
+
                         std::set<std::string> matching_tags;
                         std::set_intersection(override.rule.tags.begin(), override.rule.tags.end(),
                                               tags.begin(), tags.end(),
@@ -1074,6 +1114,7 @@ void Collection::curate_results(string& actual_query, const string& filter_query
                             continue;
                         }
 
+                        const std::string previous_query = query;
                         bool match_found = does_override_match(override, query, excluded_set, actual_query,
                                                                filter_query, already_segmented, true, false,
                                                                pinned_hits, hidden_hits, included_ids,
@@ -1085,15 +1126,24 @@ void Collection::curate_results(string& actual_query, const string& filter_query
                             if(override.stop_processing) {
                                 break;
                             }
+                            refresh_candidates(previous_query);
                         }
                     }
                 }
             }
         } else {
             // no override tags given
-            for(const auto& override_kv: overrides) {
-                const auto& override = override_kv.second;
+            for(auto id_it = candidate_ids.begin(); id_it != candidate_ids.end();) {
+                const std::string id = *id_it;
+                auto override_it = overrides.find(id);
+                if(override_it == overrides.end()) {
+                    id_it++;
+                    continue;
+                }
+
+                const auto& override = override_it->second;
                 bool wildcard_tag = override.rule.tags.size() == 1 && *override.rule.tags.begin() == "*";
+                const std::string previous_query = query;
                 bool match_found = does_override_match(override, query, excluded_set, actual_query, filter_query,
                                                        already_segmented, false, wildcard_tag,
                                                        pinned_hits, hidden_hits, included_ids,
@@ -1102,6 +1152,14 @@ void Collection::curate_results(string& actual_query, const string& filter_query
                 if(match_found && override.stop_processing) {
                     break;
                 }
+
+                if(query != previous_query) {
+                    // continue after this override with the candidates of the rewritten query
+                    refresh_candidates(previous_query);
+                    id_it = candidate_ids.upper_bound(id);
+                } else {
+                    id_it++;
+                }
             }
         }
     }
@@ -1318,7 +1376,8 @@ Option<bool> Collection::validate_and_standardize_sort_fields(const std::vector<
                         }
 
                         std::string embed_query = embedder_manager.get_query_prefix(vector_field_it.value().embed[fields::model_config]) + q;
-                        auto embedding_op = embedder->Embed(embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+                        auto embedding_op = embedder_manager.embed_query(vector_field_it.value().embed[fields::model_config], embedder,
+                                                                         embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
 
                         if(!embedding_op.success) {
                             if(!embedding_op.error["error"].get<std::string>().empty()) {
@@ -1373,7 +1432,8 @@ Option<bool> Collection::validate_and_standardize_sort_fields(const std::vector<
                     }
 
                     std::string embed_query = embedder_manager.get_query_prefix(vector_field_it.value().embed[fields::model_config]) + query;
-                    auto embedding_op = embedder->Embed(embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+                    auto embedding_op = embedder_manager.embed_query(vector_field_it.value().embed[fields::model_config], embedder,
+                                                                     embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
 
                     if(!embedding_op.success) {
                         if(!embedding_op.error["error"].get<std::string>().empty()) {
@@ -1761,6 +1821,10 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
                                   bool enable_lazy_filter) const {
     std::shared_lock lock(mutex);
 
+    // query embedding happens while the request is parsed, but it is accounted to its own stage
+    search_stage_timer_t parse_timer(SEARCH_STAGE_PARSE);
+    const uint64_t embed_us_before_parse = search_stage_us[SEARCH_STAGE_EMBED];
+
     // setup thread local vars
     search_stop_us = search_stop_millis * 1000;
     search_begin_us = (search_time_start_us != 0) ? search_time_start_us :
@@ -1957,7 +2021,8 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
                 }
 
                 std::string embed_query = embedder_manager.get_query_prefix(search_field.embed[fields::model_config]) + query;
-                auto embedding_op = embedder->Embed(embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+                auto embedding_op = embedder_manager.embed_query(search_field.embed[fields::model_config], embedder,
+                                                                 embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
                 if(!embedding_op.success) {
                     if(!embedding_op.error["error"].get<std::string>().empty()) {
                         return Option<nlohmann::json>(400, embedding_op.error["error"].get<std::string>());
@@ -2339,7 +2404,8 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
                                                  default_sorting_field,
                                                  prioritize_exact_match, prioritize_token_position,
                                                  prioritize_num_matching_fields,
-                                                 exhaustive_search, 4,
+                                                 exhaustive_search,
+                                                 std::max<size_t>(1, Config::get_instance().get_num_search_partitions()),
                                                  search_stop_millis,
                                                  min_len_1typo, min_len_2typo, max_candidates, infixes,
                                                  max_extra_prefix, max_extra_suffix, facet_query_num_typos,
@@ -2349,8 +2415,13 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
 
     std::unique_ptr<search_args> search_params_guard(search_params);
 
+    parse_timer.stop();
+    search_stage_us[SEARCH_STAGE_PARSE] -= (search_stage_us[SEARCH_STAGE_EMBED] - embed_us_before_parse);
+
     auto search_op = index->run_search(search_params, name, facet_index_type, enable_typos_for_numerical_tokens);
 
+    search_stage_timer_t grouping_timer(SEARCH_STAGE_GROUPING);
+
     // filter_tree_root might be updated in Index::static_filter_query_eval.
     filter_tree_root_guard.release();
     filter_tree_root_guard.reset(filter_tree_root);
@@ -2453,6 +2524,8 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
         override_kv_index++;
     }
 
+    grouping_timer.stop();
+
     std::string facet_query_last_token;
     size_t facet_query_num_tokens = 0;       // used to identify drop token scenario
 
@@ -2531,7 +2604,9 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
             const std::string& seq_id_key = get_seq_id_key((uint32_t) field_order_kv->key);
 
             nlohmann::json document;
+            search_stage_timer_t hit_fetch_timer(SEARCH_STAGE_HIT_FETCH);
             const Option<bool> & document_op = get_document_from_store(seq_id_key, document);
+            hit_fetch_timer.stop();
 
             if(!document_op.ok()) {
                 LOG(ERROR) << "Document fetch error. " << document_op.error();
@@ -2575,12 +2650,15 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
                     bool found_highlight = false;
                     bool found_full_highlight = false;
 
+                    search_stage_timer_t highlight_timer(SEARCH_STAGE_HIGHLIGHT);
                     highlight_result(raw_query, search_field, i, highlight_item.qtoken_leaves, field_order_kv,
                                      document, highlight_res,
                                      string_utils, snippet_threshold,
                                      highlight_affix_num_tokens, highlight_item.fully_highlighted, highlight_item.infix,
                                      highlight_start_tag, highlight_end_tag, index_symbols, highlight,
                                      found_highlight, found_full_highlight);
+                    highlight_timer.stop();
+
                     if(!highlight.snippets.empty()) {
                         highlights.push_back(highlight);
                     }
@@ -2824,6 +2902,7 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
         }
     }
 
+    search_stage_timer_t facets_timer(SEARCH_STAGE_FACETS);
     result["facet_counts"] = nlohmann::json::array();
     
     // populate facets
@@ -3046,6 +3125,8 @@ Option<nlohmann::json> Collection::search(std::string raw_query,
         result["facet_counts"].push_back(facet_result);
     }
 
+    facets_timer.stop();
+
     result["search_cutoff"] = search_cutoff;
 
     result["request_params"] = nlohmann::json::object();
@@ -4445,7 +4526,9 @@ Option<uint32_t> Collection::add_override(const override_t & override, bool writ
 
     std::unique_lock lock(mutex);
 
-    if(overrides.count(override.id) != 0 && !overrides[override.id].rule.tags.empty()) {
+    if(overrides.count(override.id) != 0) {
+        override_index.remove(overrides[override.id]);
+
         // remove existing tags
         for(auto& tag: overrides[override.id].rule.tags) {
             if(override_tags.count(tag) != 0) {
@@ -4455,6 +4538,7 @@ Option<uint32_t> Collection::add_override(const override_t & override, bool writ
     }
 
     overrides[override.id] = override;
+    override_index.add(override);
     for(const auto& tag: override.rule.tags) {
         override_tags[tag].insert(override.id);
     }
@@ -4476,6 +4560,7 @@ Option<uint32_t> Collection::remove_override(const std::string & id) {
             }
         }
 
+        override_index.remove(overrides[id]);
         overrides.erase(id);
 
         return Option<uint32_t>(200);
@@ -4657,6 +4742,10 @@ const Index* Collection::_get_index() const {
     return index;
 }
 
+Index* Collection::_get_index() {
+    return index;
+}
+
 Option<bool> Collection::parse_pinned_hits(const std::string& pinned_hits_str,
                                            std::map<size_t, std::vector<std::string>>& pinned_hits) {
     if(!pinned_hits_str.empty()) {
@@ -6647,7 +6736,8 @@ Option<bool> Collection::parse_and_validate_vector_query(const std::string& vect
             }
 
             std::string embed_query = embedder_manager.get_query_prefix(vector_field_it.value().embed[fields::model_config]) + q;
-            auto embedding_op = embedder->Embed(embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+            auto embedding_op = embedder_manager.embed_query(vector_field_it.value().embed[fields::model_config], embedder,
+                                                             embed_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
 
             if(!embedding_op.success) {
                 if(!embedding_op.error["error"].get<std::string>().empty()) {
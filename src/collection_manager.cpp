@@ -2,6 +2,8 @@
 #include <vector>
 #include <json.hpp>
 #include <app_metrics.h>
+#include <search_profile.h>
+#include <slow_query_log.h>
 #include <analytics_manager.h>
 #include <event_manager.h>
 #include "collection_manager.h"
@@ -1386,6 +1388,12 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
 
     auto begin = std::chrono::high_resolution_clock::now();
 
+    std::fill(std::begin(search_stage_us), std::end(search_stage_us), 0);
+    search_stages_entered = 0;
+    search_num_filter_ids = 0;
+    search_num_scored_candidates = 0;
+    search_stage_timer_t parse_timer(SEARCH_STAGE_PARSE);
+
     const char *NUM_TYPOS = "num_typos";
     const char *MIN_LEN_1TYPO = "min_len_1typo";
     const char *MIN_LEN_2TYPO = "min_len_2typo";
@@ -1477,6 +1485,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     const char *ENABLE_TYPOS_FOR_NUMERICAL_TOKENS = "enable_typos_for_numerical_tokens";
     const char *ENABLE_LAZY_FILTER = "enable_lazy_filter";
 
+    const char *PROFILE = "profile";
+
     // enrich params with values from embedded params
     for(auto& item: embedded_params.items()) {
         if(item.key() == "expires_at") {
@@ -1597,6 +1607,7 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     text_match_type_t match_type = max_score;
     bool enable_typos_for_numerical_tokens = true;
     bool enable_lazy_filter = Config::get_instance().get_enable_lazy_filter();
+    bool profile = false;
 
     size_t remote_embedding_timeout_ms = 5000;
     size_t remote_embedding_num_tries = 2;
@@ -1670,6 +1681,7 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
         {GROUP_MISSING_VALUES, &group_missing_values},
         {ENABLE_TYPOS_FOR_NUMERICAL_TOKENS, &enable_typos_for_numerical_tokens},
         {ENABLE_LAZY_FILTER, &enable_lazy_filter},
+        {PROFILE, &profile},
     };
 
     std::unordered_map<std::string, std::vector<std::string>*> str_list_values = {
@@ -1826,6 +1838,10 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
                           Index::NUM_CANDIDATES_DEFAULT_MIN);
     }
 
+    parse_timer.stop();
+
+    search_profile_t profile_trace;
+    search_profile = profile ? &profile_trace : nullptr;
 
     Option<nlohmann::json> result_op = collection->search(raw_query, search_fields, filter_query, facet_fields,
                                                           sort_fields, num_typos,
@@ -1887,12 +1903,19 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
                                                           enable_typos_for_numerical_tokens,
                                                           enable_lazy_filter);
 
-    uint64_t timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+    search_profile = nullptr;
+
+    uint64_t timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::high_resolution_clock::now() - begin).count();
+    uint64_t timeMillis = timeMicros / 1000;
 
     AppMetrics::get_instance().increment_count(AppMetrics::SEARCH_LABEL, 1);
     AppMetrics::get_instance().increment_duration(AppMetrics::SEARCH_LABEL, timeMillis);
 
+    if(result_op.ok()) {
+        AppMetrics::get_instance().record_search(timeMicros);
+    }
+
     if(!result_op.ok()) {
         return Option<bool>(result_op.code(), result_op.error());
     }
@@ -1924,7 +1947,47 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
         result["page"] = (page == 0) ? 1 : page;
     }
 
+    if(profile) {
+        result["profile"] = profile_trace.to_json();
+    }
+
+    auto serialization_begin = std::chrono::high_resolution_clock::now();
     results_json_str = result.dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore);
+    search_stage_us[SEARCH_STAGE_SERIALIZATION] = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - serialization_begin).count();
+    AppMetrics::get_instance().record_search_stage(SEARCH_STAGE_SERIALIZATION,
+                                                   search_stage_us[SEARCH_STAGE_SERIALIZATION]);
+
+    const int slow_query_log_time_ms = Config::get_instance().get_slow_query_log_time_ms();
+    if(slow_query_log_time_ms >= 0 && timeMillis >= uint64_t(slow_query_log_time_ms) &&
+       SlowQueryLog::get_instance().is_enabled()) {
+        nlohmann::json record;
+        record["ts"] = start_ts / 1000;
+        record["collection"] = orig_coll_name;
+
+        // credentials and client identifiers are left out, long values like vectors are truncated
+        record["params"] = nlohmann::json::object();
+        for(const auto& kv: req_params) {
+            if(kv.first == "collection" || kv.second.empty() || StringUtils::begins_with(kv.first, "x-typesense-")) {
+                continue;
+            }
+
+            record["params"][kv.first] = kv.second.size() <= 256 ? kv.second : kv.second.substr(0, 256) + "...";
+        }
+
+        record["time_us"] = timeMicros;
+        record["stages_us"] = nlohmann::json::object();
+        for(size_t i = 0; i < NUM_SEARCH_STAGES; i++) {
+            record["stages_us"][AppMetrics::SEARCH_STAGE_NAMES[i]] = search_stage_us[i];
+        }
+
+        record["found"] = result.contains("found") ? result["found"].get<size_t>() : 0;
+        record["num_filter_ids"] = search_num_filter_ids;
+        record["num_scored_candidates"] = search_num_scored_candidates;
+        record["search_cutoff"] = search_cutoff;
+
+        SlowQueryLog::get_instance().log(record.dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore));
+    }
 
     //LOG(INFO) << "Time taken: " << timeMillis << "ms";
 
@@ -1955,6 +2018,28 @@ Option<nlohmann::json> CollectionManager::get_collection_summaries(uint32_t limi
     return Option<nlohmann::json>(json_summaries);
 }
 
+nlohmann::json CollectionManager::get_memory_usage() const {
+    std::shared_lock lock(mutex);
+
+    std::vector<Collection*> colls = get_collections().get();
+
+    nlohmann::json usage;
+    usage["collections"] = nlohmann::json::array();
+    uint64_t total_bytes = 0;
+
+    for(Collection* collection: colls) {
+        nlohmann::json collection_usage = collection->get_memory_usage();
+
+        // field level details are served per collection
+        collection_usage.erase("fields");
+        total_bytes += collection_usage["total_bytes"].get<uint64_t>();
+        usage["collections"].push_back(collection_usage);
+    }
+
+    usage["total_bytes"] = total_bytes;
+    return usage;
+}
+
 Option<Collection*> CollectionManager::create_collection(nlohmann::json& req_json) {
     const char* NUM_MEMORY_SHARDS = "num_memory_shards";
     const char* SYMBOLS_TO_INDEX = "symbols_to_index";
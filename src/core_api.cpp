@@ -407,11 +407,27 @@ bool get_stats_json(const std::shared_ptr<http_req>& req, const std::shared_ptr<
     nlohmann::json result;
     AppMetrics::get_instance().get("requests_per_second", "latency_ms", result);
     result["pending_write_batches"] = server->get_num_queued_writes();
+    AnalyticsManager::get_instance().get_query_buffer_stats(result);
+    HttpClient::get_pool_stats(result);
+    EmbedderManager::get_instance().get_query_embedding_cache_stats(result);
 
     res->set_body(200, result.dump(2));
     return true;
 }
 
+bool get_memory_json(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
+    nlohmann::json result = CollectionManager::get_instance().get_memory_usage();
+
+    res->set_body(200, result.dump(2));
+    return true;
+}
+
+bool get_prometheus_metrics(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
+    res->set_content(200, "text/plain; version=0.0.4; charset=utf-8",
+                     AppMetrics::get_instance().get_prometheus_metrics(), true);
+    return true;
+}
+
 bool get_status(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
     nlohmann::json status = server->node_status();
     res->set_body(200, status.dump());
@@ -943,6 +959,21 @@ bool get_collection_summary(const std::shared_ptr<http_req>& req, const std::sha
     return true;
 }
 
+bool get_collection_memory(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
+    CollectionManager& collectionManager = CollectionManager::get_instance();
+    auto collection = collectionManager.get_collection(req->params["collection"]);
+
+    if(collection == nullptr) {
+        res->set_404();
+        return false;
+    }
+
+    nlohmann::json json_response = collection->get_memory_usage();
+    res->set_200(json_response.dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore));
+
+    return true;
+}
+
 bool get_export_documents(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
     // NOTE: this is a streaming response end-point so this handler will be called multiple times
     CollectionManager & collectionManager = CollectionManager::get_instance();
@@ -1,5 +1,7 @@
 #include "embedder_manager.h"
+#include "field.h"
 #include "system_metrics.h"
+#include "thread_local_vars.h"
 
 
 EmbedderManager& EmbedderManager::get_instance() {
@@ -145,10 +147,14 @@ Option<bool> EmbedderManager::validate_and_init_local_model(const nlohmann::json
     return Option<bool>(true);
 }
 
+std::string EmbedderManager::get_model_key(const nlohmann::json& model_config) {
+    const std::string& model_name = model_config.at("model_name");
+    return is_remote_model(model_name) ? RemoteEmbedder::get_model_key(model_config) : model_name;
+}
+
 Option<TextEmbedder*> EmbedderManager::get_text_embedder(const nlohmann::json& model_config) {
     std::unique_lock<std::mutex> lock(text_embedders_mutex);
-    const std::string& model_name = model_config.at("model_name");
-    std::string model_key = is_remote_model(model_name) ? RemoteEmbedder::get_model_key(model_config) : model_name;
+    std::string model_key = get_model_key(model_config);
     auto text_embedder_it = text_embedders.find(model_key);
 
     if(text_embedder_it == text_embedders.end()) {
@@ -170,6 +176,64 @@ Option<ImageEmbedder*> EmbedderManager::get_image_embedder(const nlohmann::json&
     return Option<ImageEmbedder*>(image_embedder_it->second.get());
 }
 
+embedding_res_t EmbedderManager::embed_query(const nlohmann::json& model_config, TextEmbedder* embedder,
+                                             const std::string& query, const size_t remote_embedding_timeout_ms,
+                                             const size_t remote_embedding_num_tries) {
+    search_stage_timer_t embed_timer(SEARCH_STAGE_EMBED);
+
+    const uint64_t ttl_s = model_config.count(fields::query_cache_ttl) != 0 ?
+                           model_config[fields::query_cache_ttl].get<uint64_t>() : DEFAULT_QUERY_CACHE_TTL_S;
+
+    if(ttl_s == 0) {
+        return embedder->Embed(query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+    }
+
+    std::string normalized_query = query;
+    StringUtils::trim(normalized_query);
+
+    const std::string cache_key = get_model_key(model_config) + '\x1f' +
+                                  std::to_string(embedder->get_num_dim()) + '\x1f' + normalized_query;
+    const auto now = std::chrono::steady_clock::now();
+
+    {
+        std::unique_lock<std::mutex> lock(query_embedding_cache_mutex);
+        if(query_embedding_cache.contains(cache_key)) {
+            const auto& entry = query_embedding_cache.lookup(cache_key);
+            if(entry.expires_at > now) {
+                query_embedding_cache_hits++;
+                return embedding_res_t(entry.embedding);
+            }
+
+            query_embedding_cache.erase(cache_key);
+        }
+    }
+
+    query_embedding_cache_misses++;
+    auto embedding_res = embedder->Embed(normalized_query, remote_embedding_timeout_ms, remote_embedding_num_tries);
+
+    if(embedding_res.success) {
+        query_embedding_cache_entry_t entry{embedding_res.embedding, now + std::chrono::seconds(ttl_s)};
+        std::unique_lock<std::mutex> lock(query_embedding_cache_mutex);
+        query_embedding_cache.insert(cache_key, entry);
+    }
+
+    return embedding_res;
+}
+
+void EmbedderManager::clear_query_embedding_cache() {
+    std::unique_lock<std::mutex> lock(query_embedding_cache_mutex);
+    query_embedding_cache.clear();
+}
+
+void EmbedderManager::get_query_embedding_cache_stats(nlohmann::json& result) {
+    const uint64_t hits = query_embedding_cache_hits;
+    const uint64_t misses = query_embedding_cache_misses;
+
+    result["query_embedding_cache_hits"] = hits;
+    result["query_embedding_cache_misses"] = misses;
+    result["query_embedding_cache_hit_rate"] = (hits + misses) == 0 ? 0.0 : double(hits) / (hits + misses);
+}
+
 void EmbedderManager::delete_text_embedder(const std::string& model_path) {
     std::unique_lock<std::mutex> lock(text_embedders_mutex);
     if (text_embedders.find(model_path) != text_embedders.end()) {
@@ -179,11 +243,17 @@ void EmbedderManager::delete_text_embedder(const std::string& model_path) {
     if (public_models.find(model_path) != public_models.end()) {
         public_models.erase(model_path);
     }
+
+    lock.unlock();
+    clear_query_embedding_cache();
 }
 
 void EmbedderManager::delete_all_text_embedders() {
     std::unique_lock<std::mutex> lock(text_embedders_mutex);
     text_embedders.clear();
+    lock.unlock();
+
+    clear_query_embedding_cache();
 }
 
 void EmbedderManager::delete_image_embedder(const std::string& model_path) {
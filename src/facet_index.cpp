@@ -2,6 +2,7 @@
 #include <tokenizer.h>
 #include "string_utils.h"
 #include "array_utils.h"
+#include "memory_usage.h"
 
 void facet_index_t::initialize(const std::string& field) {
     const auto facet_field_map_it = facet_field_map.find(field);
@@ -316,6 +317,36 @@ size_t facet_index_t::get_facet_count(const std::string& field_name) {
     return has_hash_index(field_name) ? it->second.seq_id_hashes->num_ids() :  it->second.counts.size();
 }
 
+size_t facet_index_t::memory_used(const std::string& field_name) const {
+    const auto it = facet_field_map.find(field_name);
+
+    if(it == facet_field_map.end()) {
+        return 0;
+    }
+
+    const auto& facet_index = it->second;
+    size_t bytes = sizeof(facet_doc_ids_list_t) + tree_map_memory_used(facet_index.fvalue_seq_ids) +
+                   tree_map_memory_used(facet_index.count_map) +
+                   sparse_hash_map_memory_used(facet_index.fhash_to_int64_map);
+
+    for(const auto& fvalue_seq_ids: facet_index.fvalue_seq_ids) {
+        bytes += string_memory_used(fvalue_seq_ids.first);
+        if(fvalue_seq_ids.second.seq_ids != nullptr) {
+            bytes += ids_t::memory_used(fvalue_seq_ids.second.seq_ids);
+        }
+    }
+
+    for(const auto& facet_count: facet_index.counts) {
+        bytes += LIST_NODE_OVERHEAD + sizeof(facet_count_t) + string_memory_used(facet_count.facet_value);
+    }
+
+    if(facet_index.seq_id_hashes != nullptr) {
+        bytes += facet_index.seq_id_hashes->memory_used();
+    }
+
+    return bytes;
+}
+
 //returns the count of matching seq_ids from result array
 size_t facet_index_t::intersect(facet& a_facet, const field& facet_field,
                                 bool has_facet_query,
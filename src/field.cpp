@@ -270,6 +270,12 @@ Option<bool> field::json_field_to_field(bool enable_nested_fields, nlohmann::jso
             }
         }
 
+        if(model_config.count(fields::query_cache_ttl) != 0) {
+            if(!model_config[fields::query_cache_ttl].is_number_unsigned()) {
+                return Option<bool>(400, "Property `" + fields::embed + "." + fields::model_config + "." + fields::query_cache_ttl + "` must be a non-negative integer.");
+            }
+        }
+
         for(auto& embed_from_field : field_json[fields::embed][fields::from]) {
             if(!embed_from_field.is_string()) {
                 return Option<bool>(400, "Property `" + fields::embed + "." + fields::from + "` must contain only field names as strings.");
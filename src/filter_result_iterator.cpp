@@ -1,3 +1,4 @@
+#include <chrono>
 #include <memory>
 #include <queue>
 #include <id_list.h>
@@ -13,6 +14,7 @@
 #include "index.h"
 #include "posting.h"
 #include "collection_manager.h"
+#include "geo_point_verifier.h"
 
 void copy_references_helper(const std::map<std::string, reference_filter_result_t>* from,
                             std::map<std::string, reference_filter_result_t>*& to, const uint32_t& count) {
@@ -486,6 +488,15 @@ void filter_result_iterator_t::next() {
 
         seq_id = bool_iterator.seq_id;
         return;
+    } else if (f.is_integer() || f.is_float()) {
+        numeric_iterator.next();
+        if (!numeric_iterator.is_valid) {
+            validity = invalid;
+            return;
+        }
+
+        seq_id = numeric_iterator.seq_id;
+        return;
     } else if (f.is_string()) {
         if (filter_node->filter_exp.apply_not_equals) {
             do {
@@ -541,6 +552,47 @@ void numeric_not_equals_filter(num_tree_t* const num_tree,
     delete[] to_exclude_ids;
 }
 
+/// Returns false if the filter is not a single comparison, which is the only kind of numeric filter that can be
+/// iterated without materializing its matches.
+bool get_numeric_range_iterator(NumericTrie* const trie, const filter& a_filter, const bool& is_float,
+                                NumericTrie::iterator_t& iterator) {
+    if (a_filter.apply_not_equals || a_filter.values.empty()) {
+        return false;
+    }
+
+    auto const to_int64 = [&is_float](const std::string& filter_value) {
+        return is_float ? Index::float_to_int64_t((float) std::atof(filter_value.c_str())) :
+                            (int64_t) std::stol(filter_value);
+    };
+
+    auto const& comparator = a_filter.comparators[0];
+    if (comparator == RANGE_INCLUSIVE) {
+        if (a_filter.values.size() != 2) {
+            return false;
+        }
+
+        iterator = trie->search_range(to_int64(a_filter.values[0]), true, to_int64(a_filter.values[1]), true);
+        return true;
+    }
+
+    if (a_filter.values.size() != 1) {
+        return false;
+    }
+
+    auto const value = to_int64(a_filter.values[0]);
+    if (comparator == EQUALS) {
+        iterator = trie->search_equal_to(value);
+    } else if (comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
+        iterator = trie->search_greater_than(value, comparator == GREATER_THAN_EQUALS);
+    } else if (comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
+        iterator = trie->search_less_than(value, comparator == LESS_THAN_EQUALS);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
 void apply_not_equals(uint32_t*&& all_ids,
                       uint32_t&& all_ids_length,
                       uint32_t*& result_ids,
@@ -771,6 +823,20 @@ void filter_result_iterator_t::init() {
         if (f.range_index) {
             auto const& trie = index->range_index.at(a_filter.field_name);
 
+            // A range filter that could match a large number of ids is iterated lazily, so that AND with a selective
+            // clause only decodes the ids around the ones it skips to.
+            if (get_numeric_range_iterator(trie, a_filter, false, numeric_iterator) &&
+                (prefer_iteration || numeric_iterator.approx_filter_ids_length > numeric_filter_ids_threshold)) {
+                if (!numeric_iterator.is_valid) {
+                    validity = invalid;
+                    return;
+                }
+
+                seq_id = numeric_iterator.seq_id;
+                approx_filter_ids_length = numeric_iterator.approx_filter_ids_length;
+                return;
+            }
+
             for (size_t fi = 0; fi < a_filter.values.size(); fi++) {
                 const std::string& filter_value = a_filter.values[fi];
                 auto const& value = (int64_t)std::stol(filter_value);
@@ -844,6 +910,20 @@ void filter_result_iterator_t::init() {
         if (f.range_index) {
             auto const& trie = index->range_index.at(a_filter.field_name);
 
+            // A range filter that could match a large number of ids is iterated lazily, so that AND with a selective
+            // clause only decodes the ids around the ones it skips to.
+            if (get_numeric_range_iterator(trie, a_filter, true, numeric_iterator) &&
+                (prefer_iteration || numeric_iterator.approx_filter_ids_length > numeric_filter_ids_threshold)) {
+                if (!numeric_iterator.is_valid) {
+                    validity = invalid;
+                    return;
+                }
+
+                seq_id = numeric_iterator.seq_id;
+                approx_filter_ids_length = numeric_iterator.approx_filter_ids_length;
+                return;
+            }
+
             for (size_t fi = 0; fi < a_filter.values.size(); fi++) {
                 const std::string& filter_value = a_filter.values[fi];
                 float value = (float)std::atof(filter_value.c_str());
@@ -946,7 +1026,8 @@ void filter_result_iterator_t::init() {
 
             // For a boolean filter like `in_stock: true` that could match a large number of ids, we use bool_iterator.
             if (a_filter.values.size() == 1 && a_filter.comparators[0] == EQUALS && !a_filter.apply_not_equals &&
-                num_tree->approx_search_count(EQUALS, (a_filter.values[0] == "1" ? 1 : 0)) > bool_filter_ids_threshold) {
+                (prefer_iteration ||
+                 num_tree->approx_search_count(EQUALS, (a_filter.values[0] == "1" ? 1 : 0)) > bool_filter_ids_threshold)) {
                 bool_iterator = num_tree_t::iterator_t(num_tree, EQUALS, (a_filter.values[0] == "1" ? 1 : 0));
                 if (!bool_iterator.is_valid) {
                     validity = invalid;
@@ -1001,6 +1082,7 @@ void filter_result_iterator_t::init() {
 
             bool is_polygon = StringUtils::is_float(filter_value_parts.back());
             S2Region* query_region;
+            std::unique_ptr<geo_point_verifier_t> verifier;
 
             double query_radius_meters;
             if (is_polygon) {
@@ -1035,6 +1117,7 @@ void filter_result_iterator_t::init() {
                     return;
                 } else {
                     query_region = loop;
+                    verifier = std::make_unique<geo_point_verifier_t>(*loop);
                 }
 
                 query_radius_meters = S2Earth::RadiansToMeters(query_region->GetCapBound().GetRadius().radians());
@@ -1053,7 +1136,9 @@ void filter_result_iterator_t::init() {
                 double query_lat = std::stod(filter_value_parts[0]);
                 double query_lng = std::stod(filter_value_parts[1]);
                 S2Point center = S2LatLng::FromDegrees(query_lat, query_lng).ToPoint();
-                query_region = new S2Cap(center, query_radius_radians);
+                auto cap = new S2Cap(center, query_radius_radians);
+                query_region = cap;
+                verifier = std::make_unique<geo_point_verifier_t>(*cap);
             }
             std::unique_ptr<S2Region> query_region_guard(query_region);
 
@@ -1086,41 +1171,51 @@ void filter_result_iterator_t::init() {
             // we still need to do another round of exact filtering on them
 
             std::vector<uint32_t> exact_geo_result_ids;
+            std::vector<int64_t> lat_lngs;
+            std::vector<uint8_t> matches;
 
             if (f.is_single_geopoint()) {
                 auto sort_field_index = index->sort_index.at(f.name);
 
+                lat_lngs.reserve(geo_result_ids.size());
                 for (auto result_id : geo_result_ids) {
                     // no need to check for existence of `result_id` because of indexer based pre-filtering above
-                    int64_t lat_lng = sort_field_index->at(result_id);
-                    S2LatLng s2_lat_lng;
-                    GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
-                    if (query_region->Contains(s2_lat_lng.ToPoint())) {
-                        exact_geo_result_ids.push_back(result_id);
+                    lat_lngs.push_back(sort_field_index->at(result_id));
+                }
+
+                matches.resize(lat_lngs.size());
+                verifier->verify(lat_lngs.data(), lat_lngs.size(), matches.data());
+
+                for (size_t i = 0; i < geo_result_ids.size(); i++) {
+                    if (matches[i]) {
+                        exact_geo_result_ids.push_back(geo_result_ids[i]);
                     }
                 }
             } else {
                 spp::sparse_hash_map<uint32_t, int64_t*>* geo_field_index = index->geo_array_index.at(f.name);
 
+                // points of all the documents are verified in a single batch
+                std::vector<uint32_t> num_points;
+                num_points.reserve(geo_result_ids.size());
+
                 for (auto result_id : geo_result_ids) {
-                    int64_t* lat_lngs = geo_field_index->at(result_id);
+                    int64_t* doc_lat_lngs = geo_field_index->at(result_id);
+                    lat_lngs.insert(lat_lngs.end(), doc_lat_lngs + 1, doc_lat_lngs + 1 + doc_lat_lngs[0]);
+                    num_points.push_back(doc_lat_lngs[0]);
+                }
 
-                    bool point_found = false;
+                matches.resize(lat_lngs.size());
+                verifier->verify(lat_lngs.data(), lat_lngs.size(), matches.data());
 
+                size_t point_index = 0;
+                for (size_t i = 0; i < geo_result_ids.size(); i++) {
                     // any one point should exist
-                    for (size_t li = 0; li < lat_lngs[0]; li++) {
-                        int64_t lat_lng = lat_lngs[li + 1];
-                        S2LatLng s2_lat_lng;
-                        GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
-                        if (query_region->Contains(s2_lat_lng.ToPoint())) {
-                            point_found = true;
-                            break;
-                        }
+                    auto const points_begin = matches.begin() + point_index;
+                    if (std::find(points_begin, points_begin + num_points[i], 1) != points_begin + num_points[i]) {
+                        exact_geo_result_ids.push_back(geo_result_ids[i]);
                     }
 
-                    if (point_found) {
-                        exact_geo_result_ids.push_back(result_id);
-                    }
+                    point_index += num_points[i];
                 }
             }
 
@@ -1297,7 +1392,7 @@ void filter_result_iterator_t::init() {
             return;
         } else if (a_filter.apply_not_equals) {
             all_seq_ids_iter = index->seq_ids->new_iterator();
-        } else if (approx_filter_ids_length < string_filter_ids_threshold) {
+        } else if (approx_filter_ids_length < string_filter_ids_threshold && !prefer_iteration) {
             compute_iterators();
             return;
         }
@@ -1363,6 +1458,15 @@ void filter_result_iterator_t::skip_to(uint32_t id, const bool& override_timeout
 
         seq_id = bool_iterator.seq_id;
         return;
+    } else if (f.is_integer() || f.is_float()) {
+        numeric_iterator.skip_to(id);
+        if (!numeric_iterator.is_valid) {
+            validity = invalid;
+            return;
+        }
+
+        seq_id = numeric_iterator.seq_id;
+        return;
     } else if (f.is_string()) {
         if (filter_node->filter_exp.apply_not_equals) {
             if (id < seq_id) {
@@ -1506,7 +1610,7 @@ int filter_result_iterator_t::is_valid(uint32_t id) {
 }
 
 Option<bool> filter_result_iterator_t::init_status() {
-    if (filter_node != nullptr && filter_node->isOperator) {
+    if (filter_node != nullptr && filter_node->isOperator && left_it != nullptr && right_it != nullptr) {
         auto left_status = left_it->init_status();
 
         return !left_status.ok() ? left_status : right_it->init_status();
@@ -1620,6 +1724,16 @@ void filter_result_iterator_t::reset(const bool& override_timeout) {
         seq_id = bool_iterator.seq_id;
         validity = valid;
         return;
+    } else if (f.is_integer() || f.is_float()) {
+        numeric_iterator.reset();
+        if (!numeric_iterator.is_valid) {
+            validity = invalid;
+            return;
+        }
+
+        seq_id = numeric_iterator.seq_id;
+        validity = valid;
+        return;
     } else if (f.is_string()) {
         for (uint32_t i = 0; i < posting_lists.size(); i++) {
             auto const& plists = posting_lists[i];
@@ -1776,10 +1890,21 @@ filter_result_iterator_t::filter_result_iterator_t(const std::string& collection
         timeout_info = std::make_unique<filter_result_iterator_timeout_info>(search_begin, search_stop);
     }
 
+    // The sub-expressions are estimated bottom-up once, before any of them is planned.
+    filter_estimates_t estimates;
+    if (filter_node->isOperator) {
+        estimate_filter_ids_length(filter_node, estimates);
+    }
+
+    build(estimates);
+}
+
+void filter_result_iterator_t::build(const filter_estimates_t& estimates) {
+    auto begin = std::chrono::steady_clock::now();
+
     // Generate the iterator tree and then initialize each node.
     if (filter_node->isOperator) {
-        left_it = new filter_result_iterator_t(collection_name, index, filter_node->left);
-        right_it = new filter_result_iterator_t(collection_name, index, filter_node->right);
+        init_sub_iterators(estimates);
     }
 
     init();
@@ -1787,6 +1912,196 @@ filter_result_iterator_t::filter_result_iterator_t(const std::string& collection
     if (!validity) {
         this->approx_filter_ids_length = 0;
     }
+
+    init_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+}
+
+bool filter_result_iterator_t::can_skip(filter_node_t const* const node) const {
+    if (node == nullptr) {
+        return true;
+    } else if (node->isOperator) {
+        return can_skip(node->left) && can_skip(node->right);
+    }
+
+    // Reference filters and filters on non-indexed fields report errors during their evaluation.
+    auto const& a_filter = node->filter_exp;
+    return a_filter.referenced_collection_name.empty() &&
+            (a_filter.field_name == "id" || index->field_is_indexed(a_filter.field_name));
+}
+
+uint32_t filter_result_iterator_t::estimate_filter_ids_length(filter_node_t const* const node,
+                                                              filter_estimates_t& estimates) const {
+    uint32_t ids_length = 0;
+
+    if (node == nullptr) {
+        ids_length = 0;
+    } else if (node->isOperator) {
+        const uint32_t num_docs = index->seq_ids->num_ids();
+        auto const left_estimate = estimate_filter_ids_length(node->left, estimates),
+                    right_estimate = estimate_filter_ids_length(node->right, estimates);
+
+        ids_length = node->filter_operator == AND ? std::min(left_estimate, right_estimate) :
+                                                    std::min<uint64_t>(num_docs, (uint64_t) left_estimate + right_estimate);
+    } else {
+        ids_length = estimate_leaf_filter_ids_length(node);
+    }
+
+    estimates[node] = ids_length;
+    return ids_length;
+}
+
+uint32_t filter_result_iterator_t::estimate_leaf_filter_ids_length(filter_node_t const* const node) const {
+#ifdef TEST_BUILD
+    num_leaf_estimates++;
+#endif
+
+    const uint32_t num_docs = index->seq_ids->num_ids();
+    const filter& a_filter = node->filter_exp;
+    uint64_t ids_length = 0;
+
+    if (!a_filter.referenced_collection_name.empty()) {
+        ids_length = num_docs;
+    } else if (a_filter.field_name == "id") {
+        ids_length = a_filter.values.size();
+    } else if (!index->field_is_indexed(a_filter.field_name)) {
+        ids_length = num_docs;
+    } else if (auto const& f = index->search_schema.at(a_filter.field_name);
+                f.is_integer() || f.is_float() || f.is_bool()) {
+        auto const to_int64 = [&f](const std::string& filter_value) -> int64_t {
+            if (f.is_float()) {
+                return Index::float_to_int64_t((float) std::atof(filter_value.c_str()));
+            }
+            return f.is_bool() ? (filter_value == "1" ? 1 : 0) : (int64_t) std::stol(filter_value);
+        };
+
+        for (size_t fi = 0; fi < a_filter.values.size(); fi++) {
+            auto const& comparator = a_filter.comparators[fi];
+            auto const value = to_int64(a_filter.values[fi]);
+            const bool is_range = comparator == RANGE_INCLUSIVE && fi + 1 < a_filter.values.size();
+            const int64_t range_end_value = is_range ? to_int64(a_filter.values[++fi]) : value;
+            uint32_t value_ids_length = 0;
+
+            if (f.range_index) {
+                auto const& trie = index->range_index.at(a_filter.field_name);
+                NumericTrie::iterator_t iterator;
+
+                if (is_range) {
+                    iterator = trie->search_range(value, true, range_end_value, true);
+                } else if (comparator == EQUALS || comparator == NOT_EQUALS) {
+                    iterator = trie->search_equal_to(value);
+                } else if (comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
+                    iterator = trie->search_greater_than(value, comparator == GREATER_THAN_EQUALS);
+                } else if (comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
+                    iterator = trie->search_less_than(value, comparator == LESS_THAN_EQUALS);
+                }
+
+                value_ids_length = iterator.approx_filter_ids_length;
+            } else {
+                auto const& num_tree = index->numerical_index.at(a_filter.field_name);
+
+                if (is_range) {
+                    num_tree->approx_range_inclusive_search_count(value, range_end_value, value_ids_length);
+                } else {
+                    value_ids_length = num_tree->approx_search_count(comparator == NOT_EQUALS ? EQUALS : comparator,
+                                                                     value);
+                }
+            }
+
+            ids_length += comparator == NOT_EQUALS ? num_docs - std::min(value_ids_length, num_docs) : value_ids_length;
+        }
+    } else if (f.is_string()) {
+        art_tree* t = index->search_index.at(a_filter.field_name);
+
+        for (const std::string& filter_value : a_filter.values) {
+            if (filter_value.size() > 1 && filter_value.back() == '*') {
+                // Prefix matches are only known after searching the tokens.
+                ids_length += num_docs;
+                continue;
+            }
+
+            Tokenizer tokenizer(filter_value, true, false, f.locale, index->symbols_to_index, index->token_separators);
+
+            std::string str_token;
+            size_t token_index = 0;
+            uint32_t value_ids_length = UINT32_MAX;
+
+            // Tokens of a filter value get AND.
+            while (tokenizer.next(str_token, token_index)) {
+                if (str_token.size() > 100) {
+                    str_token.erase(100);
+                }
+
+                art_leaf* leaf = (art_leaf *) art_search(t, (const unsigned char*) str_token.c_str(),
+                                                         str_token.length()+1);
+                value_ids_length = std::min(value_ids_length, leaf == nullptr ? 0 : posting_t::num_ids(leaf->values));
+            }
+
+            ids_length += value_ids_length == UINT32_MAX ? 0 : value_ids_length;
+        }
+    } else {
+        ids_length = num_docs;
+    }
+
+    ids_length = std::min<uint64_t>(ids_length, num_docs);
+    return a_filter.apply_not_equals ? num_docs - ids_length : ids_length;
+}
+
+void filter_result_iterator_t::init_sub_iterators(const filter_estimates_t& estimates) {
+    auto const new_sub_iterator = [this, &estimates](filter_node_t const* const node,
+                                                     const uint32_t& estimated_ids_length,
+                                                     const bool& prefer_iteration) {
+        auto it = new filter_result_iterator_t();
+        it->collection_name = collection_name;
+        it->index = index;
+        it->filter_node = node;
+        it->estimated_ids_length = estimated_ids_length;
+        it->prefer_iteration = prefer_iteration;
+
+        if (node == nullptr) {
+            it->validity = invalid;
+        } else {
+            it->build(estimates);
+        }
+
+        return it;
+    };
+
+    auto const left_estimate = estimates.at(filter_node->left),
+                right_estimate = estimates.at(filter_node->right);
+
+    if (filter_node->filter_operator == OR) {
+        left_it = new_sub_iterator(filter_node->left, left_estimate, false);
+        right_it = new_sub_iterator(filter_node->right, right_estimate, false);
+        return;
+    }
+
+    const bool is_left_first = left_estimate <= right_estimate;
+    auto& first_it = is_left_first ? left_it : right_it;
+    auto& second_it = is_left_first ? right_it : left_it;
+    auto const second_node = is_left_first ? filter_node->right : filter_node->left;
+    auto const second_estimate = is_left_first ? right_estimate : left_estimate;
+
+    first_it = new_sub_iterator(is_left_first ? filter_node->left : filter_node->right,
+                                is_left_first ? left_estimate : right_estimate, false);
+
+    if (first_it->validity == invalid && first_it->status.ok() && can_skip(second_node)) {
+        second_it = new filter_result_iterator_t();
+        second_it->collection_name = collection_name;
+        second_it->index = index;
+        second_it->filter_node = second_node;
+        second_it->estimated_ids_length = second_estimate;
+        second_it->is_skipped = true;
+        second_it->is_filter_result_initialized = true;
+        second_it->validity = invalid;
+        return;
+    }
+
+    // Iterating the larger side only looks up the ids around the matches of the smaller side, instead of collecting
+    // all of its ids.
+    second_it = new_sub_iterator(second_node, second_estimate,
+                                 (uint64_t) first_it->approx_filter_ids_length * prefer_iteration_selectivity_ratio <
+                                 second_estimate);
 }
 
 filter_result_iterator_t::~filter_result_iterator_t() {
@@ -1839,11 +2154,57 @@ filter_result_iterator_t& filter_result_iterator_t::operator=(filter_result_iter
     status = std::move(obj.status);
     is_filter_result_initialized = obj.is_filter_result_initialized;
 
+    numeric_iterator = std::move(obj.numeric_iterator);
+
     approx_filter_ids_length = obj.approx_filter_ids_length;
+    init_time_us = obj.init_time_us;
+    estimated_ids_length = obj.estimated_ids_length;
+    is_skipped = obj.is_skipped;
 
     return *this;
 }
 
+nlohmann::json filter_result_iterator_t::get_profile() const {
+    nlohmann::json node;
+
+    if (filter_node == nullptr) {
+        node["ids"] = approx_filter_ids_length;
+    } else if (filter_node->isOperator) {
+        node["operator"] = filter_node->filter_operator == AND ? "AND" : "OR";
+    } else {
+        const auto& a_filter = filter_node->filter_exp;
+        node["field"] = a_filter.field_name;
+        node["values"] = a_filter.values;
+        if (a_filter.apply_not_equals) {
+            node["not_equals"] = true;
+        }
+        if (!a_filter.referenced_collection_name.empty()) {
+            node["referenced_collection"] = a_filter.referenced_collection_name;
+        }
+    }
+
+    if (estimated_ids_length != UINT32_MAX) {
+        node["estimated_ids_length"] = estimated_ids_length;
+    }
+
+    node["approx_filter_ids_length"] = approx_filter_ids_length;
+    node["computed"] = is_filter_result_initialized;
+    node["plan"] = is_skipped ? "skipped" : approx_filter_ids_length == 0 ? "empty" :
+                    is_filter_result_initialized ? "materialized" : "iterated";
+    node["time_us"] = init_time_us;
+
+    if (left_it != nullptr || right_it != nullptr) {
+        node["children"] = nlohmann::json::array();
+        for (const auto child: {left_it, right_it}) {
+            if (child != nullptr) {
+                node["children"].push_back(child->get_profile());
+            }
+        }
+    }
+
+    return node;
+}
+
 void filter_result_iterator_t::get_n_ids(const uint32_t& n, filter_result_t*& result, const bool& override_timeout) {
     if (!is_filter_result_initialized) {
         return;
@@ -2058,6 +2419,17 @@ void filter_result_iterator_t::compute_iterators() {
         size_t result_size = 0;
         num_tree->search(a_filter.comparators[0], bool_int64, &filter_result.docs, result_size);
         filter_result.count = result_size;
+    } else if ((f.is_integer() || f.is_float()) && numeric_iterator.approx_filter_ids_length > 0) {
+        std::vector<uint32_t> numeric_ids;
+        numeric_ids.reserve(numeric_iterator.approx_filter_ids_length);
+
+        for (numeric_iterator.reset(); numeric_iterator.is_valid; numeric_iterator.next()) {
+            numeric_ids.push_back(numeric_iterator.seq_id);
+        }
+
+        filter_result.count = numeric_ids.size();
+        filter_result.docs = new uint32_t[numeric_ids.size()];
+        std::copy(numeric_ids.begin(), numeric_ids.end(), filter_result.docs);
     } else if (f.is_string()) {
         // Resetting posting_list_iterators.
         for (uint32_t i = 0; i < posting_lists.size(); i++) {
@@ -0,0 +1,161 @@
+#include "geo_point_verifier.h"
+#include <cmath>
+#include <s2/s2latlng.h>
+#include "field.h"
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#else
+#include <sse2neon.h>
+#endif
+
+// packed longitudes lie within [-180, 180] degrees
+static constexpr int32_t MAX_LNG_MICRO_DEGREES = 180'000'000;
+
+static double to_micro_degrees(const double radians) {
+    return radians * (180.0 / M_PI) * 1000000;
+}
+
+static inline __m128i in_box(const __m128i& lats, const __m128i& lngs,
+                             const __m128i& lat_lo, const __m128i& lat_hi,
+                             const __m128i& lng_lo, const __m128i& lng_hi) {
+    __m128i mask = _mm_and_si128(_mm_cmpgt_epi32(lats, lat_lo), _mm_cmpgt_epi32(lat_hi, lats));
+    mask = _mm_and_si128(mask, _mm_cmpgt_epi32(lngs, lng_lo));
+    return _mm_and_si128(mask, _mm_cmpgt_epi32(lng_hi, lngs));
+}
+
+geo_point_verifier_t::geo_point_verifier_t(const S2Cap& cap): region(&cap) {
+    set_outer_bounds(cap.GetRectBound());
+    set_inner_bounds(cap);
+}
+
+geo_point_verifier_t::geo_point_verifier_t(const S2Loop& loop): region(&loop) {
+    set_outer_bounds(loop.GetRectBound());
+}
+
+void geo_point_verifier_t::set_outer_bounds(const S2LatLngRect& rect_bound) {
+    if(rect_bound.is_empty()) {
+        return;
+    }
+
+    // the rect bound is already conservative: the extra micro-degrees absorb the rounding of the conversion
+    outer_lat_lo = int32_t(std::floor(to_micro_degrees(rect_bound.lat().lo()))) - 2;
+    outer_lat_hi = int32_t(std::ceil(to_micro_degrees(rect_bound.lat().hi()))) + 2;
+
+    if(rect_bound.lng().is_full() || rect_bound.lng().is_inverted()) {
+        // regions spanning the antimeridian are only bounded by latitude
+        outer_lng_lo = -MAX_LNG_MICRO_DEGREES - 1;
+        outer_lng_hi = MAX_LNG_MICRO_DEGREES + 1;
+    } else {
+        outer_lng_lo = int32_t(std::floor(to_micro_degrees(rect_bound.lng().lo()))) - 2;
+        outer_lng_hi = int32_t(std::ceil(to_micro_degrees(rect_bound.lng().hi()))) + 2;
+    }
+}
+
+void geo_point_verifier_t::set_inner_bounds(const S2Cap& cap) {
+    // The haversine of the distance between the center and a point that is (d_lat, d_lng) away from it is
+    //     hav(d_lat) + cos(lat_center) * cos(lat_point) * hav(d_lng)
+    // The box gives each of the two terms half of the cap's haversine, after shaving off a margin that covers the
+    // floating point error of S2's own containment check.
+
+    const double chord_length2 = cap.radius().length2();
+    if(cap.is_empty() || chord_length2 >= 2) {
+        return;
+    }
+
+    const double hav_radius = chord_length2 / 4 * (1 - 1e-6) - 1e-15;
+    if(hav_radius <= 0) {
+        return;
+    }
+
+    const S2LatLng center(cap.center());
+    const double half_hav_radius = hav_radius / 2;
+
+    const double d_lat = 2 * std::asin(std::sqrt(half_hav_radius));
+    const double lat_lo = center.lat().radians() - d_lat;
+    const double lat_hi = center.lat().radians() + d_lat;
+    if(lat_lo <= -M_PI_2 || lat_hi >= M_PI_2) {
+        return;
+    }
+
+    const double max_cos_lat = (lat_lo <= 0 && lat_hi >= 0) ? 1.0 :
+                               std::cos(std::min(std::abs(lat_lo), std::abs(lat_hi)));
+    const double hav_d_lng = half_hav_radius / (std::cos(center.lat().radians()) * max_cos_lat);
+    if(hav_d_lng >= 1) {
+        return;
+    }
+
+    const double d_lng = 2 * std::asin(std::sqrt(hav_d_lng));
+    const double lng_lo = center.lng().radians() - d_lng;
+    const double lng_hi = center.lng().radians() + d_lng;
+    if(lng_lo <= -M_PI || lng_hi >= M_PI) {
+        return;
+    }
+
+    inner_lat_lo = int32_t(std::ceil(to_micro_degrees(lat_lo)));
+    inner_lat_hi = int32_t(std::floor(to_micro_degrees(lat_hi)));
+    inner_lng_lo = int32_t(std::ceil(to_micro_degrees(lng_lo)));
+    inner_lng_hi = int32_t(std::floor(to_micro_degrees(lng_hi)));
+}
+
+bool geo_point_verifier_t::contains_exact(const int64_t packed_lat_lng) const {
+    S2LatLng lat_lng;
+    GeoPoint::unpack_lat_lng(packed_lat_lng, lat_lng);
+    return region->Contains(lat_lng.ToPoint());
+}
+
+int geo_point_verifier_t::classify(const int64_t packed_lat_lng) const {
+    const auto lat = int32_t(uint64_t(packed_lat_lng) >> 32);
+    const auto lng = int32_t(uint64_t(packed_lat_lng) & 0xFFFFFFFF);
+
+    if(lat <= outer_lat_lo || lat >= outer_lat_hi || lng <= outer_lng_lo || lng >= outer_lng_hi) {
+        return 0;
+    }
+
+    if(lat > inner_lat_lo && lat < inner_lat_hi && lng > inner_lng_lo && lng < inner_lng_hi) {
+        return 1;
+    }
+
+    return -1;
+}
+
+void geo_point_verifier_t::verify(const int64_t* packed_lat_lngs, const size_t num_points, uint8_t* matches) const {
+    const __m128i outer_lat_lo_v = _mm_set1_epi32(outer_lat_lo), outer_lat_hi_v = _mm_set1_epi32(outer_lat_hi);
+    const __m128i outer_lng_lo_v = _mm_set1_epi32(outer_lng_lo), outer_lng_hi_v = _mm_set1_epi32(outer_lng_hi);
+    const __m128i inner_lat_lo_v = _mm_set1_epi32(inner_lat_lo), inner_lat_hi_v = _mm_set1_epi32(inner_lat_hi);
+    const __m128i inner_lng_lo_v = _mm_set1_epi32(inner_lng_lo), inner_lng_hi_v = _mm_set1_epi32(inner_lng_hi);
+
+    size_t i = 0;
+
+    for(; i + 4 <= num_points; i += 4) {
+        // every packed point holds the latitude in its upper and the longitude in its lower 32 bits:
+        // shuffle 4 of them into a vector of latitudes and a vector of longitudes
+        __m128i p01 = _mm_loadu_si128((const __m128i*) (packed_lat_lngs + i));
+        __m128i p23 = _mm_loadu_si128((const __m128i*) (packed_lat_lngs + i + 2));
+        p01 = _mm_shuffle_epi32(p01, _MM_SHUFFLE(3, 1, 2, 0));
+        p23 = _mm_shuffle_epi32(p23, _MM_SHUFFLE(3, 1, 2, 0));
+
+        const __m128i lngs = _mm_unpacklo_epi64(p01, p23);
+        const __m128i lats = _mm_unpackhi_epi64(p01, p23);
+
+        const int outer_mask = _mm_movemask_ps(_mm_castsi128_ps(
+                in_box(lats, lngs, outer_lat_lo_v, outer_lat_hi_v, outer_lng_lo_v, outer_lng_hi_v)));
+        const int inner_mask = _mm_movemask_ps(_mm_castsi128_ps(
+                in_box(lats, lngs, inner_lat_lo_v, inner_lat_hi_v, inner_lng_lo_v, inner_lng_hi_v)));
+
+        for(size_t lane = 0; lane < 4; lane++) {
+            if(((outer_mask >> lane) & 1) == 0) {
+                matches[i + lane] = 0;
+            } else if((inner_mask >> lane) & 1) {
+                matches[i + lane] = 1;
+            } else {
+                matches[i + lane] = contains_exact(packed_lat_lngs[i + lane]);
+            }
+        }
+    }
+
+    for(; i < num_points; i++) {
+        const int result = classify(packed_lat_lngs[i]);
+        matches[i] = (result == -1) ? contains_exact(packed_lat_lngs[i]) : result;
+    }
+}
@@ -7,6 +7,14 @@
 std::string HttpClient::api_key = "";
 std::string HttpClient::ca_cert_path = "";
 
+std::mutex HttpClient::idle_handles_mutex;
+std::vector<CURL*> HttpClient::idle_handles;
+CURLSH* HttpClient::share_handle = nullptr;
+std::mutex HttpClient::share_mutexes[CURL_LOCK_DATA_LAST];
+std::atomic<uint64_t> HttpClient::num_requests{0};
+std::atomic<uint64_t> HttpClient::num_reused_handles{0};
+std::atomic<uint64_t> HttpClient::num_reused_connections{0};
+
 struct client_state_t: public req_state_t {
     CURL* curl;
 
@@ -166,6 +174,77 @@ void HttpClient::init(const std::string &api_key) {
             break;
         }
     }
+
+    if(share_handle == nullptr) {
+        share_handle = curl_share_init();
+        if(share_handle != nullptr) {
+            curl_share_setopt(share_handle, CURLSHOPT_LOCKFUNC, HttpClient::share_lock);
+            curl_share_setopt(share_handle, CURLSHOPT_UNLOCKFUNC, HttpClient::share_unlock);
+            curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            // The connection cache is not shared: libcurl does not support sharing it between concurrent threads.
+            // Each pooled handle keeps its own connections alive across requests instead.
+        }
+    }
+}
+
+void HttpClient::dispose() {
+    std::unique_lock<std::mutex> lock(idle_handles_mutex);
+    for(CURL* curl: idle_handles) {
+        curl_easy_cleanup(curl);
+    }
+    idle_handles.clear();
+    lock.unlock();
+
+    if(share_handle != nullptr) {
+        curl_share_cleanup(share_handle);
+        share_handle = nullptr;
+    }
+}
+
+void HttpClient::share_lock(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr) {
+    share_mutexes[data].lock();
+}
+
+void HttpClient::share_unlock(CURL* curl, curl_lock_data data, void* userptr) {
+    share_mutexes[data].unlock();
+}
+
+CURL* HttpClient::acquire_handle() {
+    {
+        std::lock_guard<std::mutex> lock(idle_handles_mutex);
+        if(!idle_handles.empty()) {
+            CURL* curl = idle_handles.back();
+            idle_handles.pop_back();
+            num_reused_handles++;
+            // clears all options but keeps the connection, DNS and TLS session caches of the handle
+            curl_easy_reset(curl);
+            return curl;
+        }
+    }
+
+    return curl_easy_init();
+}
+
+void HttpClient::release_handle(CURL* curl) {
+    std::unique_lock<std::mutex> lock(idle_handles_mutex);
+    if(idle_handles.size() < MAX_IDLE_HANDLES) {
+        idle_handles.push_back(curl);
+        return;
+    }
+
+    lock.unlock();
+    curl_easy_cleanup(curl);
+}
+
+void HttpClient::get_pool_stats(nlohmann::json& result) {
+    const uint64_t requests = num_requests;
+    const uint64_t reused_connections = num_reused_connections;
+
+    result["http_client_requests"] = requests;
+    result["http_client_reused_handles"] = num_reused_handles.load();
+    result["http_client_reused_connections"] = reused_connections;
+    result["http_client_connection_reuse_rate"] = requests == 0 ? 0.0 : double(reused_connections) / requests;
 }
 
 long HttpClient::perform_curl(CURL *curl, std::map<std::string, std::string>& res_headers, struct curl_slist *chunk,
@@ -178,6 +257,7 @@ long HttpClient::perform_curl(CURL *curl, std::map<std::string, std::string>& re
 
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, chunk);
     CURLcode res = curl_easy_perform(curl);
+    num_requests++;
 
     if (res != CURLE_OK) {
         char* url = nullptr;
@@ -199,7 +279,7 @@ long HttpClient::perform_curl(CURL *curl, std::map<std::string, std::string>& re
             status_code = 500;
         }
 
-        curl_easy_cleanup(curl);
+        release_handle(curl);
         curl_slist_free_all(chunk);
 
         return status_code;
@@ -210,7 +290,12 @@ long HttpClient::perform_curl(CURL *curl, std::map<std::string, std::string>& re
 
     extract_response_headers(curl, res_headers);
 
-    curl_easy_cleanup(curl);
+    long num_connects = 0;
+    if(curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &num_connects) == CURLE_OK && num_connects == 0) {
+        num_reused_connections++;
+    }
+
+    release_handle(curl);
     curl_slist_free_all(chunk);
 
     return http_code == 0 ? 500 : http_code;
@@ -448,7 +533,7 @@ CURL *HttpClient::init_curl_async(const std::string& url, deferred_req_res_t* re
 }
 
 CURL *HttpClient::init_curl(const std::string& url, std::string& response, const size_t timeout_ms) {
-    CURL *curl = curl_easy_init();
+    CURL *curl = acquire_handle();
 
     if(curl == nullptr) {
         nlohmann::json res;
@@ -475,6 +560,10 @@ CURL *HttpClient::init_curl(const std::string& url, std::string& response, const
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, HttpClient::curl_write);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
+    if(share_handle != nullptr) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_handle);
+    }
+
     return curl;
 }
 
@@ -1,6 +1,7 @@
 #include "id_list.h"
 #include <algorithm>
 #include "for.h"
+#include "memory_usage.h"
 
 /* block_t operations */
 
@@ -647,6 +648,20 @@ size_t id_list_t::num_ids() const {
     return ids_length;
 }
 
+size_t id_list_t::memory_used() const {
+    size_t bytes = sizeof(id_list_t) + tree_map_memory_used(id_block_map);
+
+    for(const block_t* block = &root_block; block != nullptr; block = block->next) {
+        if(block != &root_block) {
+            bytes += sizeof(block_t);
+        }
+
+        bytes += block->ids.getSizeInBytes();
+    }
+
+    return bytes;
+}
+
 bool id_list_t::contains(uint32_t id) {
     const auto it = id_block_map.lower_bound(id);
 
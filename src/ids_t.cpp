@@ -118,6 +118,10 @@ uint32_t compact_id_list_t::num_ids() const {
     return length;
 }
 
+size_t compact_id_list_t::memory_used() const {
+    return sizeof(compact_id_list_t) + (capacity * sizeof(uint32_t));
+}
+
 uint32_t compact_id_list_t::first_id() {
     if(length == 0) {
         return 0;
@@ -262,6 +266,16 @@ uint32_t ids_t::num_ids(const void* obj) {
     }
 }
 
+size_t ids_t::memory_used(const void* obj) {
+    if(IS_COMPACT_IDS(obj)) {
+        compact_id_list_t* list = COMPACT_IDS_PTR(obj);
+        return list->memory_used();
+    } else {
+        id_list_t* list = (id_list_t*)(obj);
+        return list->memory_used();
+    }
+}
+
 uint32_t ids_t::first_id(const void* obj) {
     if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
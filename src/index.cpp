@@ -5,6 +5,7 @@
 #include <chrono>
 #include <set>
 #include <unordered_map>
+#include <deque>
 #include <random>
 #include <art.h>
 #include <array_utils.h>
@@ -15,6 +16,7 @@
 #include <s2/s2latlng.h>
 #include <s2/s2region_term_indexer.h>
 #include <s2/s2cap.h>
+#include <s2/s2earth.h>
 #include <s2/s2loop.h>
 #include <posting.h>
 #include <thread_local_vars.h>
@@ -24,6 +26,9 @@
 #include "logger.h"
 #include "validator.h"
 #include <collection_manager.h>
+#include <app_metrics.h>
+#include <search_profile.h>
+#include <memory_usage.h>
 
 #define RETURN_CIRCUIT_BREAKER if((std::chrono::duration_cast<std::chrono::microseconds>( \
                   std::chrono::system_clock::now().time_since_epoch()).count() - search_begin_us) > search_stop_us) { \
@@ -146,6 +151,34 @@ Index::Index(const std::string& name, const uint32_t collection_id, const Store*
     num_documents = 0;
 }
 
+void typo_candidate_cache_t::get_nodes(const std::string& tree_name, const art_tree* t, const unsigned char* term,
+                                       int term_len, int cost, bool prefix, std::vector<const art_node*>& nodes) {
+    std::string key = tree_name;
+    key += '\x1f';
+    key.append(reinterpret_cast<const char*>(term), term_len);
+    key += '\x1f';
+    key += std::to_string(cost);
+    key += prefix ? "p" : "x";
+
+    {
+        std::unique_lock lk(mutex);
+        if(entries.contains(key)) {
+            const auto& entry = entries.lookup(key);
+            if(entry.tree == t && entry.version == t->version) {
+                nodes = entry.nodes;
+                return ;
+            }
+        }
+    }
+
+    art_fuzzy_nodes(t, term, term_len, cost, cost, prefix, nodes);
+
+    if(nodes.size() <= MAX_CACHED_NODES) {
+        std::unique_lock lk(mutex);
+        entries.insert(key, entry_t{t, t->version, nodes});
+    }
+}
+
 Index::~Index() {
     std::unique_lock lock(mutex);
 
@@ -493,18 +526,26 @@ void Index::validate_and_preprocess(Index *index,
                                 index_rec.new_doc, index_rec.del_doc);
 
                 if(generate_embeddings) {
-                    for(auto& field: index_rec.doc.items()) {
-                        for(auto& embedding_field : embedding_fields) {
-                            if(!embedding_field.embed[fields::from].is_null()) {
-                                auto embed_from_vector = embedding_field.embed[fields::from].get<std::vector<std::string>>();
-                                for(auto& embed_from: embed_from_vector) {
-                                    if(embed_from == field.key()) {
-                                        records_to_embed.push_back(&index_rec);
-                                        break;
-                                    }
+                    // unchanged values have been scrubbed from the update doc, so only changed sources remain
+                    bool embed_source_changed = false;
+                    for(auto& embedding_field : embedding_fields) {
+                        if(!embedding_field.embed[fields::from].is_null()) {
+                            auto embed_from_vector = embedding_field.embed[fields::from].get<std::vector<std::string>>();
+                            for(auto& embed_from: embed_from_vector) {
+                                if(index_rec.doc.contains(embed_from)) {
+                                    embed_source_changed = true;
+                                    break;
                                 }
                             }
                         }
+
+                        if(embed_source_changed) {
+                            break;
+                        }
+                    }
+
+                    if(embed_source_changed) {
+                        records_to_embed.push_back(&index_rec);
                     }
                 }
             } else {
@@ -576,6 +617,8 @@ batch_memory_index(Index *index,
     // local is need to propogate the thread local inside threads launched below
     auto local_write_log_index = write_log_index;
 
+    auto validate_begin = std::chrono::high_resolution_clock::now();
+
     for(size_t thread_id = 0; thread_id < num_threads && batch_index < iter_batch.size(); thread_id++) {
         size_t batch_len = window_size;
 
@@ -625,6 +668,10 @@ batch_memory_index(Index *index,
         }
     }
 
+    auto index_begin = std::chrono::high_resolution_clock::now();
+    AppMetrics::get_instance().record_write_stage(WRITE_STAGE_VALIDATE,
+        std::chrono::duration_cast<std::chrono::microseconds>(index_begin - validate_begin).count());
+
     num_queued = num_processed = 0;
     std::unique_lock ulock(index->mutex);
 
@@ -661,9 +708,98 @@ batch_memory_index(Index *index,
         cv_process.wait(lock_process, [&](){ return num_processed == num_queued; });
     }
 
+    AppMetrics::get_instance().record_write_stage(WRITE_STAGE_INDEX,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - index_begin).count());
+
     return num_indexed;
 }
 
+void Index::bulk_build_vector_index(const field& afield, std::vector<index_record>& iter_batch) {
+    auto& field_vector_index = vector_index.at(afield.name);
+    auto vec_index = field_vector_index->vecdex;
+
+    // Pool tasks and this thread claim chunks of records until none are left. Tasks that start late find no work,
+    // so the build never waits on a busy pool: this thread alone can add every point.
+    struct bulk_build_state_t {
+        std::atomic<size_t> next_chunk = 0;
+        size_t num_chunks = 0;
+        std::atomic<size_t> num_points = 0;
+        std::mutex m;
+        std::condition_variable cv;
+        size_t num_chunks_done = 0;
+    };
+
+    auto state = std::make_shared<bulk_build_state_t>();
+    state->num_chunks = (iter_batch.size() + hnsw_index_t::BULK_BUILD_CHUNK_SIZE - 1) / hnsw_index_t::BULK_BUILD_CHUNK_SIZE;
+
+    auto build = [state, &afield, vec_index, &records = iter_batch]() {
+        size_t chunk;
+        while((chunk = state->next_chunk++) < state->num_chunks) {
+            const size_t begin = chunk * hnsw_index_t::BULK_BUILD_CHUNK_SIZE;
+            const size_t end = std::min(begin + hnsw_index_t::BULK_BUILD_CHUNK_SIZE, records.size());
+
+            for(size_t i = begin; i < end; i++) {
+                auto& record = records[i];
+                if(record.doc.count(afield.name) == 0 || !record.indexed.ok()) {
+                    continue;
+                }
+
+                try {
+                    const std::vector<float>& float_vals = record.doc[afield.name].get<std::vector<float>>();
+                    if(float_vals.size() != afield.num_dim) {
+                        record.index_failure(400, "Vector size mismatch.");
+                    } else {
+                        if(afield.vec_dist == cosine) {
+                            std::vector<float> normalized_vals(afield.num_dim);
+                            hnsw_index_t::normalize_vector(float_vals, normalized_vals);
+                            vec_index->addPoint(normalized_vals.data(), (size_t)record.seq_id, true);
+                        } else {
+                            vec_index->addPoint(float_vals.data(), (size_t)record.seq_id, true);
+                        }
+                        state->num_points++;
+                    }
+                } catch(const std::exception &e) {
+                    record.index_failure(400, e.what());
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(state->m);
+            if(++state->num_chunks_done == state->num_chunks) {
+                state->cv.notify_one();
+            }
+        }
+    };
+
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    const size_t num_threads = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1),
+                                                state->num_chunks);
+    for(size_t thread_id = 1; thread_id < num_threads; thread_id++) {
+        thread_pool->enqueue(build);
+    }
+
+    build();
+
+    {
+        std::unique_lock<std::mutex> lock(state->m);
+        state->cv.wait(lock, [&]() { return state->num_chunks_done == state->num_chunks; });
+    }
+
+    const uint64_t time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - begin).count();
+
+    const size_t prev_points = field_vector_index->num_bulk_built_points.fetch_add(state->num_points);
+    const uint64_t total_time_us = (field_vector_index->bulk_build_time_us += time_us);
+    const size_t total_points = prev_points + state->num_points;
+
+    if(total_points / hnsw_index_t::BULK_BUILD_REPORT_INTERVAL != prev_points / hnsw_index_t::BULK_BUILD_REPORT_INTERVAL) {
+        LOG(INFO) << "Bulk built " << total_points << " vectors of field " << afield.name << " using " << num_threads
+                  << " threads, " << (total_points * 1000 * 1000 / std::max<uint64_t>(total_time_us, 1))
+                  << " vectors/s.";
+    }
+}
+
 void Index::index_field_in_memory(const field& afield, std::vector<index_record>& iter_batch) {
     // indexes a given field of all documents in the batch
 
@@ -838,56 +974,76 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
         if (afield.type == field_types::INT32) {
             auto num_tree = afield.range_index ? nullptr : numerical_index.at(afield.name);
             auto trie = afield.range_index ? range_index.at(afield.name) : nullptr;
-            iterate_and_index_numerical_field(iter_batch, afield, [&afield, num_tree, trie]
+            std::vector<std::pair<int64_t, uint32_t>> value_ids;
+            iterate_and_index_numerical_field(iter_batch, afield, [&afield, &value_ids, trie]
                     (const index_record& record, uint32_t seq_id) {
                 int32_t value = record.doc[afield.name].get<int32_t>();
                 if (afield.range_index) {
                     trie->insert(value, seq_id);
                 } else {
-                    num_tree->insert(value, seq_id);
+                    value_ids.emplace_back(value, seq_id);
                 }
             });
+
+            if (num_tree != nullptr) {
+                num_tree->insert_batch(value_ids);
+            }
         }
 
         else if(afield.type == field_types::INT64) {
             auto num_tree = afield.range_index ? nullptr : numerical_index.at(afield.name);
             auto trie = afield.range_index ? range_index.at(afield.name) : nullptr;
-            iterate_and_index_numerical_field(iter_batch, afield, [&afield, num_tree, trie]
+            std::vector<std::pair<int64_t, uint32_t>> value_ids;
+            iterate_and_index_numerical_field(iter_batch, afield, [&afield, &value_ids, trie]
                     (const index_record& record, uint32_t seq_id) {
                 int64_t value = record.doc[afield.name].get<int64_t>();
                 if (afield.range_index) {
                     trie->insert(value, seq_id);
                 } else {
-                    num_tree->insert(value, seq_id);
+                    value_ids.emplace_back(value, seq_id);
                 }
             });
+
+            if (num_tree != nullptr) {
+                num_tree->insert_batch(value_ids);
+            }
         }
 
         else if(afield.type == field_types::FLOAT) {
             auto num_tree = afield.range_index ? nullptr : numerical_index.at(afield.name);
             auto trie = afield.range_index ? range_index.at(afield.name) : nullptr;
-            iterate_and_index_numerical_field(iter_batch, afield, [&afield, num_tree, trie]
+            std::vector<std::pair<int64_t, uint32_t>> value_ids;
+            iterate_and_index_numerical_field(iter_batch, afield, [&afield, &value_ids, trie]
                     (const index_record& record, uint32_t seq_id) {
                 float fvalue = record.doc[afield.name].get<float>();
                 int64_t value = float_to_int64_t(fvalue);
                 if (afield.range_index) {
                     trie->insert(value, seq_id);
                 } else {
-                    num_tree->insert(value, seq_id);
+                    value_ids.emplace_back(value, seq_id);
                 }
             });
+
+            if (num_tree != nullptr) {
+                num_tree->insert_batch(value_ids);
+            }
         } else if(afield.type == field_types::BOOL) {
             auto num_tree = afield.range_index ? nullptr : numerical_index.at(afield.name);
             auto trie = afield.range_index ? range_index.at(afield.name) : nullptr;
-            iterate_and_index_numerical_field(iter_batch, afield, [&afield, num_tree, trie]
+            std::vector<std::pair<int64_t, uint32_t>> value_ids;
+            iterate_and_index_numerical_field(iter_batch, afield, [&afield, &value_ids, trie]
                     (const index_record& record, uint32_t seq_id) {
                 bool value = record.doc[afield.name].get<bool>();
                 if (afield.range_index) {
                     trie->insert(value, seq_id);
                 } else {
-                    num_tree->insert(value, seq_id);
+                    value_ids.emplace_back(value, seq_id);
                 }
             });
+
+            if (num_tree != nullptr) {
+                num_tree->insert_batch(value_ids);
+            }
         } else if(afield.type == field_types::GEOPOINT || afield.type == field_types::GEOPOINT_ARRAY) {
             auto geopoint_range_index = geo_range_index.at(afield.name);
 
@@ -955,6 +1111,11 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
                     vec_index->resizeIndex((curr_ele_count + iter_batch.size()) * 1.3);
                 }
 
+                if(iter_batch.size() >= hnsw_index_t::BULK_BUILD_MIN_BATCH) {
+                    bulk_build_vector_index(afield, iter_batch);
+                    return;
+                }
+
                 const size_t num_threads = std::min<size_t>(4, iter_batch.size());
                 const size_t window_size = (num_threads == 0) ? 0 :
                                            (iter_batch.size() + num_threads - 1) / num_threads;  // rounds up
@@ -1357,6 +1518,7 @@ void Index::do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
     size_t total_docs = seq_ids->num_ids();
     // assumed that facet fields have already been validated upstream
     for(auto& a_facet : facets) {
+        elapsed_time_timer_t facet_timer(a_facet.compute_time_us);
         auto findex = a_facet.orig_index;
         const auto& facet_field = facet_infos[findex].facet_field;
         const bool use_facet_query = facet_infos[findex].use_facet_query;
@@ -1609,7 +1771,8 @@ Option<bool> Index::search_all_candidates(const size_t num_search_fields,
                                           std::array<spp::sparse_hash_map<uint32_t, int64_t, Hasher32>*, 3>& field_values,
                                           const std::vector<size_t>& geopoint_indices,
                                           std::set<uint64>& query_hashes,
-                                          std::vector<uint32_t>& id_buff, const std::string& collection_name) const {
+                                          std::vector<uint32_t>& id_buff, const std::string& collection_name,
+                                          const size_t concurrency) const {
 
     /*if(!token_candidates_vec.empty()) {
         LOG(INFO) << "Prefix candidates size: " << token_candidates_vec.back().candidates.size();
@@ -1660,7 +1823,7 @@ Option<bool> Index::search_all_candidates(const size_t num_search_fields,
                                                              exclude_token_ids, exclude_token_ids_size, excluded_group_ids,
                                                              sort_order, field_values, geopoint_indices,
                                                              id_buff, all_result_ids, all_result_ids_len,
-                                                             collection_name);
+                                                             collection_name, concurrency);
         if (!search_across_fields_op.ok()) {
             return search_across_fields_op;
         }
@@ -2139,6 +2302,17 @@ Option<filter_result_t> Index::do_filtering_with_reference_ids(const std::string
         return Option<filter_result_t>(filter_result);
     }
 
+    // Looking up every referenced id costs more than a scan of the reference helper column once the referenced side
+    // matches a large share of this collection.
+    auto const is_singular_reference = search_schema.count(reference_helper_field_name) != 0 &&
+                                       search_schema.at(reference_helper_field_name).is_singular();
+    auto const has_reference_column = is_singular_reference ? sort_index.count(reference_helper_field_name) != 0 :
+                                                              reference_index.count(reference_helper_field_name) != 0;
+    if (has_reference_column && count >= reference_bitmap_join_min_ids &&
+        (uint64_t) count * reference_bitmap_join_scan_ratio >= seq_ids->num_ids()) {
+        return do_bitmap_join_with_reference_ids(reference_helper_field_name, ref_collection_name, ref_filter_result);
+    }
+
     // Collect all the doc ids from the reference ids.
     std::vector<std::pair<uint32_t, uint32_t>> id_pairs;
     std::unordered_set<uint32_t> unique_doc_ids;
@@ -2210,6 +2384,146 @@ Option<filter_result_t> Index::do_filtering_with_reference_ids(const std::string
     return Option<filter_result_t>(filter_result);
 }
 
+Option<filter_result_t> Index::do_bitmap_join_with_reference_ids(const std::string& reference_helper_field_name,
+                                                                 const std::string& ref_collection_name,
+                                                                 const filter_result_t& ref_filter_result) const {
+    // seq_id => ref_seq_id for a singular reference, seq_id => ref_seq_ids for an array of references.
+    const spp::sparse_hash_map<uint32_t, int64_t, Hasher32>* ref_column = nullptr;
+    const num_tree_t* ref_array_column = nullptr;
+
+    if (search_schema.at(reference_helper_field_name).is_singular()) {
+        if (sort_index.count(reference_helper_field_name) == 0) {
+            return Option<filter_result_t>(400, "`" + reference_helper_field_name + "` is not present in sort index.");
+        }
+        ref_column = sort_index.at(reference_helper_field_name);
+    } else {
+        if (reference_index.count(reference_helper_field_name) == 0) {
+            return Option<filter_result_t>(400, "`" + reference_helper_field_name +
+                                                "` is not present in reference index.");
+        }
+        ref_array_column = reference_index.at(reference_helper_field_name);
+    }
+
+    // The referenced ids are sorted, so the last one bounds the bitmap.
+    const uint32_t max_ref_id = ref_filter_result.docs[ref_filter_result.count - 1];
+    std::vector<uint64_t> ref_id_bitmap((max_ref_id >> 6) + 1, 0);
+    for (uint32_t i = 0; i < ref_filter_result.count; i++) {
+        const uint32_t ref_id = ref_filter_result.docs[i];
+        ref_id_bitmap[ref_id >> 6] |= (1ULL << (ref_id & 63));
+    }
+
+    auto is_referenced = [&ref_id_bitmap, max_ref_id](int64_t ref_id) {
+        return ref_id >= 0 && ref_id <= max_ref_id && ((ref_id_bitmap[ref_id >> 6] >> (ref_id & 63)) & 1) != 0;
+    };
+
+    std::vector<uint32_t> all_seq_ids;
+    seq_ids->uncompress(all_seq_ids);
+
+    // Every chunk collects its matching docs in seq_id order along with the offsets of their references in `ref_ids`.
+    struct join_chunk_t {
+        std::vector<uint32_t> docs;
+        std::vector<uint32_t> ref_offsets;
+        std::vector<uint32_t> ref_ids;
+    };
+
+    // Pool tasks and this thread claim chunks of documents until none are left, so the join never waits on a busy
+    // pool. Tasks that start late only touch `state`.
+    struct join_state_t {
+        std::atomic<size_t> next_chunk = 0;
+        size_t num_chunks = 0;
+        std::mutex m;
+        std::condition_variable cv;
+        size_t num_chunks_done = 0;
+    };
+
+    auto state = std::make_shared<join_state_t>();
+    state->num_chunks = (all_seq_ids.size() + reference_bitmap_join_chunk_size - 1) / reference_bitmap_join_chunk_size;
+    std::vector<join_chunk_t> chunks(state->num_chunks);
+
+    auto join = [state, &all_seq_ids, &chunks, &is_referenced, ref_column, ref_array_column]() {
+        size_t chunk;
+        while ((chunk = state->next_chunk++) < state->num_chunks) {
+            const size_t begin = chunk * reference_bitmap_join_chunk_size;
+            const size_t end = std::min<size_t>(begin + reference_bitmap_join_chunk_size, all_seq_ids.size());
+            auto& result = chunks[chunk];
+
+            if (ref_column != nullptr) {
+                for (size_t i = begin; i < end; i++) {
+                    const auto it = ref_column->find(all_seq_ids[i]);
+                    if (it != ref_column->end() && is_referenced(it->second)) {
+                        result.docs.push_back(all_seq_ids[i]);
+                        result.ref_offsets.push_back(result.ref_ids.size());
+                        result.ref_ids.push_back(it->second);
+                    }
+                }
+            } else {
+                ref_array_column->range_inclusive_for_each(all_seq_ids[begin], all_seq_ids[end - 1],
+                                                           [&result, &is_referenced](int64_t seq_id,
+                                                                                     const std::vector<uint32_t>& ref_ids) {
+                    const size_t num_ref_ids = result.ref_ids.size();
+                    for (const auto& ref_id: ref_ids) {
+                        if (is_referenced(ref_id)) {
+                            result.ref_ids.push_back(ref_id);
+                        }
+                    }
+
+                    if (result.ref_ids.size() != num_ref_ids) {
+                        result.docs.push_back(seq_id);
+                        result.ref_offsets.push_back(num_ref_ids);
+                    }
+                });
+            }
+
+            std::unique_lock<std::mutex> lock(state->m);
+            if (++state->num_chunks_done == state->num_chunks) {
+                state->cv.notify_one();
+            }
+        }
+    };
+
+    const size_t num_threads = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1),
+                                                state->num_chunks);
+    for (size_t thread_id = 1; thread_id < num_threads; thread_id++) {
+        thread_pool->enqueue(join);
+    }
+
+    join();
+
+    {
+        std::unique_lock<std::mutex> lock(state->m);
+        state->cv.wait(lock, [&]() { return state->num_chunks_done == state->num_chunks; });
+    }
+
+    filter_result_t filter_result;
+    for (const auto& chunk: chunks) {
+        filter_result.count += chunk.docs.size();
+    }
+
+    if (filter_result.count == 0) {
+        return Option<filter_result_t>(filter_result);
+    }
+
+    filter_result.docs = new uint32_t[filter_result.count];
+    filter_result.coll_to_references = new std::map<std::string, reference_filter_result_t>[filter_result.count] {};
+
+    // Chunks cover ascending ranges of seq_ids, so concatenating them keeps the result sorted.
+    uint32_t result_index = 0;
+    for (const auto& chunk: chunks) {
+        for (size_t i = 0; i < chunk.docs.size(); i++, result_index++) {
+            const uint32_t ref_begin = chunk.ref_offsets[i];
+            const uint32_t ref_end = (i + 1 < chunk.docs.size()) ? chunk.ref_offsets[i + 1] : chunk.ref_ids.size();
+
+            auto r = reference_filter_result_t(ref_end - ref_begin, new uint32_t[ref_end - ref_begin], false);
+            std::copy(chunk.ref_ids.begin() + ref_begin, chunk.ref_ids.begin() + ref_end, r.docs);
+
+            filter_result.docs[result_index] = chunk.docs[i];
+            filter_result.coll_to_references[result_index][ref_collection_name] = std::move(r);
+        }
+    }
+
+    return Option<filter_result_t>(filter_result);
+}
+
 Option<bool> Index::run_search(search_args* search_params, const std::string& collection_name,
                                facet_index_type_t facet_index_type, bool enable_typos_for_numerical_tokens) {
     return search(search_params->field_query_tokens,
@@ -2745,6 +3059,8 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
                    bool enable_lazy_filter) const {
     std::shared_lock lock(mutex);
 
+    search_stage_timer_t filter_timer(SEARCH_STAGE_FILTER);
+
     auto filter_result_iterator = new filter_result_iterator_t(collection_name, this, filter_tree_root,
                                                                search_begin_us, search_stop_us);
     std::unique_ptr<filter_result_iterator_t> filter_iterator_guard(filter_result_iterator);
@@ -2770,6 +3086,14 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
     }
 #endif
 
+    if (filter_tree_root != nullptr) {
+        search_num_filter_ids += filter_result_iterator->approx_filter_ids_length;
+
+        if (search_profile != nullptr) {
+            search_profile->filter_tree = filter_result_iterator->get_profile();
+        }
+    }
+
     size_t fetch_size = offset + per_page;
 
     std::set<uint32_t> curated_ids;
@@ -2787,6 +3111,11 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
     std::vector<uint32_t> curated_ids_sorted(curated_ids.begin(), curated_ids.end());
     std::sort(curated_ids_sorted.begin(), curated_ids_sorted.end());
 
+    filter_timer.stop();
+
+    // matching and scoring are interleaved, so both are accounted to the token search
+    search_stage_timer_t token_search_timer(SEARCH_STAGE_TOKEN_SEARCH);
+
     // Order of `fields` are used to sort results
     // auto begin = std::chrono::high_resolution_clock::now();
     uint32_t* all_result_ids = nullptr;
@@ -3052,6 +3381,7 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
                 filter_iterator_guard.reset(filter_result_iterator);
             }
 
+            const auto wildcard_begin = std::chrono::steady_clock::now();
             auto search_wildcard_op = search_wildcard(filter_tree_root, included_ids_map, sort_fields_std, topster,
                                                       curated_topster, groups_processed, searched_queries, group_limit, group_by_fields,
                                                       group_missing_values,
@@ -3063,6 +3393,11 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
             if (!search_wildcard_op.ok()) {
                 return search_wildcard_op;
             }
+
+            if (search_profile != nullptr) {
+                search_profile->scoring_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - wildcard_begin).count();
+            }
         }
 
         uint32_t _all_result_ids_len = all_result_ids_len;
@@ -3071,6 +3406,84 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
         all_result_ids_len = _all_result_ids_len;
     } else {
         // Non-wildcard
+
+        // check at least one of sort fields is text match
+        bool has_text_match = false;
+        for(auto& sort_field : sort_fields_std) {
+            if(sort_field.name == sort_field_const::text_match) {
+                has_text_match = true;
+                break;
+            }
+        }
+
+        // For hybrid search, the nearest neighbour search depends only on the query vector and the filter, so it is
+        // offered to the thread pool, over its own copy of the filter ids, while the text match search runs on this
+        // thread. Whichever side claims the leg first runs it: when the pool is busy, this thread runs it inline after
+        // the text match search instead of waiting behind other tasks.
+        struct vector_search_leg_t {
+            std::atomic<bool> claimed = false;
+            std::mutex m;
+            std::condition_variable cv;
+            bool done = false;
+            std::vector<std::pair<float, size_t>> dist_labels;
+            std::unique_ptr<filter_result_iterator_t> filter_iterator;
+
+            // Returns true when the caller must run the leg itself, otherwise waits for the pool task to finish it.
+            bool claim() {
+                std::unique_lock<std::mutex> lock(m);
+                if(!claimed.exchange(true)) {
+                    done = true;
+                    return true;
+                }
+
+                cv.wait(lock, [&] { return done; });
+                return false;
+            }
+        };
+
+        struct vector_search_leg_guard_t {
+            std::shared_ptr<vector_search_leg_t> leg;
+
+            ~vector_search_leg_guard_t() {
+                // on early returns, a pool task that is still running must not outlive the filter ids it reads
+                if(leg != nullptr) {
+                    leg->claim();
+                }
+            }
+        } vector_leg;
+
+        if(!vector_query.field_name.empty() && has_text_match && thread_pool != nullptr &&
+           (no_filters_provided || filter_result_iterator->is_computed())) {
+            auto leg = std::make_shared<vector_search_leg_t>();
+            if(no_filters_provided) {
+                leg->filter_iterator = std::make_unique<filter_result_iterator_t>(nullptr, 0, search_begin_us,
+                                                                                 search_stop_us);
+            } else {
+                uint32_t* filter_ids = nullptr;
+                uint32_t filter_ids_len = filter_result_iterator->to_filter_id_array(filter_ids);
+                filter_result_iterator->reset();
+                leg->filter_iterator = std::make_unique<filter_result_iterator_t>(filter_ids, filter_ids_len,
+                                                                                 search_begin_us, search_stop_us);
+            }
+
+            vector_leg.leg = leg;
+            thread_pool->enqueue([this, leg, &vector_query, fetch_size, excluded_result_ids,
+                                  excluded_result_ids_size]() {
+                if(leg->claimed.exchange(true)) {
+                    // the search thread got to it first: it may have returned already, so touch only the leg
+                    return;
+                }
+
+                auto dist_labels = hybrid_vector_search(vector_query, fetch_size, leg->filter_iterator.get(),
+                                                        excluded_result_ids, excluded_result_ids_size);
+
+                std::unique_lock<std::mutex> lock(leg->m);
+                leg->dist_labels = std::move(dist_labels);
+                leg->done = true;
+                leg->cv.notify_one();
+            });
+        }
+
         // In multi-field searches, a record can be matched across different fields, so we use this for aggregation
         //begin = std::chrono::high_resolution_clock::now();
 
@@ -3135,7 +3548,7 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
                                                           typo_tokens_threshold, exhaustive_search,
                                                           max_candidates, min_len_1typo, min_len_2typo,
                                                           syn_orig_num_tokens, sort_order, field_values, geopoint_indices,
-                                                          collection_name, enable_typos_for_numerical_tokens);
+                                                          collection_name, enable_typos_for_numerical_tokens, concurrency);
         if (!fuzzy_search_fields_op.ok()) {
             return fuzzy_search_fields_op;
         }
@@ -3181,7 +3594,7 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
                                                                   prefixes, typo_tokens_threshold, exhaustive_search,
                                                                   max_candidates, min_len_1typo, min_len_2typo,
                                                                   syn_orig_num_tokens, sort_order, field_values, geopoint_indices,
-                                                                  collection_name);
+                                                                  collection_name, true, concurrency);
                 if (!fuzzy_search_fields_op.ok()) {
                     return fuzzy_search_fields_op;
                 }
@@ -3285,7 +3698,7 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
                                                                           token_order, prefixes, typo_tokens_threshold,
                                                                           exhaustive_search, max_candidates, min_len_1typo,
                                                                           min_len_2typo, -1, sort_order, field_values, geopoint_indices,
-                                                                          collection_name);
+                                                                          collection_name, true, concurrency);
                         if (!fuzzy_search_fields_op.ok()) {
                             return fuzzy_search_fields_op;
                         }
@@ -3315,36 +3728,30 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
         search_cutoff = search_cutoff || filter_result_iterator->validity == filter_result_iterator_t::timed_out;
 
         if(!vector_query.field_name.empty()) {
-            // check at least one of sort fields is text match
-            bool has_text_match = false;
-            for(auto& sort_field : sort_fields_std) {
-                if(sort_field.name == sort_field_const::text_match) {
-                    has_text_match = true;
-                    break;
-                }
-            }
-
             if(has_text_match) {
                 // For hybrid search, we need to give weight to text match and vector search
                 const float VECTOR_SEARCH_WEIGHT = vector_query.alpha;
                 const float TEXT_MATCH_WEIGHT = 1.0 - VECTOR_SEARCH_WEIGHT;
 
-                VectorFilterFunctor filterFunctor(filter_result_iterator, excluded_result_ids, excluded_result_ids_size);
                 auto& field_vector_index = vector_index.at(vector_query.field_name);
 
                 std::vector<std::pair<float, size_t>> dist_labels;
-                // use k as 100 by default for ensuring results stability in pagination
-                size_t default_k = 100;
-                auto k = vector_query.k == 0 ? std::max<size_t>(fetch_size, default_k) : vector_query.k;
-                if(field_vector_index->distance_type == cosine) {
-                    std::vector<float> normalized_q(vector_query.values.size());
-                    hnsw_index_t::normalize_vector(vector_query.values, normalized_q);
-                    dist_labels = field_vector_index->vecdex->searchKnnCloserFirst(normalized_q.data(), k, vector_query.ef, &filterFunctor);
+                if(vector_leg.leg != nullptr) {
+                    auto& leg = *vector_leg.leg;
+                    if(leg.claim()) {
+                        dist_labels = hybrid_vector_search(vector_query, fetch_size, leg.filter_iterator.get(),
+                                                           excluded_result_ids, excluded_result_ids_size);
+                    } else {
+                        dist_labels = std::move(leg.dist_labels);
+                    }
+                    search_cutoff = search_cutoff ||
+                                    leg.filter_iterator->validity == filter_result_iterator_t::timed_out;
                 } else {
-                    dist_labels = field_vector_index->vecdex->searchKnnCloserFirst(vector_query.values.data(), k, vector_query.ef, &filterFunctor);
+                    dist_labels = hybrid_vector_search(vector_query, fetch_size, filter_result_iterator,
+                                                       excluded_result_ids, excluded_result_ids_size);
+                    filter_result_iterator->reset();
+                    search_cutoff = search_cutoff || filter_result_iterator->validity == filter_result_iterator_t::timed_out;
                 }
-                filter_result_iterator->reset();
-                search_cutoff = search_cutoff || filter_result_iterator->validity == filter_result_iterator_t::timed_out;
 
                 std::vector<std::pair<uint32_t,float>> vec_results;
                 for (const auto& dist_label : dist_labels) {
@@ -3513,6 +3920,9 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
 
     process_search_results:
 
+    token_search_timer.stop();
+    search_stage_timer_t facets_timer(SEARCH_STAGE_FACETS);
+
     delete [] exclude_token_ids;
     delete [] excluded_result_ids;
 
@@ -3658,6 +4068,12 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
         cv_process.wait(lock_process, [&](){ return num_processed == num_queued; });
         search_cutoff = parent_search_cutoff;
 
+        if(search_profile != nullptr) {
+            for(const auto& acc_facet: facets) {
+                search_profile->facet_times_us.emplace_back(acc_facet.field_name, acc_facet.compute_time_us);
+            }
+        }
+
         for(auto & acc_facet: facets) {
             for(auto& facet_kv: acc_facet.result_map) {
                 if(group_limit) {
@@ -3719,6 +4135,7 @@ Option<bool> Index::search(std::vector<query_tokens_t>& field_query_tokens, cons
 }
 
 void Index::aggregate_facet(const size_t group_limit, facet& this_facet, facet& acc_facet) const {
+    acc_facet.compute_time_us += this_facet.compute_time_us;
     acc_facet.is_intersected = this_facet.is_intersected;
     acc_facet.is_sort_by_alpha = this_facet.is_sort_by_alpha;
     acc_facet.sort_order = this_facet.sort_order;
@@ -3905,7 +4322,7 @@ Option<bool> Index::fuzzy_search_fields(const std::vector<search_field_t>& the_f
                                         std::array<spp::sparse_hash_map<uint32_t, int64_t, Hasher32>*, 3>& field_values,
                                         const std::vector<size_t>& geopoint_indices,
                                         const std::string& collection_name,
-                                        bool enable_typos_for_numerical_tokens) const {
+                                        bool enable_typos_for_numerical_tokens, const size_t concurrency) const {
 
     // NOTE: `query_tokens` preserve original tokens, while `search_tokens` could be a result of dropped tokens
 
@@ -4027,8 +4444,12 @@ Option<bool> Index::fuzzy_search_fields(const std::vector<search_field_t>& the_f
                     const auto& prev_token = last_token ? token_candidates_vec.back().candidates[0] : "";
 
                     std::vector<art_leaf*> field_leaves;
-                    art_fuzzy_search_i(search_index.at(search_field.faceted_name()),
-                                       (const unsigned char *) token.c_str(), token_len,
+                    std::vector<const art_node*> fuzzy_nodes;
+                    auto tree = search_index.at(search_field.faceted_name());
+                    typo_candidate_cache.get_nodes(search_field.faceted_name(), tree,
+                                                   (const unsigned char *) token.c_str(), token_len,
+                                                   costs[token_index], prefix_search, fuzzy_nodes);
+                    art_fuzzy_search_nodes(tree, fuzzy_nodes, (const unsigned char *) token.c_str(), token_len,
                                      costs[token_index], costs[token_index], max_candidates, token_order, prefix_search,
                                      last_token, prev_token, filter_result_iterator, field_leaves, unique_tokens);
                     filter_result_iterator->reset();
@@ -4088,7 +4509,11 @@ Option<bool> Index::fuzzy_search_fields(const std::vector<search_field_t>& the_f
                         }
 
                         std::vector<art_leaf*> field_leaves;
-                        art_fuzzy_search_i(search_index.at(the_field.name), (const unsigned char *) token.c_str(), token_len,
+                        std::vector<const art_node*> fuzzy_nodes;
+                        auto tree = search_index.at(the_field.name);
+                        typo_candidate_cache.get_nodes(the_field.name, tree, (const unsigned char *) token.c_str(),
+                                                       token_len, costs[token_index], prefix_search, fuzzy_nodes);
+                        art_fuzzy_search_nodes(tree, fuzzy_nodes, (const unsigned char *) token.c_str(), token_len,
                                          costs[token_index], costs[token_index], max_candidates, token_order, prefix_search,
                                          false, "", filter_result_iterator, field_leaves, unique_tokens);
                         filter_result_iterator->reset();
@@ -4159,7 +4584,7 @@ Option<bool> Index::fuzzy_search_fields(const std::vector<search_field_t>& the_f
                                                                   num_typos, prefixes, prioritize_exact_match, prioritize_token_position,
                                                                   prioritize_num_matching_fields, exhaustive_search, max_candidates,
                                                                   syn_orig_num_tokens, sort_order, field_values, geopoint_indices,
-                                                                  query_hashes, id_buff, collection_name);
+                                                                  query_hashes, id_buff, collection_name, concurrency);
             if (!search_all_candidates_op.ok()) {
                 return search_all_candidates_op;
             }
@@ -4331,12 +4756,12 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
                                          const std::vector<size_t>& geopoint_indices,
                                          std::vector<uint32_t>& id_buff,
                                          uint32_t*& all_result_ids, size_t& all_result_ids_len,
-                                         const std::string& collection_name) const {
+                                         const std::string& collection_name, const size_t concurrency) const {
 
     std::vector<art_leaf*> query_suggestion;
 
-    // one or_iterator for each token (across multiple fields)
-    std::vector<or_iterator_t> dropped_token_its;
+    // posting lists of each dropped token across the fields, from which every partition creates its own iterators
+    std::vector<std::vector<std::pair<posting_list_t*, uint32_t>>> dropped_token_plists;
 
     // used to track plists that must be destructed once done
     std::vector<posting_list_t*> expanded_dropped_plists;
@@ -4345,8 +4770,7 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
         auto& token = dropped_token.value;
         auto token_c_str = (const unsigned char*) token.c_str();
 
-        // convert token from each field into an or_iterator
-        std::vector<posting_list_t::iterator_t> its;
+        std::vector<std::pair<posting_list_t*, uint32_t>> plists;
 
         for(size_t i = 0; i < the_fields.size(); i++) {
             const std::string& field_name = the_fields[i].name;
@@ -4365,24 +4789,26 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
                 auto compact_posting_list = COMPACT_POSTING_PTR(leaf->values);
                 posting_list_t* full_posting_list = compact_posting_list->to_full_posting_list();
                 expanded_dropped_plists.push_back(full_posting_list);
-                its.push_back(full_posting_list->new_iterator(nullptr, nullptr, i)); // moved, not copied
+                plists.emplace_back(full_posting_list, i);
             } else {
-                posting_list_t* full_posting_list = (posting_list_t*)(leaf->values);
-                its.push_back(full_posting_list->new_iterator(nullptr, nullptr, i)); // moved, not copied
+                plists.emplace_back((posting_list_t*)(leaf->values), i);
             }
         }
 
-        or_iterator_t token_fields(its);
-        dropped_token_its.push_back(std::move(token_fields));
+        dropped_token_plists.push_back(std::move(plists));
     }
 
-    // one iterator for each token, each underlying iterator contains results of token across multiple fields
-    std::vector<or_iterator_t> token_its;
+    // posting lists of each token across the query_by fields
+    std::vector<std::vector<std::pair<posting_list_t*, uint32_t>>> token_plists;
 
     // used to track plists that must be destructed once done
     std::vector<posting_list_t*> expanded_plists;
 
-    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_result_iterator);
+    // upper bound on the number of matching documents: ids of the rarest token across all fields
+    size_t max_num_candidates = std::numeric_limits<size_t>::max();
+
+    const bool profile_search = (search_profile != nullptr);
+    nlohmann::json token_profiles = nlohmann::json::array();
 
     // for each token, find the posting lists across all query_by fields
     for(size_t ti = 0; ti < query_tokens.size(); ti++) {
@@ -4392,7 +4818,9 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
         auto& token_str = query_tokens[ti].value;
         auto token_c_str = (const unsigned char*) token_str.c_str();
         const size_t token_len = token_str.size() + 1;
-        std::vector<posting_list_t::iterator_t> its;
+        std::vector<std::pair<posting_list_t*, uint32_t>> plists;
+        size_t token_num_ids = 0;
+        nlohmann::json token_fields_profile = nlohmann::json::object();
 
         for(size_t i = 0; i < num_search_fields; i++) {
             const std::string& field_name = the_fields[i].name;
@@ -4418,6 +4846,11 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
             }
 
             query_suggestion.push_back(leaf);
+            token_num_ids += posting_t::num_ids(leaf->values);
+
+            if(profile_search) {
+                token_fields_profile[field_name] = posting_t::num_ids(leaf->values);
+            }
 
             /*LOG(INFO) << "Token: " << token_str << ", field_name: " << field_name
                       << ", num_ids: " << posting_t::num_ids(leaf->values);*/
@@ -4426,38 +4859,61 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
                 auto compact_posting_list = COMPACT_POSTING_PTR(leaf->values);
                 posting_list_t* full_posting_list = compact_posting_list->to_full_posting_list();
                 expanded_plists.push_back(full_posting_list);
-                its.push_back(full_posting_list->new_iterator(nullptr, nullptr, i)); // moved, not copied
+                plists.emplace_back(full_posting_list, i);
             } else {
-                posting_list_t* full_posting_list = (posting_list_t*)(leaf->values);
-                its.push_back(full_posting_list->new_iterator(nullptr, nullptr, i)); // moved, not copied
+                plists.emplace_back((posting_list_t*)(leaf->values), i);
             }
         }
 
-        if(its.empty()) {
+        if(plists.empty()) {
             // this token does not have any match across *any* field: probably a typo
             LOG(INFO) << "No matching field found for token: " << token_str;
             continue;
         }
 
-        or_iterator_t token_fields(its);
-        token_its.push_back(std::move(token_fields));
-    }
+        max_num_candidates = std::min(max_num_candidates, token_num_ids);
+        token_plists.push_back(std::move(plists));
 
-    std::vector<uint32_t> result_ids;
-    std::vector<uint32_t> eval_filter_indexes;
-    Option<bool> status(true);
+        if(profile_search) {
+            token_profiles.push_back({{"token", token_str}, {"num_typos", token_num_typos},
+                                      {"prefix", token_prefix}, {"fields", std::move(token_fields_profile)}});
+        }
+    }
 
-    auto group_by_field_it_vec = get_group_by_field_iterators(group_by_fields);
+    // one or_iterator for each token, each underlying iterator contains results of token across multiple fields
+    auto new_or_iterators = [](const std::vector<std::vector<std::pair<posting_list_t*, uint32_t>>>& plists_vec) {
+        std::vector<or_iterator_t> or_its;
 
-    or_iterator_t::intersect(token_its, istate,
-                             [&](single_filter_result_t& filter_result, const std::vector<or_iterator_t>& its) {
-        auto& seq_id = filter_result.seq_id;
+        for(const auto& plists: plists_vec) {
+            std::vector<posting_list_t::iterator_t> its;
+            for(const auto& plist_field: plists) {
+                its.push_back(plist_field.first->new_iterator(nullptr, nullptr, plist_field.second)); // moved, not copied
+            }
 
-        if(topster == nullptr) {
-            result_ids.push_back(seq_id);
-            return ;
+            or_iterator_t token_fields(its);
+            or_its.push_back(std::move(token_fields));
         }
 
+        return or_its;
+    };
+
+    // state of a contiguous range of seq_ids that is scored independently of the others
+    struct search_partition_t {
+        Topster* topster;
+        spp::sparse_hash_map<uint64_t, uint32_t>* groups_processed;
+        std::vector<or_iterator_t> dropped_token_its;
+        std::vector<group_by_field_it_t> group_by_field_it_vec;
+        std::vector<uint32_t> eval_filter_indexes;
+        std::vector<uint32_t> result_ids;
+        Option<bool> status = Option<bool>(true);
+        uint64_t scoring_time_us = 0;
+    };
+
+    auto score_candidate = [&](search_partition_t& partition, single_filter_result_t& filter_result,
+                               const std::vector<or_iterator_t>& its) {
+        auto& seq_id = filter_result.seq_id;
+        auto& dropped_token_its = partition.dropped_token_its;
+
         auto references = std::move(filter_result.reference_filter_results);
         //LOG(INFO) << "seq_id: " << seq_id;
         // Convert [token -> fields] orientation to [field -> tokens] orientation
@@ -4540,7 +4996,7 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
         uint64_t distinct_id = seq_id;
         if(group_limit != 0) {
             distinct_id = 1;
-            for(auto& kv : group_by_field_it_vec) {
+            for(auto& kv : partition.group_by_field_it_vec) {
                 get_distinct_id(kv.it, seq_id, kv.is_array, group_missing_values, distinct_id);
             }
 
@@ -4553,10 +5009,10 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
         int64_t match_score_index = -1;
 
         auto compute_sort_scores_op = compute_sort_scores(sort_fields, sort_order, field_values, geopoint_indices,
-                                                          seq_id, references, eval_filter_indexes, best_field_match_score,
+                                                          seq_id, references, partition.eval_filter_indexes, best_field_match_score,
                                                           scores, match_score_index, 0, collection_name);
         if (!compute_sort_scores_op.ok()) {
-            status = Option<bool>(compute_sort_scores_op.code(), compute_sort_scores_op.error());
+            partition.status = Option<bool>(compute_sort_scores_op.code(), compute_sort_scores_op.error());
             return;
         }
 
@@ -4608,12 +5064,163 @@ Option<bool> Index::search_across_fields(const std::vector<token_t>& query_token
             kv.text_match_score = aggregated_score;
         }
 
-        int ret = topster->add(&kv);
+        int ret = partition.topster->add(&kv);
         if(group_limit != 0 && ret < 2) {
-            groups_processed[distinct_id]++;
+            (*partition.groups_processed)[distinct_id]++;
         }
-        result_ids.push_back(seq_id);
-    });
+        partition.result_ids.push_back(seq_id);
+    };
+
+    auto profile_score_candidate = [&](search_partition_t& partition, single_filter_result_t& filter_result,
+                                       const std::vector<or_iterator_t>& its) {
+        if(!profile_search) {
+            score_candidate(partition, filter_result, its);
+            return ;
+        }
+
+        elapsed_time_timer_t scoring_timer(partition.scoring_time_us);
+        score_candidate(partition, filter_result, its);
+    };
+
+    // iterators are not copyable, so partitions are kept in a deque that never relocates them
+    std::deque<search_partition_t> partitions;
+    partitions.push_back(search_partition_t{topster, &groups_processed, new_or_iterators(dropped_token_plists),
+                                            get_group_by_field_iterators(group_by_fields)});
+
+    auto token_its = new_or_iterators(token_plists);
+    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_result_iterator);
+
+    if(topster == nullptr || thread_pool == nullptr || concurrency < 2 ||
+       max_num_candidates < 2 * SEARCH_PARTITION_MIN_SIZE) {
+        or_iterator_t::intersect(token_its, istate,
+                                 [&](single_filter_result_t& filter_result, const std::vector<or_iterator_t>& its) {
+            if(topster == nullptr) {
+                partitions[0].result_ids.push_back(filter_result.seq_id);
+                return ;
+            }
+
+            profile_score_candidate(partitions[0], filter_result, its);
+        });
+    } else {
+        // Scoring a large candidate set dominates the search, so the matching ids are gathered first and then
+        // scored in contiguous seq_id partitions on the thread pool, each with its own iterators and topster.
+        // Until there are enough candidates for two partitions, they are scored right away while gathering: a
+        // candidate set that turns out to be small is never intersected twice.
+        const size_t max_inline_scored = 2 * SEARCH_PARTITION_MIN_SIZE - 1;
+        size_t num_candidates = 0;
+        std::vector<uint32_t> candidate_ids;
+        std::vector<std::map<std::string, reference_filter_result_t>> candidate_references;
+
+        or_iterator_t::intersect(token_its, istate,
+                                 [&](single_filter_result_t& filter_result, const std::vector<or_iterator_t>& its) {
+            if(num_candidates++ < max_inline_scored) {
+                profile_score_candidate(partitions[0], filter_result, its);
+                return ;
+            }
+
+            candidate_ids.push_back(filter_result.seq_id);
+            candidate_references.push_back(std::move(filter_result.reference_filter_results));
+        });
+
+        // the remaining candidates exist only when there are at least two partitions' worth of them
+        const size_t num_partitions = candidate_ids.empty() ? 0 :
+                                      std::max<size_t>(2, std::min(concurrency,
+                                                                   num_candidates / SEARCH_PARTITION_MIN_SIZE));
+        const size_t partition_size = candidate_ids.empty() ? 0 :
+                                      (candidate_ids.size() + num_partitions - 1) / num_partitions;
+
+        std::vector<std::unique_ptr<Topster>> partition_topsters;
+        std::vector<spp::sparse_hash_map<uint64_t, uint32_t>> partition_groups_processed(num_partitions);
+
+        for(size_t p = 1; p < num_partitions; p++) {
+            partition_topsters.emplace_back(new Topster(topster->MAX_SIZE, topster->distinct));
+            partitions.push_back(search_partition_t{partition_topsters.back().get(), &partition_groups_processed[p],
+                                                    new_or_iterators(dropped_token_plists),
+                                                    get_group_by_field_iterators(group_by_fields)});
+        }
+
+        auto search_partition = [&](const size_t p) {
+            const size_t begin = p * partition_size;
+            const size_t end = std::min(begin + partition_size, candidate_ids.size());
+            if(begin >= end) {
+                return ;
+            }
+
+            // exclusions and filters were applied while gathering the candidates
+            auto partition_token_its = new_or_iterators(token_plists);
+            result_iter_state_t partition_istate(nullptr, 0, &candidate_ids[begin], end - begin);
+            size_t candidate_index = begin;
+
+            or_iterator_t::intersect(partition_token_its, partition_istate,
+                                     [&](single_filter_result_t& filter_result, const std::vector<or_iterator_t>& its) {
+                while(candidate_ids[candidate_index] < filter_result.seq_id) {
+                    candidate_index++;
+                }
+
+                filter_result.reference_filter_results = std::move(candidate_references[candidate_index]);
+                profile_score_candidate(partitions[p], filter_result, its);
+            });
+        };
+
+        const auto parent_search_begin = search_begin_us;
+        const auto parent_search_stop_us = search_stop_us;
+        bool parent_search_cutoff = false;
+
+        size_t num_processed = 0;
+        std::mutex m_process;
+        std::condition_variable cv_process;
+
+        for(size_t p = 1; p < num_partitions; p++) {
+            thread_pool->enqueue([&, p]() {
+                search_begin_us = parent_search_begin;
+                search_stop_us = parent_search_stop_us;
+                search_cutoff = false;
+
+                search_partition(p);
+
+                std::unique_lock<std::mutex> lock(m_process);
+                num_processed++;
+                parent_search_cutoff = parent_search_cutoff || search_cutoff;
+                cv_process.notify_one();
+            });
+        }
+
+        search_partition(0);
+
+        std::unique_lock<std::mutex> lock_process(m_process);
+        cv_process.wait(lock_process, [&](){ return num_processed + 1 >= num_partitions; });
+        search_cutoff = search_cutoff || parent_search_cutoff;
+
+        for(size_t p = 1; p < num_partitions; p++) {
+            if(!partitions[p].status.ok() && partitions[0].status.ok()) {
+                partitions[0].status = Option<bool>(partitions[p].status.code(), partitions[p].status.error());
+            }
+
+            for(const auto& it : partition_groups_processed[p]) {
+                groups_processed[it.first] += it.second;
+            }
+
+            aggregate_topster(topster, partitions[p].topster);
+            partitions[0].result_ids.insert(partitions[0].result_ids.end(), partitions[p].result_ids.begin(),
+                                            partitions[p].result_ids.end());
+        }
+    }
+
+    const auto& status = partitions[0].status;
+    const auto& result_ids = partitions[0].result_ids;
+
+    if(topster != nullptr) {
+        search_num_scored_candidates += result_ids.size();
+    }
+
+    if(profile_search) {
+        for(const auto& partition: partitions) {
+            search_profile->scoring_time_us += partition.scoring_time_us;
+        }
+
+        search_profile->add_token_candidates({{"tokens", std::move(token_profiles)},
+                                              {"num_matches", result_ids.size()}});
+    }
 
     if (!status.ok()) {
         for(posting_list_t* plist: expanded_plists) {
@@ -5471,7 +6078,7 @@ Option<bool> Index::do_synonym_search(const std::vector<search_field_t>& the_fie
                                                           token_order, prefixes, typo_tokens_threshold, exhaustive_search,
                                                           max_candidates, min_len_1typo, min_len_2typo,
                                                           syn_orig_num_tokens, sort_order, field_values, geopoint_indices,
-                                                          collection_name);
+                                                          collection_name, true, concurrency);
         if (!fuzzy_search_fields_op.ok()) {
             return fuzzy_search_fields_op;
         }
@@ -5876,6 +6483,108 @@ void Index::curate_filtered_ids(const std::set<uint32_t>& curated_ids,
     }
 }
 
+std::vector<std::pair<float, size_t>> Index::hybrid_vector_search(const vector_query_t& vector_query, size_t fetch_size,
+                                                                  filter_result_iterator_t* filter_result_iterator,
+                                                                  const uint32_t* excluded_result_ids,
+                                                                  size_t excluded_result_ids_size) const {
+    VectorFilterFunctor filterFunctor(filter_result_iterator, excluded_result_ids, excluded_result_ids_size);
+    auto& field_vector_index = vector_index.at(vector_query.field_name);
+
+    // use k as 100 by default for ensuring results stability in pagination
+    size_t default_k = 100;
+    auto k = vector_query.k == 0 ? std::max<size_t>(fetch_size, default_k) : vector_query.k;
+    if(field_vector_index->distance_type == cosine) {
+        std::vector<float> normalized_q(vector_query.values.size());
+        hnsw_index_t::normalize_vector(vector_query.values, normalized_q);
+        return field_vector_index->vecdex->searchKnnCloserFirst(normalized_q.data(), k, vector_query.ef, &filterFunctor);
+    }
+
+    return field_vector_index->vecdex->searchKnnCloserFirst(vector_query.values.data(), k, vector_query.ef, &filterFunctor);
+}
+
+bool Index::geo_knn_candidates(const sort_by& geo_sort_field, const size_t k,
+                               filter_result_iterator_t* const filter_result_iterator,
+                               const uint32_t* exclude_token_ids, const size_t exclude_token_ids_size,
+                               filter_result_t& candidates) const {
+    S2LatLng origin;
+    GeoPoint::unpack_lat_lng(geo_sort_field.geopoint, origin);
+    const S2Point origin_point = origin.ToPoint();
+
+    auto const sort_field_index = sort_index.at(geo_sort_field.name);
+    auto const geo_index = geo_range_index.at(geo_sort_field.name);
+
+    S2RegionTermIndexer::Options options;
+    options.set_index_contains_points_only(true);
+    S2RegionTermIndexer indexer(options);
+
+    double radius_meters = GEO_KNN_INITIAL_RADIUS_METERS;
+
+    while(radius_meters <= GEO_KNN_MAX_RADIUS_METERS) {
+        // distances are truncated to whole meters, so the extra meter ensures that every point left out of the
+        // covering is strictly farther than `max_dist`
+        const int64_t max_dist = radius_meters;
+        S1Angle cap_radius = S1Angle::Radians(S2Earth::MetersToRadians(max_dist + 1));
+        S2Cap cap(origin_point, cap_radius);
+
+        std::vector<uint64_t> cell_ids;
+        for(const auto& term: indexer.GetQueryTerms(cap, "")) {
+            cell_ids.push_back(S2CellId::FromToken(term).id());
+        }
+
+        std::vector<uint32_t> geo_ids;
+        geo_index->search_geopoints(cell_ids, geo_ids);
+
+        if(geo_ids.size() > filter_result_iterator->approx_filter_ids_length) {
+            // verifying the cap would cost more than scoring every filter id
+            return false;
+        }
+
+        std::vector<uint32_t> nearby_ids;
+        for(const auto seq_id: geo_ids) {
+            auto it = sort_field_index->find(seq_id);
+            if(it == sort_field_index->end()) {
+                continue;
+            }
+
+            S2LatLng lat_lng;
+            GeoPoint::unpack_lat_lng(it->second, lat_lng);
+            if(GeoPoint::distance(lat_lng, origin) <= max_dist) {
+                nearby_ids.push_back(seq_id);
+            }
+        }
+
+        if(exclude_token_ids_size != 0 && !nearby_ids.empty()) {
+            uint32_t* included_ids = nullptr;
+            auto num_included = ArrayUtils::exclude_scalar(nearby_ids.data(), nearby_ids.size(),
+                                                           exclude_token_ids, exclude_token_ids_size, &included_ids);
+            nearby_ids.assign(included_ids, included_ids + num_included);
+            delete [] included_ids;
+        }
+
+        filter_result_t filtered_ids;
+        if(!nearby_ids.empty()) {
+            filter_result_iterator->and_scalar(nearby_ids.data(), nearby_ids.size(), filtered_ids);
+            filter_result_iterator->reset();
+        }
+
+        if(filter_result_iterator->validity == filter_result_iterator_t::timed_out) {
+            return false;
+        }
+
+        if(filtered_ids.count >= k) {
+            candidates = std::move(filtered_ids);
+            return true;
+        }
+
+        // the number of points in a cap grows with the square of its radius: estimate the radius that would hold
+        // `k` ids from the density seen so far, while growing at least 2x and at most 16x per round
+        const double growth = std::sqrt(double(k) / std::max<uint32_t>(filtered_ids.count, 1)) * 1.25;
+        radius_meters *= std::min(std::max(growth, 2.0), 16.0);
+    }
+
+    return false;
+}
+
 Option<bool> Index::search_wildcard(filter_node_t const* const& filter_tree_root,
                                     const std::map<size_t, std::map<size_t, uint32_t>>& included_ids_map,
                                     const std::vector<sort_by>& sort_fields, Topster* topster, Topster* curated_topster,
@@ -5897,6 +6606,53 @@ Option<bool> Index::search_wildcard(filter_node_t const* const& filter_tree_root
     filter_result_iterator->compute_iterators();
     auto const& approx_filter_ids_length = filter_result_iterator->approx_filter_ids_length;
 
+    // When the hits are ordered by their distance from a point, only the nearest ones can make it to the topster.
+    const bool is_geo_knn_sort = group_limit == 0 && !sort_fields.empty() && sort_order[0] == -1 &&
+                                 !geopoint_indices.empty() && geopoint_indices[0] == 0 &&
+                                 field_values[0] != nullptr && sort_fields[0].reference_collection_name.empty() &&
+                                 sort_fields[0].geo_precision == 0 && sort_fields[0].exclude_radius == 0 &&
+                                 geo_range_index.count(sort_fields[0].name) != 0;
+
+    filter_result_t geo_knn_result;
+    if(is_geo_knn_sort && filter_result_iterator->validity == filter_result_iterator_t::valid &&
+       approx_filter_ids_length > topster->MAX_SIZE &&
+       geo_knn_candidates(sort_fields[0], topster->MAX_SIZE, filter_result_iterator,
+                          exclude_token_ids, exclude_token_ids_size, geo_knn_result)) {
+        searched_queries.push_back({});
+
+        std::vector<uint32_t> filter_indexes;
+        std::vector<posting_list_t::iterator_t> plists;
+
+        for(size_t i = 0; i < geo_knn_result.count; i++) {
+            const uint32_t seq_id = geo_knn_result.docs[i];
+            std::map<basic_string<char>, reference_filter_result_t> references;
+            if (geo_knn_result.coll_to_references != nullptr) {
+                references = std::move(geo_knn_result.coll_to_references[i]);
+            }
+
+            int64_t scores[3] = {0};
+            int64_t match_score_index = -1;
+
+            auto compute_sort_scores_op = compute_sort_scores(sort_fields, sort_order, field_values, geopoint_indices,
+                                                              seq_id, references, filter_indexes, 100, scores,
+                                                              match_score_index, 0, collection_name);
+            if (!compute_sort_scores_op.ok()) {
+                return compute_sort_scores_op;
+            }
+
+            KV kv(searched_queries.size(), seq_id, seq_id, match_score_index, scores, std::move(references));
+            topster->add(&kv);
+        }
+
+        search_num_scored_candidates += geo_knn_result.count;
+
+        filter_result_iterator->reset();
+        all_result_ids_len = filter_result_iterator->to_filter_id_array(all_result_ids);
+        search_cutoff = search_cutoff || filter_result_iterator->validity == filter_result_iterator_t::timed_out;
+
+        return Option<bool>(true);
+    }
+
     uint32_t token_bits = 0;
     const bool check_for_circuit_break = (approx_filter_ids_length > 1000000);
 
@@ -6059,6 +6815,8 @@ Option<bool> Index::search_wildcard(filter_node_t const* const& filter_tree_root
         search_cutoff = search_cutoff || filter_result_iterator->validity == filter_result_iterator_t::timed_out;
     }
 
+    search_num_scored_candidates += all_result_ids_len;
+
     return Option<bool>(true);
 }
 
@@ -6877,6 +7635,10 @@ const spp::sparse_hash_map<std::string, art_tree *> &Index::_get_search_index()
     return search_index;
 }
 
+void Index::_set_thread_pool(ThreadPool* pool) {
+    thread_pool = pool;
+}
+
 const spp::sparse_hash_map<std::string, num_tree_t*>& Index::_get_numerical_index() const {
     return numerical_index;
 }
@@ -6967,6 +7729,10 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
     }
 
+    if(!del_fields.empty()) {
+        typo_candidate_cache.clear();
+    }
+
     for(const auto & del_field: del_fields) {
         if(search_schema.count(del_field.name) == 0) {
             // could be a dynamic field
@@ -7147,6 +7913,108 @@ size_t Index::num_seq_ids() const {
     return seq_ids->num_ids();
 }
 
+nlohmann::json Index::get_memory_usage() const {
+    std::shared_lock lock(mutex);
+
+    // field => structure => bytes
+    std::map<std::string, std::map<std::string, uint64_t>> field_bytes;
+
+    for(const auto& kv: search_index) {
+        uint64_t node_bytes = 0, posting_bytes = 0;
+        art_memory_used(kv.second, &node_bytes, &posting_bytes);
+        field_bytes[kv.first]["art_tree"] += node_bytes;
+        field_bytes[kv.first]["posting_lists"] += posting_bytes;
+    }
+
+    for(const auto& kv: numerical_index) {
+        field_bytes[kv.first]["num_tree"] += kv.second->memory_used();
+    }
+
+    for(const auto& kv: reference_index) {
+        field_bytes[kv.first]["reference_index"] += kv.second->memory_used();
+    }
+
+    for(const auto& kv: object_array_reference_index) {
+        field_bytes[kv.first]["reference_index"] += sparse_hash_map_memory_used(*kv.second);
+    }
+
+    for(const auto& kv: range_index) {
+        field_bytes[kv.first]["numeric_trie"] += kv.second->memory_used();
+    }
+
+    for(const auto& kv: geo_range_index) {
+        field_bytes[kv.first]["numeric_trie"] += kv.second->memory_used();
+    }
+
+    for(const auto& kv: geo_array_index) {
+        uint64_t bytes = sparse_hash_map_memory_used(*kv.second);
+        for(const auto& id_latlongs: *kv.second) {
+            // first element holds the number of packed lat-longs
+            bytes += (id_latlongs.second[0] + 1) * sizeof(int64_t);
+        }
+        field_bytes[kv.first]["geo_array_index"] += bytes;
+    }
+
+    for(auto it = search_schema.begin(); it != search_schema.end(); ++it) {
+        const auto bytes = facet_index_v4->memory_used(it.key());
+        if(bytes != 0) {
+            field_bytes[it.key()]["facet_index"] += bytes;
+        }
+    }
+
+    for(const auto& kv: sort_index) {
+        field_bytes[kv.first]["sort_index"] += sparse_hash_map_memory_used(*kv.second);
+    }
+
+    for(const auto& kv: str_sort_index) {
+        field_bytes[kv.first]["str_sort_index"] += kv.second->memory_used();
+    }
+
+    std::string infix_key;
+    for(const auto& kv: infix_index) {
+        uint64_t bytes = 0;
+        for(const auto infix_set: kv.second) {
+            bytes += sizeof(*infix_set);
+            for(auto it = infix_set->begin(); it != infix_set->end(); ++it) {
+                it.key(infix_key);
+                bytes += infix_key.size() + sizeof(uint16_t);
+            }
+        }
+        field_bytes[kv.first]["infix_index"] += bytes;
+    }
+
+    for(const auto& kv: vector_index) {
+        field_bytes[kv.first]["hnsw_index"] += kv.second->memory_used();
+    }
+
+    nlohmann::json usage;
+    usage["structures"] = nlohmann::json::object();
+    usage["fields"] = nlohmann::json::object();
+
+    uint64_t total_bytes = seq_ids->memory_used();
+    usage["structures"]["seq_ids"] = total_bytes;
+
+    for(const auto& field_kv: field_bytes) {
+        uint64_t field_total_bytes = 0;
+        auto& field_usage = usage["fields"][field_kv.first];
+
+        for(const auto& structure_kv: field_kv.second) {
+            field_usage[structure_kv.first] = structure_kv.second;
+            field_total_bytes += structure_kv.second;
+
+            auto& structure_usage = usage["structures"][structure_kv.first];
+            structure_usage = structure_usage.is_null() ? structure_kv.second :
+                              structure_usage.get<uint64_t>() + structure_kv.second;
+        }
+
+        field_usage["total_bytes"] = field_total_bytes;
+        total_bytes += field_total_bytes;
+    }
+
+    usage["total_bytes"] = total_bytes;
+    return usage;
+}
+
 Option<bool> Index::seq_ids_outside_top_k(const std::string& field_name, size_t k,
                                           std::vector<uint32_t>& outside_seq_ids) {
     std::shared_lock lock(mutex);
@@ -7326,6 +8194,34 @@ bool Index::common_results_exist(std::vector<art_leaf*>& leaves, bool must_match
 }
 
 
+std::string Index::get_embedding_source(const field& embedding_field, const nlohmann::json& document,
+                                        const tsl::htrie_map<char, field>& search_schema,
+                                        const std::string& indexing_prefix, bool& is_image_embedding) {
+    std::string value = indexing_prefix;
+    const auto& embed_from = embedding_field.embed[fields::from].get<std::vector<std::string>>();
+    for(const auto& field_name : embed_from) {
+        auto field_it = search_schema.find(field_name);
+        auto doc_field_it = document.find(field_name);
+        if(doc_field_it == document.end()) {
+                continue;
+        }
+        if(field_it.value().type == field_types::IMAGE) {
+            is_image_embedding = true;
+            value = doc_field_it->get<std::string>();
+            continue;
+        }
+        if(field_it.value().type == field_types::STRING) {
+            value += doc_field_it->get<std::string>() + " ";
+        } else if(field_it.value().type == field_types::STRING_ARRAY) {
+            for(const auto& val : *(doc_field_it)) {
+                value += val.get<std::string>() + " ";
+            }
+        }
+    }
+
+    return value;
+}
+
 void Index::batch_embed_fields(std::vector<index_record*>& records, 
                                const tsl::htrie_map<char, field>& embedding_fields,
                                const tsl::htrie_map<char, field> & search_schema, const size_t remote_embedding_batch_size,
@@ -7354,27 +8250,23 @@ void Index::batch_embed_fields(std::vector<index_record*>& records,
                 continue;
             }
 
-            std::string value = indexing_prefix;
-            const auto& embed_from = field.embed[fields::from].get<std::vector<std::string>>();
-            for(const auto& field_name : embed_from) {
-                auto field_it = search_schema.find(field_name);
-                auto doc_field_it = document->find(field_name);
-                if(doc_field_it == document->end()) {
+            std::string value = get_embedding_source(field, *document, search_schema, indexing_prefix, is_image_embedding);
+
+            if(record->is_update) {
+                // The record is here because one of the collection's embedding sources changed, which need not be
+                // this field's. When this field's source text is the same as in the stored document, keep its vector.
+                auto old_embedding_it = record->old_doc.find(field.name);
+                if(old_embedding_it != record->old_doc.end() && old_embedding_it->is_array() &&
+                   !old_embedding_it->empty()) {
+                    bool old_is_image_embedding = false;
+                    const auto& old_value = get_embedding_source(field, record->old_doc, search_schema, indexing_prefix,
+                                                                 old_is_image_embedding);
+                    if(old_value == value) {
                         continue;
-                }
-                if(field_it.value().type == field_types::IMAGE) {
-                    is_image_embedding = true;
-                    value = doc_field_it->get<std::string>();
-                    continue;
-                }
-                if(field_it.value().type == field_types::STRING) {
-                    value += doc_field_it->get<std::string>() + " ";
-                } else if(field_it.value().type == field_types::STRING_ARRAY) {
-                    for(const auto& val : *(doc_field_it)) {
-                        value += val.get<std::string>() + " ";
                     }
                 }
             }
+
             if(value != indexing_prefix) {
                 values_to_embed.push_back(std::make_pair(record, value));
             }
@@ -0,0 +1,378 @@
+#include "int64_btree.h"
+#include <algorithm>
+#include <cstring>
+
+uint16_t int64_btree_t::lower_bound_index(const int64_t* keys, uint16_t count, int64_t key) {
+    if(count == 0) {
+        return 0;
+    }
+
+    // the comparison picks the next base without a branch, so the search costs log2(count) predictable steps
+    const int64_t* base = keys;
+    uint16_t n = count;
+
+    while(n > 1) {
+        const uint16_t half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+
+    return (base - keys) + (*base < key);
+}
+
+uint16_t int64_btree_t::upper_bound_index(const int64_t* keys, uint16_t count, int64_t key) {
+    if(count == 0) {
+        return 0;
+    }
+
+    const int64_t* base = keys;
+    uint16_t n = count;
+
+    while(n > 1) {
+        const uint16_t half = n / 2;
+        base = (base[half] <= key) ? base + half : base;
+        n -= half;
+    }
+
+    return (base - keys) + (*base <= key);
+}
+
+int64_btree_t::leaf_t* int64_btree_t::find_leaf(int64_t key) const {
+    node_t* node = root;
+    if(node == nullptr) {
+        return nullptr;
+    }
+
+    while(!node->is_leaf) {
+        auto inner = static_cast<inner_t*>(node);
+        node = inner->children[upper_bound_index(inner->keys, inner->count, key)];
+    }
+
+    return static_cast<leaf_t*>(node);
+}
+
+void** int64_btree_t::find(int64_t key) const {
+    leaf_t* leaf = find_leaf(key);
+    if(leaf == nullptr) {
+        return nullptr;
+    }
+
+    const uint16_t index = lower_bound_index(leaf->keys, leaf->count, key);
+    if(index == leaf->count || leaf->keys[index] != key) {
+        return nullptr;
+    }
+
+    return &leaf->values[index];
+}
+
+int64_btree_t::iterator_t int64_btree_t::lower_bound(int64_t key) const {
+    leaf_t* leaf = find_leaf(key);
+    if(leaf == nullptr) {
+        return end();
+    }
+
+    const uint16_t index = lower_bound_index(leaf->keys, leaf->count, key);
+    if(index == leaf->count) {
+        // every key of this leaf is smaller: the next leaf starts with the lower bound
+        return iterator_t(leaf->next, 0);
+    }
+
+    return iterator_t(leaf, index);
+}
+
+void int64_btree_t::insert(int64_t key, void* value) {
+    if(root == nullptr) {
+        auto leaf = new leaf_t();
+        num_leaves++;
+        root = head = tail = leaf;
+    }
+
+    int64_t split_key;
+    node_t* sibling = insert(root, key, value, split_key);
+    num_keys++;
+
+    if(sibling != nullptr) {
+        auto new_root = new inner_t();
+        num_inners++;
+
+        new_root->count = 1;
+        new_root->keys[0] = split_key;
+        new_root->children[0] = root;
+        new_root->children[1] = sibling;
+        root = new_root;
+    }
+}
+
+int64_btree_t::node_t* int64_btree_t::insert(node_t* node, int64_t key, void* value, int64_t& split_key) {
+    if(node->is_leaf) {
+        auto leaf = static_cast<leaf_t*>(node);
+        const uint16_t index = lower_bound_index(leaf->keys, leaf->count, key);
+
+        if(leaf->count < LEAF_CAPACITY) {
+            std::memmove(leaf->keys + index + 1, leaf->keys + index, (leaf->count - index) * sizeof(int64_t));
+            std::memmove(leaf->values + index + 1, leaf->values + index, (leaf->count - index) * sizeof(void*));
+            leaf->keys[index] = key;
+            leaf->values[index] = value;
+            leaf->count++;
+            return nullptr;
+        }
+
+        // full leaf: the upper half of the keys (including the new one) moves into a new right sibling
+        int64_t keys[LEAF_CAPACITY + 1];
+        void* values[LEAF_CAPACITY + 1];
+
+        std::copy(leaf->keys, leaf->keys + index, keys);
+        std::copy(leaf->values, leaf->values + index, values);
+        keys[index] = key;
+        values[index] = value;
+        std::copy(leaf->keys + index, leaf->keys + LEAF_CAPACITY, keys + index + 1);
+        std::copy(leaf->values + index, leaf->values + LEAF_CAPACITY, values + index + 1);
+
+        auto right = new leaf_t();
+        num_leaves++;
+
+        const uint16_t left_count = (LEAF_CAPACITY + 1) / 2;
+        const uint16_t right_count = LEAF_CAPACITY + 1 - left_count;
+
+        std::copy(keys, keys + left_count, leaf->keys);
+        std::copy(values, values + left_count, leaf->values);
+        leaf->count = left_count;
+
+        std::copy(keys + left_count, keys + LEAF_CAPACITY + 1, right->keys);
+        std::copy(values + left_count, values + LEAF_CAPACITY + 1, right->values);
+        right->count = right_count;
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if(leaf->next != nullptr) {
+            leaf->next->prev = right;
+        } else {
+            tail = right;
+        }
+        leaf->next = right;
+
+        split_key = right->keys[0];
+        return right;
+    }
+
+    auto inner = static_cast<inner_t*>(node);
+    const uint16_t child_index = upper_bound_index(inner->keys, inner->count, key);
+
+    int64_t child_split_key;
+    node_t* child_sibling = insert(inner->children[child_index], key, value, child_split_key);
+    if(child_sibling == nullptr) {
+        return nullptr;
+    }
+
+    if(inner->count < INNER_CAPACITY) {
+        std::memmove(inner->keys + child_index + 1, inner->keys + child_index,
+                     (inner->count - child_index) * sizeof(int64_t));
+        std::memmove(inner->children + child_index + 2, inner->children + child_index + 1,
+                     (inner->count - child_index) * sizeof(node_t*));
+        inner->keys[child_index] = child_split_key;
+        inner->children[child_index + 1] = child_sibling;
+        inner->count++;
+        return nullptr;
+    }
+
+    // full inner node: the middle key moves up and the keys after it move into a new right sibling
+    int64_t keys[INNER_CAPACITY + 1];
+    node_t* children[INNER_CAPACITY + 2];
+
+    std::copy(inner->keys, inner->keys + child_index, keys);
+    keys[child_index] = child_split_key;
+    std::copy(inner->keys + child_index, inner->keys + INNER_CAPACITY, keys + child_index + 1);
+
+    std::copy(inner->children, inner->children + child_index + 1, children);
+    children[child_index + 1] = child_sibling;
+    std::copy(inner->children + child_index + 1, inner->children + INNER_CAPACITY + 1, children + child_index + 2);
+
+    auto right = new inner_t();
+    num_inners++;
+
+    const uint16_t left_count = (INNER_CAPACITY + 1) / 2;
+    const uint16_t right_count = INNER_CAPACITY - left_count;
+
+    std::copy(keys, keys + left_count, inner->keys);
+    std::copy(children, children + left_count + 1, inner->children);
+    inner->count = left_count;
+
+    std::copy(keys + left_count + 1, keys + INNER_CAPACITY + 1, right->keys);
+    std::copy(children + left_count + 1, children + INNER_CAPACITY + 2, right->children);
+    right->count = right_count;
+
+    split_key = keys[left_count];
+    return right;
+}
+
+bool int64_btree_t::erase(int64_t key) {
+    if(root == nullptr) {
+        return false;
+    }
+
+    bool erased = false;
+    if(erase(root, key, erased)) {
+        root = nullptr;
+        head = tail = nullptr;
+    } else {
+        // collapse inner roots that are left with a single child
+        while(!root->is_leaf && root->count == 0) {
+            auto inner = static_cast<inner_t*>(root);
+            root = inner->children[0];
+            delete inner;
+            num_inners--;
+        }
+    }
+
+    if(erased) {
+        num_keys--;
+    }
+
+    return erased;
+}
+
+bool int64_btree_t::erase(node_t* node, int64_t key, bool& erased) {
+    if(node->is_leaf) {
+        auto leaf = static_cast<leaf_t*>(node);
+        const uint16_t index = lower_bound_index(leaf->keys, leaf->count, key);
+        if(index == leaf->count || leaf->keys[index] != key) {
+            return false;
+        }
+
+        std::memmove(leaf->keys + index, leaf->keys + index + 1, (leaf->count - index - 1) * sizeof(int64_t));
+        std::memmove(leaf->values + index, leaf->values + index + 1, (leaf->count - index - 1) * sizeof(void*));
+        leaf->count--;
+        erased = true;
+
+        if(leaf->count != 0) {
+            return false;
+        }
+
+        unlink_leaf(leaf);
+        delete leaf;
+        num_leaves--;
+        return true;
+    }
+
+    auto inner = static_cast<inner_t*>(node);
+    const uint16_t child_index = upper_bound_index(inner->keys, inner->count, key);
+
+    if(!erase(inner->children[child_index], key, erased)) {
+        return false;
+    }
+
+    if(inner->count == 0) {
+        // the only child is gone
+        delete inner;
+        num_inners--;
+        return true;
+    }
+
+    // drop the emptied child along with the separator on its left (or on its right, for the first child)
+    const uint16_t key_index = (child_index == 0) ? 0 : child_index - 1;
+    std::memmove(inner->keys + key_index, inner->keys + key_index + 1,
+                 (inner->count - key_index - 1) * sizeof(int64_t));
+    std::memmove(inner->children + child_index, inner->children + child_index + 1,
+                 (inner->count - child_index) * sizeof(node_t*));
+    inner->count--;
+
+    return false;
+}
+
+void int64_btree_t::unlink_leaf(leaf_t* leaf) {
+    if(leaf->prev != nullptr) {
+        leaf->prev->next = leaf->next;
+    } else {
+        head = leaf->next;
+    }
+
+    if(leaf->next != nullptr) {
+        leaf->next->prev = leaf->prev;
+    } else {
+        tail = leaf->prev;
+    }
+}
+
+void int64_btree_t::bulk_load(const std::vector<std::pair<int64_t, void*>>& sorted_kvs) {
+    if(sorted_kvs.empty()) {
+        return;
+    }
+
+    // lay out the leaves left to right, then build each inner level over the one below it
+    std::vector<node_t*> level;
+    std::vector<int64_t> level_min_keys;
+
+    for(size_t i = 0; i < sorted_kvs.size(); i += BULK_LOAD_LEAF_FILL) {
+        const size_t n = std::min<size_t>(BULK_LOAD_LEAF_FILL, sorted_kvs.size() - i);
+
+        auto leaf = new leaf_t();
+        num_leaves++;
+
+        for(size_t j = 0; j < n; j++) {
+            leaf->keys[j] = sorted_kvs[i + j].first;
+            leaf->values[j] = sorted_kvs[i + j].second;
+        }
+        leaf->count = n;
+
+        if(tail != nullptr) {
+            tail->next = leaf;
+            leaf->prev = tail;
+        } else {
+            head = leaf;
+        }
+        tail = leaf;
+
+        level.push_back(leaf);
+        level_min_keys.push_back(leaf->keys[0]);
+    }
+
+    while(level.size() > 1) {
+        std::vector<node_t*> parent_level;
+        std::vector<int64_t> parent_min_keys;
+
+        for(size_t i = 0; i < level.size(); i += INNER_CAPACITY + 1) {
+            const size_t n = std::min<size_t>(INNER_CAPACITY + 1, level.size() - i);
+
+            auto inner = new inner_t();
+            num_inners++;
+
+            inner->children[0] = level[i];
+            for(size_t j = 1; j < n; j++) {
+                inner->keys[j - 1] = level_min_keys[i + j];
+                inner->children[j] = level[i + j];
+            }
+            inner->count = n - 1;
+
+            parent_level.push_back(inner);
+            parent_min_keys.push_back(level_min_keys[i]);
+        }
+
+        level = std::move(parent_level);
+        level_min_keys = std::move(parent_min_keys);
+    }
+
+    root = level[0];
+    num_keys = sorted_kvs.size();
+}
+
+void int64_btree_t::destroy(node_t* node) {
+    if(node == nullptr) {
+        return;
+    }
+
+    if(node->is_leaf) {
+        delete static_cast<leaf_t*>(node);
+        return;
+    }
+
+    auto inner = static_cast<inner_t*>(node);
+    for(uint16_t i = 0; i <= inner->count; i++) {
+        destroy(inner->children[i]);
+    }
+
+    delete inner;
+}
+
+int64_btree_t::~int64_btree_t() {
+    destroy(root);
+}
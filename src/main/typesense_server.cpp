@@ -52,6 +52,7 @@ void master_server_routes() {
     server->get("/collections", get_collections);
     server->del("/collections/:collection", del_drop_collection);
     server->get("/collections/:collection", get_collection_summary);
+    server->get("/collections/:collection/memory", get_collection_memory);
 
     server->get("/aliases", get_aliases);
     server->get("/aliases/:alias", get_alias);
@@ -84,6 +85,8 @@ void master_server_routes() {
     // meta
     server->get("/metrics.json", get_metrics_json);
     server->get("/stats.json", get_stats_json);
+    server->get("/metrics", get_prometheus_metrics);
+    server->get("/memory.json", get_memory_json);
     server->get("/debug", get_debug);
     server->get("/health", get_health);
     server->get("/health_with_rusage", get_health_with_resource_usage);
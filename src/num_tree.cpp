@@ -3,34 +3,51 @@
 #include "timsort.hpp"
 
 void num_tree_t::insert(int64_t value, uint32_t id, bool is_facet) {
-    if (int64map.count(value) == 0) {
-        int64map.emplace(value, SET_COMPACT_IDS(compact_id_list_t::create(1, {id})));
-    } else {
-        auto ids = int64map[value];
-        if (!ids_t::contains(ids, id)) {
-            ids_t::upsert(ids, id);
-            int64map[value] = ids;
-        }
+    void** ids = int64tree.find(value);
+    if (ids == nullptr) {
+        int64tree.insert(value, SET_COMPACT_IDS(compact_id_list_t::create(1, {id})));
+    } else if (!ids_t::contains(*ids, id)) {
+        ids_t::upsert(*ids, id);
     }
 }
 
-void num_tree_t::range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len) {
-    if(int64map.empty()) {
-        return ;
+void num_tree_t::insert_batch(std::vector<std::pair<int64_t, uint32_t>>& value_ids) {
+    gfx::timsort(value_ids.begin(), value_ids.end());
+
+    if (!int64tree.empty()) {
+        for (const auto& value_id: value_ids) {
+            insert(value_id.first, value_id.second);
+        }
+        return;
     }
 
-    auto it_start = int64map.lower_bound(start);  // iter values will be >= start
+    std::vector<std::pair<int64_t, void*>> sorted_kvs;
+    std::vector<uint32_t> ids;
 
-    std::vector<uint32_t> consolidated_ids;
-    while(it_start != int64map.end() && it_start->first <= end) {
-        uint32_t* values = ids_t::uncompress(it_start->second);
+    for (size_t i = 0; i < value_ids.size();) {
+        const int64_t value = value_ids[i].first;
+        ids.clear();
 
-        for(size_t i = 0; i < ids_t::num_ids(it_start->second); i++) {
-            consolidated_ids.push_back(values[i]);
+        for (; i < value_ids.size() && value_ids[i].first == value; i++) {
+            if (ids.empty() || ids.back() != value_ids[i].second) {
+                ids.push_back(value_ids[i].second);
+            }
         }
 
-        delete [] values;
-        it_start++;
+        sorted_kvs.emplace_back(value, ids_t::create(ids));
+    }
+
+    int64tree.bulk_load(sorted_kvs);
+}
+
+void num_tree_t::range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len) {
+    if(int64tree.empty()) {
+        return ;
+    }
+
+    std::vector<uint32_t> consolidated_ids;
+    for(auto it = int64tree.lower_bound(start); it.valid() && it.key() <= end; it.next()) {
+        ids_t::uncompress(it.value(), consolidated_ids);
     }
 
     gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
@@ -44,28 +61,32 @@ void num_tree_t::range_inclusive_search(int64_t start, int64_t end, uint32_t** i
 }
 
 void num_tree_t::approx_range_inclusive_search_count(int64_t start, int64_t end, uint32_t& ids_len) {
-    if (int64map.empty()) {
+    if (int64tree.empty()) {
         return;
     }
 
-    auto it_start = int64map.lower_bound(start);  // iter values will be >= start
+    for (auto it = int64tree.lower_bound(start); it.valid() && it.key() <= end; it.next()) {
+        ids_len += ids_t::num_ids(it.value());
+    }
+}
 
-    while (it_start != int64map.end() && it_start->first <= end) {
-        uint32_t val_ids = ids_t::num_ids(it_start->second);
-        ids_len += val_ids;
-        it_start++;
+void num_tree_t::range_inclusive_for_each(int64_t start, int64_t end,
+                                          const std::function<void(int64_t, const std::vector<uint32_t>&)>& func) const {
+    std::vector<uint32_t> ids;
+    for (auto it = int64tree.lower_bound(start); it.valid() && it.key() <= end; it.next()) {
+        ids.clear();
+        ids_t::uncompress(it.value(), ids);
+        func(it.key(), ids);
     }
 }
 
 bool num_tree_t::range_inclusive_contains(const int64_t& start, const int64_t& end, const uint32_t& id) const {
-    if (int64map.empty()) {
+    if (int64tree.empty()) {
         return false;
     }
 
-    auto it_start = int64map.lower_bound(start);  // iter values will be >= start
-
-    while (it_start != int64map.end() && it_start->first <= end) {
-        if (ids_t::contains(it_start->second, id)) {
+    for (auto it = int64tree.lower_bound(start); it.valid() && it.key() <= end; it.next()) {
+        if (ids_t::contains(it.value(), id)) {
             return true;
         }
     }
@@ -78,7 +99,7 @@ void num_tree_t::range_inclusive_contains(const int64_t& start, const int64_t& e
                                           uint32_t* const& context_ids,
                                           size_t& result_ids_len,
                                           uint32_t*& result_ids) const {
-    if (int64map.empty()) {
+    if (int64tree.empty()) {
         return;
     }
 
@@ -99,53 +120,46 @@ void num_tree_t::range_inclusive_contains(const int64_t& start, const int64_t& e
 }
 
 size_t num_tree_t::get(int64_t value, std::vector<uint32_t>& geo_result_ids) {
-    const auto& it = int64map.find(value);
-    if(it == int64map.end()) {
+    void** ids = int64tree.find(value);
+    if(ids == nullptr) {
         return 0;
     }
 
-    uint32_t* ids = ids_t::uncompress(it->second);
-    for(size_t i = 0; i < ids_t::num_ids(it->second); i++) {
-        geo_result_ids.push_back(ids[i]);
-    }
-
-    delete [] ids;
-
-    return ids_t::num_ids(it->second);
+    ids_t::uncompress(*ids, geo_result_ids);
+    return ids_t::num_ids(*ids);
 }
 
 void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids, size_t& ids_len) {
-    if(int64map.empty()) {
+    if(int64tree.empty()) {
         return ;
     }
 
     if(comparator == EQUALS) {
-        const auto& it = int64map.find(value);
-        if(it != int64map.end()) {
+        void** value_ids = int64tree.find(value);
+        if(value_ids != nullptr) {
             uint32_t *out = nullptr;
-            uint32_t* val_ids = ids_t::uncompress(it->second);
-            ids_len = ArrayUtils::or_scalar(val_ids, ids_t::num_ids(it->second),
+            uint32_t* val_ids = ids_t::uncompress(*value_ids);
+            ids_len = ArrayUtils::or_scalar(val_ids, ids_t::num_ids(*value_ids),
                                             *ids, ids_len, &out);
             delete[] *ids;
             *ids = out;
             delete[] val_ids;
         }
     } else if(comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
-        // iter entries will be >= value, or end() if all entries are before value
-        auto iter_ge_value = int64map.lower_bound(value);
+        // iter entries will be >= value, or invalid if all entries are before value
+        auto iter_ge_value = int64tree.lower_bound(value);
 
-        if(iter_ge_value == int64map.end()) {
+        if(!iter_ge_value.valid()) {
             return ;
         }
 
-        if(comparator == GREATER_THAN && iter_ge_value->first == value) {
-            iter_ge_value++;
+        if(comparator == GREATER_THAN && iter_ge_value.key() == value) {
+            iter_ge_value.next();
         }
 
         std::vector<uint32_t> consolidated_ids;
-        while(iter_ge_value != int64map.end()) {
-            ids_t::uncompress(iter_ge_value->second, consolidated_ids);
-            iter_ge_value++;
+        for(; iter_ge_value.valid(); iter_ge_value.next()) {
+            ids_t::uncompress(iter_ge_value.value(), consolidated_ids);
         }
 
         gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
@@ -159,20 +173,12 @@ void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids
         *ids = out;
 
     } else if(comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
-        // iter entries will be >= value, or end() if all entries are before value
-        auto iter_ge_value = int64map.lower_bound(value);
-
         std::vector<uint32_t> consolidated_ids;
-        auto it = int64map.begin();
-
-        while(it != iter_ge_value) {
-            ids_t::uncompress(it->second, consolidated_ids);
-            it++;
-        }
 
-        // for LESS_THAN_EQUALS, check if last iter entry is equal to value
-        if(it != int64map.end() && comparator == LESS_THAN_EQUALS && it->first == value) {
-            ids_t::uncompress(it->second, consolidated_ids);
+        // for LESS_THAN_EQUALS, the entry equal to value is included
+        for(auto it = int64tree.begin(); it.valid() &&
+                (it.key() < value || (comparator == LESS_THAN_EQUALS && it.key() == value)); it.next()) {
+            ids_t::uncompress(it.value(), consolidated_ids);
         }
 
         gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
@@ -188,50 +194,36 @@ void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids
 }
 
 uint32_t num_tree_t::approx_search_count(NUM_COMPARATOR comparator, int64_t value) {
-    if (int64map.empty()) {
+    if (int64tree.empty()) {
         return 0;
     }
 
     uint32_t ids_len = 0;
     if (comparator == EQUALS) {
-        const auto& it = int64map.find(value);
-        if (it != int64map.end()) {
-            uint32_t val_ids = ids_t::num_ids(it->second);
-            ids_len += val_ids;
+        void** value_ids = int64tree.find(value);
+        if (value_ids != nullptr) {
+            ids_len += ids_t::num_ids(*value_ids);
         }
     } else if (comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
-        // iter entries will be >= value, or end() if all entries are before value
-        auto iter_ge_value = int64map.lower_bound(value);
+        // iter entries will be >= value, or invalid if all entries are before value
+        auto iter_ge_value = int64tree.lower_bound(value);
 
-        if (iter_ge_value == int64map.end()) {
+        if (!iter_ge_value.valid()) {
             return 0;
         }
 
-        if (comparator == GREATER_THAN && iter_ge_value->first == value) {
-            iter_ge_value++;
+        if (comparator == GREATER_THAN && iter_ge_value.key() == value) {
+            iter_ge_value.next();
         }
 
-        while (iter_ge_value != int64map.end()) {
-            uint32_t val_ids = ids_t::num_ids(iter_ge_value->second);
-            ids_len += val_ids;
-            iter_ge_value++;
+        for (; iter_ge_value.valid(); iter_ge_value.next()) {
+            ids_len += ids_t::num_ids(iter_ge_value.value());
         }
     } else if (comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
-        // iter entries will be >= value, or end() if all entries are before value
-        auto iter_ge_value = int64map.lower_bound(value);
-
-        auto it = int64map.begin();
-
-        while (it != iter_ge_value) {
-            uint32_t val_ids = ids_t::num_ids(it->second);
-            ids_len += val_ids;
-            it++;
-        }
-
-        // for LESS_THAN_EQUALS, check if last iter entry is equal to value
-        if (it != int64map.end() && comparator == LESS_THAN_EQUALS && it->first == value) {
-            uint32_t val_ids = ids_t::num_ids(it->second);
-            ids_len += val_ids;
+        // for LESS_THAN_EQUALS, the entry equal to value is included
+        for (auto it = int64tree.begin(); it.valid() &&
+                (it.key() < value || (comparator == LESS_THAN_EQUALS && it.key() == value)); it.next()) {
+            ids_len += ids_t::num_ids(it.value());
         }
     }
 
@@ -239,16 +231,16 @@ uint32_t num_tree_t::approx_search_count(NUM_COMPARATOR comparator, int64_t valu
 }
 
 void num_tree_t::remove(uint64_t value, uint32_t id) {
-    if(int64map.count(value) != 0) {
-        void* arr = int64map[value];
-        ids_t::erase(arr, id);
-
-        if(ids_t::num_ids(arr) == 0) {
-            ids_t::destroy_list(arr);
-            int64map.erase(value);
-        } else {
-            int64map[value] = arr;
-        }
+    void** ids = int64tree.find(value);
+    if(ids == nullptr) {
+        return;
+    }
+
+    ids_t::erase(*ids, id);
+
+    if(ids_t::num_ids(*ids) == 0) {
+        ids_t::destroy_list(*ids);
+        int64tree.erase(value);
     }
 }
 
@@ -257,7 +249,7 @@ void num_tree_t::contains(const NUM_COMPARATOR& comparator, const int64_t& value
                           uint32_t* const& context_ids,
                           size_t& result_ids_len,
                           uint32_t*& result_ids) const {
-    if (int64map.empty()) {
+    if (int64tree.empty()) {
         return;
     }
 
@@ -269,40 +261,28 @@ void num_tree_t::contains(const NUM_COMPARATOR& comparator, const int64_t& value
                 consolidated_ids.push_back(context_ids[i]);
             }
         } else if (comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
-            // iter entries will be >= value, or end() if all entries are before value
-            auto iter_ge_value = int64map.lower_bound(value);
+            // iter entries will be >= value, or invalid if all entries are before value
+            auto iter_ge_value = int64tree.lower_bound(value);
 
-            if (iter_ge_value == int64map.end()) {
+            if (!iter_ge_value.valid()) {
                 continue;
             }
 
-            if (comparator == GREATER_THAN && iter_ge_value->first == value) {
-                iter_ge_value++;
+            if (comparator == GREATER_THAN && iter_ge_value.key() == value) {
+                iter_ge_value.next();
             }
 
-            while (iter_ge_value != int64map.end()) {
-                if (contains(iter_ge_value->first, context_ids[i])) {
+            for (; iter_ge_value.valid(); iter_ge_value.next()) {
+                if (ids_t::contains(iter_ge_value.value(), context_ids[i])) {
                     consolidated_ids.push_back(context_ids[i]);
                     break;
                 }
-                iter_ge_value++;
             }
         } else if(comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
-            // iter entries will be >= value, or end() if all entries are before value
-            auto iter_ge_value = int64map.lower_bound(value);
-            auto it = int64map.begin();
-
-            while (it != iter_ge_value) {
-                if (contains(it->first, context_ids[i])) {
-                    consolidated_ids.push_back(context_ids[i]);
-                    break;
-                }
-                it++;
-            }
-
-            // for LESS_THAN_EQUALS, check if last iter entry is equal to value
-            if (it != int64map.end() && comparator == LESS_THAN_EQUALS && it->first == value) {
-                if (contains(it->first, context_ids[i])) {
+            // for LESS_THAN_EQUALS, the entry equal to value is included
+            for (auto it = int64tree.begin(); it.valid() &&
+                    (it.key() < value || (comparator == LESS_THAN_EQUALS && it.key() == value)); it.next()) {
+                if (ids_t::contains(it.value(), context_ids[i])) {
                     consolidated_ids.push_back(context_ids[i]);
                     break;
                 }
@@ -324,14 +304,14 @@ void num_tree_t::contains(const NUM_COMPARATOR& comparator, const int64_t& value
 void num_tree_t::seq_ids_outside_top_k(size_t k, std::vector<uint32_t> &seq_ids) {
     size_t ids_skipped = 0;
 
-    for (auto iter = int64map.rbegin(); iter != int64map.rend(); ++iter) {
-        auto num_ids = ids_t::num_ids(iter->second);
+    for (auto iter = int64tree.last(); iter.valid(); iter.prev()) {
+        auto num_ids = ids_t::num_ids(iter.value());
         if(ids_skipped > k) {
-            ids_t::uncompress(iter->second, seq_ids);
+            ids_t::uncompress(iter.value(), seq_ids);
         } else if((ids_skipped + num_ids) > k) {
             // this element hits the limit, so we pick partial IDs to satisfy k
             std::vector<uint32_t> ids;
-            ids_t::uncompress(iter->second, ids);
+            ids_t::uncompress(iter.value(), ids);
             for(size_t i = 0; i < ids.size(); i++) {
                 auto seq_id = ids[i];
                 if(ids_skipped + i >= k) {
@@ -347,17 +327,17 @@ void num_tree_t::seq_ids_outside_top_k(size_t k, std::vector<uint32_t> &seq_ids)
 std::pair<int64_t, int64_t> num_tree_t::get_min_max(const uint32_t* result_ids, size_t result_ids_len) {
     int64_t min, max;
     //first traverse from top to find min
-    for(auto int64map_it = int64map.begin(); int64map_it != int64map.end(); ++int64map_it) {
-        if(ids_t::intersect_count(int64map_it->second, result_ids, result_ids_len)) {
-            min = int64map_it->first;
+    for(auto it = int64tree.begin(); it.valid(); it.next()) {
+        if(ids_t::intersect_count(it.value(), result_ids, result_ids_len)) {
+            min = it.key();
             break;
         }
     }
 
     //traverse from end to find max
-    for(auto int64map_it = int64map.rbegin(); int64map_it != int64map.rend(); ++int64map_it) {
-        if(ids_t::intersect_count(int64map_it->second, result_ids, result_ids_len)) {
-            max = int64map_it->first;
+    for(auto it = int64tree.last(); it.valid(); it.prev()) {
+        if(ids_t::intersect_count(it.value(), result_ids, result_ids_len)) {
+            max = it.key();
             break;
         }
     }
@@ -366,28 +346,37 @@ std::pair<int64_t, int64_t> num_tree_t::get_min_max(const uint32_t* result_ids,
 }
 
 size_t num_tree_t::size() {
-    return int64map.size();
+    return int64tree.size();
+}
+
+size_t num_tree_t::memory_used() const {
+    size_t bytes = sizeof(num_tree_t) + int64tree.memory_used();
+    for(auto it = int64tree.begin(); it.valid(); it.next()) {
+        bytes += ids_t::memory_used(it.value());
+    }
+
+    return bytes;
 }
 
 num_tree_t::~num_tree_t() {
-    for(auto& kv: int64map) {
-        ids_t::destroy_list(kv.second);
+    for(auto it = int64tree.begin(); it.valid(); it.next()) {
+        ids_t::destroy_list(it.value());
     }
 }
 
 num_tree_t::iterator_t::iterator_t(num_tree_t* num_tree, NUM_COMPARATOR comparator, int64_t value) {
-    if (num_tree == nullptr || num_tree->int64map.empty() || comparator != EQUALS) {
+    if (num_tree == nullptr || num_tree->int64tree.empty() || comparator != EQUALS) {
         is_valid = false;
         return;
     }
 
-    const auto& it = num_tree->int64map.find(value);
-    if (it == num_tree->int64map.end()) {
+    void** ids = num_tree->int64tree.find(value);
+    if (ids == nullptr) {
         is_valid = false;
         return;
     }
 
-    auto obj = it->second;
+    auto obj = *ids;
     is_compact_id_list = IS_COMPACT_IDS(obj);
     if (is_compact_id_list) {
         id_list_array_len = ids_t::num_ids(obj);
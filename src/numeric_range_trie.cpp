@@ -1,4 +1,5 @@
 #include <timsort.hpp>
+#include <algorithm>
 #include <set>
 #include "numeric_range_trie.h"
 #include "array_utils.h"
@@ -436,6 +437,34 @@ size_t NumericTrie::size() {
     return size;
 }
 
+size_t NumericTrie::memory_used() const {
+    size_t bytes = sizeof(NumericTrie);
+    if (negative_trie != nullptr) {
+        bytes += negative_trie->memory_used();
+    }
+    if (positive_trie != nullptr) {
+        bytes += positive_trie->memory_used();
+    }
+
+    return bytes;
+}
+
+size_t NumericTrie::Node::memory_used() const {
+    size_t bytes = sizeof(Node) + ids_t::memory_used(seq_ids);
+    if (children == nullptr) {
+        return bytes;
+    }
+
+    bytes += EXPANSE * sizeof(Node*);
+    for (auto i = 0; i < EXPANSE; i++) {
+        if (children[i] != nullptr) {
+            bytes += children[i]->memory_used();
+        }
+    }
+
+    return bytes;
+}
+
 
 inline int64_t indexable_limit(const char& max_level) {
     switch (max_level) {
@@ -944,28 +973,104 @@ void NumericTrie::Node::get_all_ids(std::vector<uint32_t>& result) {
     ids_t::uncompress(seq_ids, result);
 }
 
+NumericTrie::iterator_t::match_state::match_state(void* seq_ids): seq_ids(seq_ids) {
+    reset();
+}
+
+void NumericTrie::iterator_t::match_state::reset() {
+    index = 0;
+    if (!IS_COMPACT_IDS(seq_ids)) {
+        id_list_it = ((id_list_t*)(seq_ids))->new_iterator();
+    }
+}
+
+bool NumericTrie::iterator_t::match_state::valid() const {
+    if (IS_COMPACT_IDS(seq_ids)) {
+        return index < COMPACT_IDS_PTR(seq_ids)->length;
+    }
+
+    return id_list_it.valid();
+}
+
+uint32_t NumericTrie::iterator_t::match_state::id() const {
+    if (IS_COMPACT_IDS(seq_ids)) {
+        return COMPACT_IDS_PTR(seq_ids)->ids[index];
+    }
+
+    return id_list_it.id();
+}
+
+void NumericTrie::iterator_t::match_state::next() {
+    if (IS_COMPACT_IDS(seq_ids)) {
+        index++;
+        return;
+    }
+
+    id_list_it.next();
+}
+
+void NumericTrie::iterator_t::match_state::skip_to(uint32_t id) {
+    if (IS_COMPACT_IDS(seq_ids)) {
+        auto const list = COMPACT_IDS_PTR(seq_ids);
+        ArrayUtils::skip_index_to_id(index, list->ids, list->length, id);
+        return;
+    }
+
+    id_list_it.skip_to(id);
+}
+
+void NumericTrie::iterator_t::build_heap() {
+    heap.clear();
+    for (auto& match: matches) {
+        if (match->valid()) {
+            heap.push_back(match);
+        }
+    }
+
+    std::make_heap(heap.begin(), heap.end(), heap_compare);
+}
+
 void NumericTrie::iterator_t::reset() {
     for (auto& match: matches) {
-        match->index = 0;
+        match->reset();
     }
 
-    is_valid = true;
+    build_heap();
     set_seq_id();
 }
 
 void NumericTrie::iterator_t::skip_to(uint32_t id) {
-    for (auto& match: matches) {
-        ArrayUtils::skip_index_to_id(match->index, match->ids, match->ids_length, id);
+    // Only the matches that are behind `id` have to move.
+    while (!heap.empty() && heap.front()->id() < id) {
+        std::pop_heap(heap.begin(), heap.end(), heap_compare);
+        auto match = heap.back();
+
+        match->skip_to(id);
+        if (match->valid()) {
+            std::push_heap(heap.begin(), heap.end(), heap_compare);
+        } else {
+            heap.pop_back();
+        }
     }
 
     set_seq_id();
 }
 
 void NumericTrie::iterator_t::next() {
-    // Advance all the matches at seq_id.
-    for (auto& match: matches) {
-        if (match->index < match->ids_length && match->ids[match->index] == seq_id) {
-            match->index++;
+    if (!is_valid) {
+        return;
+    }
+
+    // Advance all the matches at seq_id, an id can be present in more than one match in case of array fields.
+    while (!heap.empty() && heap.front()->id() == seq_id) {
+        std::pop_heap(heap.begin(), heap.end(), heap_compare);
+        auto match = heap.back();
+
+        match->next();
+        if (match->valid()) {
+            std::push_heap(heap.begin(), heap.end(), heap_compare);
+        } else {
+            heap.pop_back();
         }
     }
 
@@ -974,37 +1079,23 @@ void NumericTrie::iterator_t::next() {
 
 NumericTrie::iterator_t::iterator_t(std::vector<Node*>& node_matches) {
     for (auto const& node_match: node_matches) {
-        uint32_t* ids = nullptr;
-        uint32_t ids_length;
-        node_match->get_all_ids(ids, ids_length);
+        auto seq_ids = node_match->get_seq_ids();
+        auto ids_length = ids_t::num_ids(seq_ids);
         if (ids_length > 0) {
-            matches.emplace_back(new match_state(ids, ids_length));
+            matches.emplace_back(new match_state(seq_ids));
+            approx_filter_ids_length += ids_length;
         }
     }
 
+    build_heap();
     set_seq_id();
 }
 
 void NumericTrie::iterator_t::set_seq_id() {
-    // Find the lowest id of all the matches and update the seq_id.
-    bool one_is_valid = false;
-    uint32_t lowest_id = UINT32_MAX;
-
-    for (auto& match: matches) {
-        if (match->index < match->ids_length) {
-            one_is_valid = true;
-
-            if (match->ids[match->index] < lowest_id) {
-                lowest_id = match->ids[match->index];
-            }
-        }
+    is_valid = !heap.empty();
+    if (is_valid) {
+        seq_id = heap.front()->id();
     }
-
-    if (one_is_valid) {
-        seq_id = lowest_id;
-    }
-
-    is_valid = one_is_valid;
 }
 
 NumericTrie::iterator_t& NumericTrie::iterator_t::operator=(NumericTrie::iterator_t&& obj) noexcept {
@@ -1017,8 +1108,13 @@ NumericTrie::iterator_t& NumericTrie::iterator_t::operator=(NumericTrie::iterato
     matches.clear();
 
     matches = std::move(obj.matches);
+    heap = std::move(obj.heap);
+    obj.matches.clear();
+    obj.heap.clear();
+
     seq_id = obj.seq_id;
     is_valid = obj.is_valid;
+    approx_filter_ids_length = obj.approx_filter_ids_length;
 
     return *this;
 }
@@ -295,3 +295,136 @@ nlohmann::json override_t::to_json() const {
 
     return override;
 }
+
+bool OverrideIndex::is_tags_only(const override_t& override) {
+    return override.rule.query.empty() && override.rule.match.empty() && override.rule.filter_by.empty();
+}
+
+bool OverrideIndex::split_phrase(const std::string& phrase, std::vector<std::string>& tokens) {
+    StringUtils::split(phrase, tokens, " ");
+    // phrases that don't survive a round trip cannot be matched token-wise
+    return !tokens.empty() && StringUtils::join(tokens, " ") == phrase;
+}
+
+void OverrideIndex::add(const override_t& override) {
+    const auto& rule = override.rule;
+    std::vector<std::string> tokens;
+
+    if(rule.dynamic_query || !override.filter_by.empty()) {
+        unconditional_ids.insert(override.id);
+    } else if(is_tags_only(override)) {
+        if(rule.tags.size() == 1 && *rule.tags.begin() == "*") {
+            wildcard_tag_ids.insert(override.id);
+        }
+    } else if(rule.query.empty() && rule.match.empty()) {
+        filter_index[rule.filter_by].insert(override.id);
+    } else if(rule.match == override_t::MATCH_EXACT && !rule.normalized_query.empty()) {
+        exact_index[rule.normalized_query].insert(override.id);
+    } else if(rule.match == override_t::MATCH_CONTAINS && split_phrase(rule.normalized_query, tokens)) {
+        token_node_t* node = &contains_root;
+        for(const auto& token: tokens) {
+            auto& child = node->children[token];
+            if(child == nullptr) {
+                child = std::make_unique<token_node_t>();
+            }
+            node = child.get();
+        }
+        node->override_ids.insert(override.id);
+    } else {
+        unconditional_ids.insert(override.id);
+    }
+}
+
+bool OverrideIndex::remove_phrase(token_node_t* node, const std::vector<std::string>& tokens, size_t index,
+                                  const std::string& id) {
+    if(index == tokens.size()) {
+        node->override_ids.erase(id);
+    } else {
+        auto child_it = node->children.find(tokens[index]);
+        if(child_it == node->children.end()) {
+            return false;
+        }
+
+        if(remove_phrase(child_it->second.get(), tokens, index + 1, id)) {
+            node->children.erase(child_it);
+        }
+    }
+
+    // tells the parent whether this node can be pruned
+    return node->override_ids.empty() && node->children.empty();
+}
+
+void OverrideIndex::remove(const override_t& override) {
+    const auto& rule = override.rule;
+
+    unconditional_ids.erase(override.id);
+    wildcard_tag_ids.erase(override.id);
+
+    auto filter_it = filter_index.find(rule.filter_by);
+    if(filter_it != filter_index.end()) {
+        filter_it->second.erase(override.id);
+        if(filter_it->second.empty()) {
+            filter_index.erase(filter_it);
+        }
+    }
+
+    auto exact_it = exact_index.find(rule.normalized_query);
+    if(exact_it != exact_index.end()) {
+        exact_it->second.erase(override.id);
+        if(exact_it->second.empty()) {
+            exact_index.erase(exact_it);
+        }
+    }
+
+    std::vector<std::string> tokens;
+    if(split_phrase(rule.normalized_query, tokens)) {
+        remove_phrase(&contains_root, tokens, 0, override.id);
+    }
+}
+
+void OverrideIndex::collect_contains(const std::vector<std::string>& tokens,
+                                     std::set<std::string>& override_ids) const {
+    for(size_t i = 0; i < tokens.size(); i++) {
+        const token_node_t* node = &contains_root;
+        for(size_t j = i; j < tokens.size(); j++) {
+            auto child_it = node->children.find(tokens[j]);
+            if(child_it == node->children.end()) {
+                break;
+            }
+
+            node = child_it->second.get();
+            override_ids.insert(node->override_ids.begin(), node->override_ids.end());
+        }
+    }
+}
+
+void OverrideIndex::collect_all(const token_node_t* node, std::set<std::string>& override_ids) {
+    override_ids.insert(node->override_ids.begin(), node->override_ids.end());
+    for(const auto& child: node->children) {
+        collect_all(child.second.get(), override_ids);
+    }
+}
+
+void OverrideIndex::get_candidates(const std::string& query, const std::string& filter_query,
+                                   std::set<std::string>& override_ids) const {
+    override_ids.insert(unconditional_ids.begin(), unconditional_ids.end());
+    override_ids.insert(wildcard_tag_ids.begin(), wildcard_tag_ids.end());
+
+    auto exact_it = exact_index.find(query);
+    if(exact_it != exact_index.end()) {
+        override_ids.insert(exact_it->second.begin(), exact_it->second.end());
+    }
+
+    auto filter_it = filter_index.find(filter_query);
+    if(filter_it != filter_index.end()) {
+        override_ids.insert(filter_it->second.begin(), filter_it->second.end());
+    }
+
+    std::vector<std::string> tokens;
+    if(split_phrase(query, tokens)) {
+        collect_contains(tokens, override_ids);
+    } else if(!query.empty()) {
+        // can't walk the trie reliably, so every `contains` rule is a candidate
+        collect_all(&contains_root, override_ids);
+    }
+}
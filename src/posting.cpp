@@ -183,6 +183,10 @@ uint32_t compact_posting_list_t::num_ids() const {
     return ids_length;
 }
 
+size_t compact_posting_list_t::memory_used() const {
+    return sizeof(compact_posting_list_t) + (capacity * sizeof(uint32_t));
+}
+
 uint32_t compact_posting_list_t::first_id() {
     if(length == 0) {
         return 0;
@@ -342,6 +346,16 @@ uint32_t posting_t::num_ids(const void* obj) {
     }
 }
 
+size_t posting_t::memory_used(const void* obj) {
+    if(IS_COMPACT_POSTING(obj)) {
+        compact_posting_list_t* list = COMPACT_POSTING_PTR(obj);
+        return list->memory_used();
+    } else {
+        posting_list_t* list = (posting_list_t*)(obj);
+        return list->memory_used();
+    }
+}
+
 uint32_t posting_t::first_id(const void* obj) {
     if(IS_COMPACT_POSTING(obj)) {
         compact_posting_list_t* list = COMPACT_POSTING_PTR(obj);
@@ -2,6 +2,7 @@
 #include <bitset>
 #include "for.h"
 #include "array_utils.h"
+#include "memory_usage.h"
 #include "filter_result_iterator.h"
 
 /* block_t operations */
@@ -1076,6 +1077,20 @@ size_t posting_list_t::num_ids() const {
     return ids_length;
 }
 
+size_t posting_list_t::memory_used() const {
+    size_t bytes = sizeof(posting_list_t) + tree_map_memory_used(id_block_map);
+
+    for(const block_t* block = &root_block; block != nullptr; block = block->next) {
+        if(block != &root_block) {
+            bytes += sizeof(block_t);
+        }
+
+        bytes += block->ids.getSizeInBytes() + block->offset_index.getSizeInBytes() + block->offsets.getSizeInBytes();
+    }
+
+    return bytes;
+}
+
 bool posting_list_t::contains(uint32_t id) {
     const auto it = id_block_map.lower_bound(id);
 
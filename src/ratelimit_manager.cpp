@@ -17,42 +17,59 @@ void RateLimitManager::temp_ban_entity(const rate_limit_entity_t& entity, const
 }
 
 bool RateLimitManager::is_rate_limited(const rate_limit_entity_t& api_key_entity, const rate_limit_entity_t& ip_entity) {
-    // lock mutex
-    std::unique_lock<std::shared_mutex>lock(rate_limit_mutex);
-    std::vector<rate_limit_rule_t*> rules_bucket;
-
-    // get wildcard rules
-    fill_bucket(WILDCARD_IP, api_key_entity, rules_bucket);
-    fill_bucket(WILDCARD_API_KEY, ip_entity, rules_bucket);
+    if(num_rules == 0) {
+        return false;
+    }
 
-    // get rules for the IP entity
-    fill_bucket(ip_entity, api_key_entity, rules_bucket);
+    // rules and throttles are only read here, so concurrent requests share the lock
+    std::shared_lock<std::shared_mutex> lock(rate_limit_mutex);
 
-    // get rules for the API key entity
-    fill_bucket(api_key_entity, ip_entity, rules_bucket);
+    auto rule = get_top_rule(api_key_entity, ip_entity);
+    if(rule == nullptr) {
+        return false;
+    }
 
-    if(rules_bucket.empty()) {
+    if(rule->action == RateLimitAction::block) {
+        return true;
+    }
+    else if(rule->action == RateLimitAction::allow) {
         return false;
     }
 
-    // sort rules_bucket by priority in ascending order
-    std::sort(rules_bucket.begin(), rules_bucket.end(), [](rate_limit_rule_t* rule1, rate_limit_rule_t* rule2) {
-        return rule1->priority < rule2->priority;
-    });
+    bool auto_ban = false;
+    bool rate_limited = false;
 
-    // get the rule with the highest priority
-    auto& rule = *rules_bucket.front();
     // get key for throttling if exists
     auto throttle_key = get_throttle_key(ip_entity, api_key_entity);
 
-    if(rule.action == RateLimitAction::block) {
-        return true;
+    if(!throttle_key.ok()) {
+        rate_limited = count_request(*rule, get_request_counter_key(*rule, ip_entity, api_key_entity), auto_ban);
+        if(!auto_ban) {
+            return rate_limited;
+        }
     }
-    else if(rule.action == RateLimitAction::allow) {
+
+    // lifting an expired throttle or adding a new one needs exclusive access
+    lock.unlock();
+    std::unique_lock<std::shared_mutex> exclusive_lock(rate_limit_mutex);
+
+    // rules could have changed in the meantime
+    rule = get_top_rule(api_key_entity, ip_entity);
+    if(rule == nullptr || rule->action == RateLimitAction::allow) {
         return false;
+    } else if(rule->action == RateLimitAction::block) {
+        return true;
+    }
+
+    auto request_counter_key = get_request_counter_key(*rule, ip_entity, api_key_entity);
+
+    if(auto_ban) {
+        temp_ban_entity_wrapped(request_counter_key.substr(0, request_counter_key.find("_")) == ".*" ? WILDCARD_API_KEY : api_key_entity, rule->auto_ban_1m_duration_hours, (request_counter_key.substr((request_counter_key.find("_") + 1)) == ".*" && !rule->apply_limit_per_entity) ? nullptr : &ip_entity);
+        return rate_limited;
     }
 
     // check if any throttle exists and still valid
+    throttle_key = get_throttle_key(ip_entity, api_key_entity);
     while(throttle_key.ok()) {
         auto key = throttle_key.get();
         // Check ifban duration is not over
@@ -64,67 +81,99 @@ bool RateLimitManager::is_rate_limited(const rate_limit_entity_t& api_key_entity
         store->remove(ban_key);
         // Remove ban
         throttled_entities.erase(key);
-        rate_limit_exceeds.erase(key);
         // Reset request counts
-        auto& request_counts = rate_limit_request_counts.lookup(key);
-        request_counts.reset();
+        auto& shard = get_request_counter_shard(key);
+        {
+            std::unique_lock<std::mutex> shard_lock(shard.mutex);
+            shard.exceeds.erase(key);
+            if(!shard.request_counts.contains(key)) {
+                shard.request_counts.insert(key, request_counter_t{});
+            }
+            shard.request_counts.lookup(key).reset();
+        }
         // Get next throttle key if exists
         throttle_key = get_throttle_key(ip_entity, api_key_entity);
     }
 
-    // get request counter key according to rule type
-    auto request_counter_key = get_request_counter_key(rule, ip_entity, api_key_entity);
-    
-    if(!rate_limit_request_counts.contains(request_counter_key)){
-        rate_limit_request_counts.insert(request_counter_key, request_counter_t{});
+    rate_limited = count_request(*rule, request_counter_key, auto_ban);
+    if(auto_ban) {
+        temp_ban_entity_wrapped(request_counter_key.substr(0, request_counter_key.find("_")) == ".*" ? WILDCARD_API_KEY : api_key_entity, rule->auto_ban_1m_duration_hours, (request_counter_key.substr((request_counter_key.find("_") + 1)) == ".*" && !rule->apply_limit_per_entity) ? nullptr : &ip_entity);
     }
-    auto& request_counts = rate_limit_request_counts.lookup(request_counter_key);
+
+    return rate_limited;
+}
+
+const rate_limit_rule_t* RateLimitManager::get_top_rule(const rate_limit_entity_t& api_key_entity, const rate_limit_entity_t& ip_entity) {
+    const rate_limit_rule_t* top_rule = nullptr;
+
+    // get wildcard rules
+    fill_bucket(WILDCARD_IP, api_key_entity, top_rule);
+    fill_bucket(WILDCARD_API_KEY, ip_entity, top_rule);
+
+    // get rules for the IP entity
+    fill_bucket(ip_entity, api_key_entity, top_rule);
+
+    // get rules for the API key entity
+    fill_bucket(api_key_entity, ip_entity, top_rule);
+
+    return top_rule;
+}
+
+request_counter_shard_t& RateLimitManager::get_request_counter_shard(const std::string& request_counter_key) {
+    return request_counter_shards[std::hash<std::string>()(request_counter_key) % NUM_REQUEST_COUNTER_SHARDS];
+}
+
+bool RateLimitManager::count_request(const rate_limit_rule_t& rule, const std::string& request_counter_key, bool& auto_ban) {
+    auto& shard = get_request_counter_shard(request_counter_key);
+    std::unique_lock<std::mutex> shard_lock(shard.mutex);
+
+    if(!shard.request_counts.contains(request_counter_key)){
+        shard.request_counts.insert(request_counter_key, request_counter_t{});
+    }
+    auto& request_counts = shard.request_counts.lookup(request_counter_key);
+    const auto current_time = get_current_time();
     // Check iflast reset time was more than 1 minute ago
-    if(request_counts.last_reset_time_minute <= get_current_time() - 60) {
+    if(request_counts.last_reset_time_minute <= current_time - 60) {
         request_counts.previous_requests_count_minute = request_counts.current_requests_count_minute;
         request_counts.current_requests_count_minute = 0;
-        if(request_counts.last_reset_time_minute <= get_current_time() - 120) {
+        if(request_counts.last_reset_time_minute <= current_time - 120) {
             request_counts.previous_requests_count_minute = 0;
         }
-        request_counts.last_reset_time_minute = get_current_time();
+        request_counts.last_reset_time_minute = current_time;
     }
     // Check iflast reset time was more than 1 hour ago
-    if(request_counts.last_reset_time_hour <= get_current_time() - 3600) {
+    if(request_counts.last_reset_time_hour <= current_time - 3600) {
         request_counts.previous_requests_count_hour = request_counts.current_requests_count_hour;
         request_counts.current_requests_count_hour = 0;
-        if(request_counts.last_reset_time_hour <= get_current_time() - 7200) {
+        if(request_counts.last_reset_time_hour <= current_time - 7200) {
             request_counts.previous_requests_count_hour = 0;
         }
-        request_counts.last_reset_time_hour = get_current_time();
+        request_counts.last_reset_time_hour = current_time;
     }
     // Check if request count is over the limit
-    auto current_rate_for_minute = (60 - (get_current_time() - request_counts.last_reset_time_minute)) / 60  * request_counts.previous_requests_count_minute;
+    auto current_rate_for_minute = (60 - (current_time - request_counts.last_reset_time_minute)) / 60  * request_counts.previous_requests_count_minute;
     current_rate_for_minute += request_counts.current_requests_count_minute;
     if(rule.max_requests.minute_threshold >= 0 && current_rate_for_minute >= rule.max_requests.minute_threshold) {
         bool auto_ban_is_enabled = (rule.auto_ban_1m_threshold > 0 && rule.auto_ban_1m_duration_hours > 0);
         // If key is not in exceed map that means, it is a new exceed, not a continued exceed
-        if(rate_limit_exceeds.count(request_counter_key) == 0) {
-            rate_limit_exceeds.insert({request_counter_key, rate_limit_exceed_t{last_throttle_id++, request_counter_key, 1}});
+        if(shard.exceeds.count(request_counter_key) == 0) {
+            shard.exceeds.insert({request_counter_key, rate_limit_exceed_t{last_throttle_id++, request_counter_key, 1}});
             request_counts.threshold_exceed_count_minute++;
         } else {
             // else it is a continued exceed, so just increment the request count
-            rate_limit_exceeds[request_counter_key].request_count++;
+            shard.exceeds[request_counter_key].request_count++;
         }
         // If auto ban is enabled, check if threshold is exceeded
-        if(auto_ban_is_enabled) {
-            if(request_counts.threshold_exceed_count_minute > rule.auto_ban_1m_threshold) {
-                temp_ban_entity_wrapped(request_counter_key.substr(0, request_counter_key.find("_")) == ".*" ? WILDCARD_API_KEY : api_key_entity, rule.auto_ban_1m_duration_hours, (request_counter_key.substr((request_counter_key.find("_") + 1)) == ".*" && !rule.apply_limit_per_entity) ? nullptr : &ip_entity);
-            }
-        } 
+        auto_ban = auto_ban_is_enabled && request_counts.threshold_exceed_count_minute > rule.auto_ban_1m_threshold;
         return true;
     }
-    auto current_rate_for_hour = (3600 - (get_current_time() - request_counts.last_reset_time_hour)) / 3600  * request_counts.previous_requests_count_hour;
+    auto current_rate_for_hour = (3600 - (current_time - request_counts.last_reset_time_hour)) / 3600  * request_counts.previous_requests_count_hour;
     current_rate_for_hour += request_counts.current_requests_count_hour;
     if(rule.max_requests.hour_threshold >= 0 && current_rate_for_hour >= rule.max_requests.hour_threshold) {
-        if(rate_limit_exceeds.count(request_counter_key) == 0) {
-            rate_limit_exceeds.insert({request_counter_key, rate_limit_exceed_t{last_throttle_id++, request_counter_key, 1}});
+        if(shard.exceeds.count(request_counter_key) == 0) {
+            shard.exceeds.insert({request_counter_key, rate_limit_exceed_t{last_throttle_id++, request_counter_key, 1}});
         } else {
-            rate_limit_exceeds[request_counter_key].request_count++;
+            shard.exceeds[request_counter_key].request_count++;
         }
         return true;
     }
@@ -132,8 +181,8 @@ bool RateLimitManager::is_rate_limited(const rate_limit_entity_t& api_key_entity
     request_counts.current_requests_count_minute++;
     request_counts.current_requests_count_hour++;
     // If key is in exceed map that means, it is no longer exceed, so remove it from the map
-    if(rate_limit_exceeds.count(request_counter_key) > 0) {
-        rate_limit_exceeds.erase(request_counter_key);
+    if(shard.exceeds.count(request_counter_key) > 0) {
+        shard.exceeds.erase(request_counter_key);
     }
     return false;
 }
@@ -168,6 +217,7 @@ bool RateLimitManager::delete_rule_by_id(const uint64_t id) {
         }
         // Remove rule from rule store
         rule_store.erase(id);
+        num_rules = rule_store.size();
         for(auto it = rate_limit_entities.begin(); it != rate_limit_entities.end(); ) {
             if(it->second.empty()) {
                 it = rate_limit_entities.erase(it);
@@ -220,11 +270,15 @@ const std::vector<rate_limit_status_t> RateLimitManager::get_banned_entities(con
 
 void RateLimitManager::clear_all() {
     std::unique_lock<std::shared_mutex> lock(rate_limit_mutex);
-    rate_limit_request_counts.clear();
+    for(auto& shard: request_counter_shards) {
+        std::unique_lock<std::mutex> shard_lock(shard.mutex);
+        shard.request_counts.clear();
+        shard.exceeds.clear();
+    }
     rate_limit_entities.clear();
     throttled_entities.clear();
-    rate_limit_exceeds.clear();
     rule_store.clear();
+    num_rules = 0;
     last_rule_id = 0;
     last_ban_id = 0;
     base_timestamp = 0;
@@ -243,10 +297,12 @@ void RateLimitManager::temp_ban_entity_wrapped(const rate_limit_entity_t& entity
     store->insert(ban_key, status.to_json().dump());
     throttled_entities.insert({key, status});
     last_ban_id++;
-    if(rate_limit_request_counts.contains(key)){
+    auto& shard = get_request_counter_shard(key);
+    std::unique_lock<std::mutex> shard_lock(shard.mutex);
+    if(shard.request_counts.contains(key)){
         // Reset counters for the given entity
-        rate_limit_request_counts.lookup(key).current_requests_count_minute = 0;
-        rate_limit_request_counts.lookup(key).current_requests_count_hour = 0;
+        shard.request_counts.lookup(key).current_requests_count_minute = 0;
+        shard.request_counts.lookup(key).current_requests_count_hour = 0;
     }
 }
 
@@ -487,6 +543,7 @@ void RateLimitManager::insert_rule(const rate_limit_rule_t &rule) {
     for(const auto &entity : rule.entities) {
         rate_limit_entities[entity].push_back(&rule_store[rule.id]);
     }
+    num_rules = rule_store.size();
 }
 
 
@@ -614,8 +671,11 @@ const std::string RateLimitManager::get_request_counter_key(const rate_limit_rul
 const nlohmann::json RateLimitManager::get_exceeded_entities_json() {
     std::shared_lock<std::shared_mutex> lock(rate_limit_mutex);
     nlohmann::json exceeded_entities_json = nlohmann::json::array();
-    for(const auto& entity: rate_limit_exceeds) {
-        exceeded_entities_json.push_back(entity.second.to_json());
+    for(auto& shard: request_counter_shards) {
+        std::unique_lock<std::mutex> shard_lock(shard.mutex);
+        for(const auto& entity: shard.exceeds) {
+            exceeded_entities_json.push_back(entity.second.to_json());
+        }
     }
     return exceeded_entities_json;
 }
@@ -658,17 +718,17 @@ bool RateLimitManager::delete_ban_by_id(const uint64_t id) {
     return true;
 }
 
-void RateLimitManager::fill_bucket(const rate_limit_entity_t& target_entity, const rate_limit_entity_t& other_entity, std::vector<rate_limit_rule_t*> &rules_bucket) {
+void RateLimitManager::fill_bucket(const rate_limit_entity_t& target_entity, const rate_limit_entity_t& other_entity, const rate_limit_rule_t*& top_rule) {
     auto it = rate_limit_entities.find(target_entity);
     if(it == rate_limit_entities.end()) {
         return;
     }
     for(const auto& rule: it->second) {
-            // Skip if rule already exists in bucket
-            if(std::find(rules_bucket.begin(), rules_bucket.end(), rule) != rules_bucket.end()) {
+            // Skip if the rule does not have a higher priority (lower value) than the current top rule
+            if(top_rule != nullptr && top_rule->priority <= rule->priority) {
                 continue;
             }
-            // Add the rule only If:
+            // Pick the rule only If:
             // A. it has no entity with type of other_entity
             // B. it has an entity with type of other_entity and it's value is equal to other_entity's value
             // C. it has an entity with type of other_entity and it's value is equal to ".*"
@@ -677,32 +737,28 @@ void RateLimitManager::fill_bucket(const rate_limit_entity_t& target_entity, con
                 if(entity.entity_type == other_entity.entity_type) {
                     has_other_entity = true;
                     if(entity.entity_id == other_entity.entity_id || entity.entity_id == ".*") {
-                        rules_bucket.push_back(rule);
+                        top_rule = rule;
                     }
                 }
             }
             if(!has_other_entity) {
-                rules_bucket.push_back(rule);
+                top_rule = rule;
         }
     }
 }
 
 bool RateLimitManager::delete_throttle_by_id(const uint32_t id) {
     std::unique_lock<std::shared_mutex> lock(rate_limit_mutex);
-    bool flag = false;
-    decltype(rate_limit_exceeds)::iterator iterator;
-    for(auto it = rate_limit_exceeds.begin(); it != rate_limit_exceeds.end(); it++) {
-        if(it->second.rule_id == id) {
-            flag = true;
-            iterator = it;
-            break;
+    for(auto& shard: request_counter_shards) {
+        std::unique_lock<std::mutex> shard_lock(shard.mutex);
+        for(auto it = shard.exceeds.begin(); it != shard.exceeds.end(); it++) {
+            if(it->second.rule_id == id) {
+                shard.request_counts.erase(it->first);
+                shard.exceeds.erase(it);
+                return true;
+            }
         }
     }
-    if(!flag) {
-        return false;
-    }
-    rate_limit_request_counts.erase(iterator->first);
-    rate_limit_exceeds.erase(iterator);
-    return true;
+    return false;
 }
 
@@ -0,0 +1,40 @@
+#include "search_profile.h"
+#include "app_metrics.h"
+
+void search_profile_t::add_token_candidates(nlohmann::json&& candidates) {
+    if(token_candidates.size() >= MAX_TOKEN_CANDIDATES) {
+        num_dropped_token_candidates++;
+        return ;
+    }
+
+    token_candidates.push_back(std::move(candidates));
+}
+
+nlohmann::json search_profile_t::to_json() const {
+    nlohmann::json profile;
+
+    // serialization of the response happens only after the profile is rendered
+    profile["stages_us"] = nlohmann::json::object();
+    for(size_t i = 0; i < SEARCH_STAGE_SERIALIZATION; i++) {
+        profile["stages_us"][AppMetrics::SEARCH_STAGE_NAMES[i]] = search_stage_us[i];
+    }
+
+    profile["filter"] = filter_tree.is_null() ? nlohmann::json::object() : filter_tree;
+
+    profile["token_candidates"] = token_candidates;
+    if(num_dropped_token_candidates != 0) {
+        profile["num_dropped_token_candidates"] = num_dropped_token_candidates;
+    }
+
+    profile["scoring"] = {
+        {"time_us", scoring_time_us},
+        {"num_candidates", search_num_scored_candidates}
+    };
+
+    profile["facets"] = nlohmann::json::array();
+    for(const auto& facet_time: facet_times_us) {
+        profile["facets"].push_back({{"field", facet_time.first}, {"time_us", facet_time.second}});
+    }
+
+    return profile;
+}
@@ -0,0 +1,108 @@
+#include "slow_query_log.h"
+#include "logger.h"
+#include <cstdio>
+
+void SlowQueryLog::init(const std::string& path, size_t max_file_size_bytes) {
+    std::unique_lock lk(mutex);
+    this->log_path = path;
+    this->max_file_size_bytes = max_file_size_bytes;
+    quit = false;
+}
+
+bool SlowQueryLog::is_enabled() const {
+    std::unique_lock lk(mutex);
+    return !log_path.empty();
+}
+
+bool SlowQueryLog::log(std::string&& record) {
+    {
+        std::unique_lock lk(mutex);
+        if(log_path.empty() || quit) {
+            return false;
+        }
+
+        if(pending_records.size() >= MAX_PENDING_RECORDS) {
+            num_dropped_records++;
+            return false;
+        }
+
+        pending_records.push_back(std::move(record));
+    }
+
+    cv.notify_one();
+    return true;
+}
+
+size_t SlowQueryLog::get_num_dropped_records() const {
+    return num_dropped_records;
+}
+
+void SlowQueryLog::open_log_file() {
+    log_file.open(log_path, std::ofstream::out | std::ofstream::app);
+    if(!log_file.is_open()) {
+        LOG(ERROR) << "Unable to open slow query log at " << log_path;
+        log_file_size = 0;
+        return ;
+    }
+
+    log_file.seekp(0, std::ios::end);
+    log_file_size = log_file.tellp();
+}
+
+void SlowQueryLog::rotate() {
+    log_file.close();
+
+    for(size_t i = NUM_ROTATED_FILES; i > 0; i--) {
+        const std::string src = (i == 1) ? log_path : log_path + "." + std::to_string(i - 1);
+        const std::string dest = log_path + "." + std::to_string(i);
+        std::rename(src.c_str(), dest.c_str());
+    }
+
+    open_log_file();
+}
+
+void SlowQueryLog::write_records(std::deque<std::string>& records) {
+    if(!log_file.is_open()) {
+        open_log_file();
+    }
+
+    for(auto& record: records) {
+        if(log_file_size != 0 && log_file_size + record.size() + 1 > max_file_size_bytes) {
+            rotate();
+        }
+
+        log_file << record << "\n";
+        log_file_size += record.size() + 1;
+    }
+
+    log_file << std::flush;
+    records.clear();
+}
+
+void SlowQueryLog::run() {
+    std::deque<std::string> records;
+
+    while(true) {
+        std::unique_lock lk(mutex);
+        cv.wait(lk, [&] { return quit.load() || !pending_records.empty(); });
+
+        if(pending_records.empty()) {
+            // quit was requested and everything that was queued has been written
+            break;
+        }
+
+        records.swap(pending_records);
+        lk.unlock();
+
+        write_records(records);
+    }
+
+    if(log_file.is_open()) {
+        log_file.close();
+    }
+}
+
+void SlowQueryLog::stop() {
+    quit = true;
+    cv.notify_all();
+}
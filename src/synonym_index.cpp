@@ -9,21 +9,24 @@ void SynonymIndex::synonym_reduction_internal(const std::vector<std::string>& to
 
     bool recursed = false;
 
-    for(size_t window_len = start_window_size; window_len > 0; window_len--) {
-        for(size_t start_index = start_index_pos; start_index+window_len-1 < tokens.size(); start_index++) {
-            std::vector<uint64_t> syn_hashes;
-            uint64_t syn_hash = 1;
+    // every window is hashed from the same token hashes, so compute them only once
+    std::vector<uint64_t> token_hashes(tokens.size());
+    for(size_t i = 0; i < tokens.size(); i++) {
+        token_hashes[i] = StringUtils::hash_wy(tokens[i].c_str(), tokens[i].size());
+    }
 
-            for(size_t i = start_index; i < start_index+window_len; i++) {
-                uint64_t token_hash = StringUtils::hash_wy(tokens[i].c_str(), tokens[i].size());
+    if(start_window_size > max_phrase_len) {
+        // windows longer than the longest synonym phrase cannot match anything
+        start_window_size = max_phrase_len;
+        start_index_pos = 0;
+    }
 
-                if(i == start_index) {
-                    syn_hash = token_hash;
-                } else {
-                    syn_hash = StringUtils::hash_combine(syn_hash, token_hash);
-                }
+    for(size_t window_len = start_window_size; window_len > 0; window_len--) {
+        for(size_t start_index = start_index_pos; start_index+window_len-1 < tokens.size(); start_index++) {
+            uint64_t syn_hash = token_hashes[start_index];
 
-                syn_hashes.push_back(token_hash);
+            for(size_t i = start_index + 1; i < start_index+window_len; i++) {
+                syn_hash = StringUtils::hash_combine(syn_hash, token_hashes[i]);
             }
 
             const auto& syn_itr = synonym_index.find(syn_hash);
@@ -71,8 +74,8 @@ void SynonymIndex::synonym_reduction_internal(const std::vector<std::string>& to
                             processed_syn_hashes.emplace(h);
                         }
 
-                        for (uint64_t h: syn_hashes) {
-                            processed_syn_hashes.emplace(h);
+                        for (size_t i = start_index; i < start_index + window_len; i++) {
+                            processed_syn_hashes.emplace(token_hashes[i]);
                         }
 
                         recursed = true;
@@ -99,8 +102,42 @@ void SynonymIndex::synonym_reduction(const std::vector<std::string>& tokens,
         return;
     }
 
+    std::string cache_key;
+    for(const auto& token: tokens) {
+        cache_key += token;
+        cache_key += '\x1f';
+    }
+
+    {
+        std::unique_lock cache_lock(cache_mutex);
+        if(synonym_cache.contains(cache_key)) {
+            const auto& cached_results = synonym_cache.lookup(cache_key);
+            results.insert(results.end(), cached_results.begin(), cached_results.end());
+            return;
+        }
+    }
+
     std::set<uint64_t> processed_syn_hashes;
-    synonym_reduction_internal(tokens, tokens.size(), 0, processed_syn_hashes, results, tokens);
+    std::vector<std::vector<std::string>> syn_results;
+    synonym_reduction_internal(tokens, tokens.size(), 0, processed_syn_hashes, syn_results, tokens);
+
+    {
+        std::unique_lock cache_lock(cache_mutex);
+        synonym_cache.insert(cache_key, syn_results);
+    }
+
+    results.insert(results.end(), syn_results.begin(), syn_results.end());
+}
+
+void SynonymIndex::update_max_phrase_len() {
+    max_phrase_len = 0;
+    for(const auto& syn_def_kv: synonym_definitions) {
+        const auto& syn_def = syn_def_kv.second;
+        max_phrase_len = std::max(max_phrase_len, syn_def.root.size());
+        for(const auto& syn_tokens: syn_def.synonyms) {
+            max_phrase_len = std::max(max_phrase_len, syn_tokens.size());
+        }
+    }
 }
 
 Option<bool> SynonymIndex::add_synonym(const std::string & collection_name, const synonym_t& synonym,
@@ -128,6 +165,16 @@ Option<bool> SynonymIndex::add_synonym(const std::string & collection_name, cons
         }
     }
 
+    max_phrase_len = std::max(max_phrase_len, synonym.root.size());
+    for(const auto& syn_tokens : synonym.synonyms) {
+        max_phrase_len = std::max(max_phrase_len, syn_tokens.size());
+    }
+
+    {
+        std::unique_lock cache_lock(cache_mutex);
+        synonym_cache.clear();
+    }
+
     write_lock.unlock();
 
     if(write_to_store) {
@@ -173,6 +220,11 @@ Option<bool> SynonymIndex::remove_synonym(const std::string & collection_name, c
         }
 
         synonym_definitions.erase(id);
+        update_max_phrase_len();
+
+        std::unique_lock cache_lock(cache_mutex);
+        synonym_cache.clear();
+
         return Option<bool>(true);
     }
 
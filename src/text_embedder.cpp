@@ -1,6 +1,7 @@
 #include "text_embedder.h"
 #include "embedder_manager.h"
 #include "logger.h"
+#include "tsconfig.h"
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -49,6 +50,7 @@ TextEmbedder::TextEmbedder(const std::string& model_name) {
         tokenizer_ = std::make_unique<CLIPTokenizerWrapper>(vocab_path);
         output_tensor_name = "text_embeds";
         num_dim = 512;
+        batch_scheduler_ = std::thread(&TextEmbedder::run_batch_scheduler, this);
         return;
     }
     auto output_tensor_count = session_->GetOutputCount();
@@ -61,6 +63,8 @@ TextEmbedder::TextEmbedder(const std::string& model_name) {
             break;
         }
     }
+
+    batch_scheduler_ = std::thread(&TextEmbedder::run_batch_scheduler, this);
 }
 
 TextEmbedder::TextEmbedder(const nlohmann::json& model_config, size_t num_dims, const bool has_custom_dims) {
@@ -120,10 +124,168 @@ std::vector<float> TextEmbedder::mean_pooling(const std::vector<std::vector<floa
 embedding_res_t TextEmbedder::Embed(const std::string& text, const size_t remote_embedder_timeout_ms, const size_t remote_embedding_num_tries) {
     if(is_remote()) {
         return remote_embedder_->Embed(text, remote_embedder_timeout_ms, remote_embedding_num_tries);
-    } else {
+    }
+
+    if(Config::get_instance().get_local_embedding_max_batch_size() <= 1 || !batch_scheduler_.joinable()) {
         // Cannot run same model in parallel, so lock the mutex
         std::lock_guard<std::mutex> lock(mutex_);
-        auto encoded_input = tokenizer_->Encode(text);
+        return embed_local(text);
+    }
+
+    auto pending = std::make_shared<pending_embedding_t>();
+    pending->text = text;
+    auto result = pending->result.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_embeddings_.push_back(pending);
+    }
+
+    pending_cv_.notify_one();
+    return result.get();
+}
+
+void TextEmbedder::run_batch_scheduler() {
+    size_t last_batch_size = 0;
+
+    while(true) {
+        std::vector<std::shared_ptr<pending_embedding_t>> batch;
+
+        {
+            std::unique_lock<std::mutex> lock(pending_mutex_);
+            pending_cv_.wait(lock, [&] { return quit_scheduler_ || !pending_embeddings_.empty(); });
+
+            if(quit_scheduler_ && pending_embeddings_.empty()) {
+                return;
+            }
+
+            const size_t max_batch_size = std::max<size_t>(Config::get_instance().get_local_embedding_max_batch_size(), 1);
+
+            // A lone query is run right away. Once queries start to overlap, the next batch waits a little
+            // for more of them, bounded by the configured wait so that the latency budget is not exceeded.
+            if(last_batch_size > 1 && pending_embeddings_.size() < max_batch_size) {
+                const auto wait_us = std::chrono::microseconds(Config::get_instance().get_local_embedding_batch_wait_us());
+                pending_cv_.wait_for(lock, wait_us, [&] {
+                    return quit_scheduler_ || pending_embeddings_.size() >= max_batch_size;
+                });
+            }
+
+            while(!pending_embeddings_.empty() && batch.size() < max_batch_size) {
+                batch.push_back(std::move(pending_embeddings_.front()));
+                pending_embeddings_.pop_front();
+            }
+        }
+
+        last_batch_size = batch.size();
+
+        std::vector<std::string> inputs;
+        inputs.reserve(batch.size());
+        for(const auto& pending: batch) {
+            inputs.push_back(pending->text);
+        }
+
+        std::vector<embedding_res_t> outputs;
+
+        try {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outputs = (batch.size() == 1) ? std::vector<embedding_res_t>{embed_local(inputs[0])} :
+                                            batch_embed_local(inputs, batch.size());
+        } catch(const std::exception& e) {
+            LOG(ERROR) << "Error while embedding a batch of " << batch.size() << " queries: " << e.what();
+        }
+
+        for(size_t i = 0; i < batch.size(); i++) {
+            if(i < outputs.size()) {
+                batch[i]->result.set_value(std::move(outputs[i]));
+            } else {
+                batch[i]->result.set_value(embedding_res_t(500, nlohmann::json({{"error", "Failed to embed query."}})));
+            }
+        }
+    }
+}
+
+embedding_res_t TextEmbedder::embed_local(const std::string& text) {
+    auto encoded_input = tokenizer_->Encode(text);
+    // create input tensor object from data values
+    Ort::AllocatorWithDefaultOptions allocator;
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    std::vector<Ort::Value> input_tensors;
+    std::vector<std::vector<int64_t>> input_shapes;
+    std::vector<const char*> input_node_names = {"input_ids", "attention_mask"};
+    // If model is DistilBERT or sentencepiece, it has 2 inputs, else it has 3 inputs
+    if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
+        input_node_names.push_back("token_type_ids");
+    } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
+        input_node_names.push_back("pixel_values");
+    }
+    input_shapes.push_back({1, static_cast<int64_t>(encoded_input.input_ids.size())});
+    input_shapes.push_back({1, static_cast<int64_t>(encoded_input.attention_mask.size())});
+    if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
+        // edge case: xlm_roberta does not have token_type_ids, but if the model has it as input, we need to fill it with 0s
+        if(encoded_input.token_type_ids.size() == 0) {
+            encoded_input.token_type_ids.resize(encoded_input.input_ids.size(), 0);
+        }
+
+        input_shapes.push_back({1, static_cast<int64_t>(encoded_input.token_type_ids.size())});
+    } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
+        // dummy input for clip
+        input_shapes.push_back({1, 3, 224, 224});
+    }
+    input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.input_ids.data(), encoded_input.input_ids.size(), input_shapes[0].data(), input_shapes[0].size()));
+    input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.attention_mask.data(), encoded_input.attention_mask.size(), input_shapes[1].data(), input_shapes[1].size()));
+    if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
+        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.token_type_ids.data(), encoded_input.token_type_ids.size(), input_shapes[2].data(), input_shapes[2].size()));
+    } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
+        // dummy input for clip
+        std::vector<float> pixel_values(3 * 224 * 224, 0.5);
+        input_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info, pixel_values.data(), pixel_values.size(), input_shapes[2].data(), input_shapes[2].size()));
+    }
+
+    //LOG(INFO) << "Running model";
+    // create output tensor object
+    std::vector<const char*> output_node_names = {output_tensor_name.c_str()};
+    auto output_tensor = session_->Run(Ort::RunOptions{nullptr}, input_node_names.data(), input_tensors.data(), input_tensors.size(), output_node_names.data(), output_node_names.size());
+    std::vector<std::vector<float>> output;
+    float* data = output_tensor[0].GetTensorMutableData<float>();
+    // print output tensor shape
+    auto shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
+    // edge case for clip model
+    if(shape.size() == 2) {
+        // insert 1 to index 0
+        shape.insert(shape.begin(), 1);
+    }
+
+    for (int i = 0; i < shape[1]; i++) {
+        std::vector<float> temp;
+        for (int j = 0; j < shape[2]; j++) {
+            temp.push_back(data[i * shape[2] + j]);
+        }
+        // edge case for clip model
+        if(tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
+            return embedding_res_t(temp);
+        }
+        output.push_back(temp);
+    }
+    auto pooled_output = mean_pooling(output, encoded_input.attention_mask);
+    return embedding_res_t(pooled_output);
+}
+
+std::vector<embedding_res_t> TextEmbedder::batch_embed(const std::vector<std::string>& inputs, const size_t remote_embedding_batch_size,
+                                                       const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries) {
+    if(!is_remote()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batch_embed_local(inputs, 8);
+    }
+
+    return remote_embedder_->batch_embed(inputs, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries);
+}
+
+std::vector<embedding_res_t> TextEmbedder::batch_embed_local(const std::vector<std::string>& inputs, const size_t batch_size) {
+    std::vector<embedding_res_t> outputs;
+    for(size_t i = 0; i < inputs.size(); i += batch_size) {
+        auto input_batch = std::vector<std::string>(inputs.begin() + i, inputs.begin() + std::min(i + batch_size, inputs.size()));
+        auto encoded_inputs = batch_encode(input_batch);
+        
         // create input tensor object from data values
         Ort::AllocatorWithDefaultOptions allocator;
         Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
@@ -136,23 +298,44 @@ embedding_res_t TextEmbedder::Embed(const std::string& text, const size_t remote
         } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
             input_node_names.push_back("pixel_values");
         }
-        input_shapes.push_back({1, static_cast<int64_t>(encoded_input.input_ids.size())});
-        input_shapes.push_back({1, static_cast<int64_t>(encoded_input.attention_mask.size())});
-        if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-            // edge case: xlm_roberta does not have token_type_ids, but if the model has it as input, we need to fill it with 0s
-            if(encoded_input.token_type_ids.size() == 0) {
-                encoded_input.token_type_ids.resize(encoded_input.input_ids.size(), 0);
-            }
 
-            input_shapes.push_back({1, static_cast<int64_t>(encoded_input.token_type_ids.size())});
+        input_shapes.push_back({static_cast<int64_t>(encoded_inputs.input_ids.size()), static_cast<int64_t>(encoded_inputs.input_ids[0].size())});
+        input_shapes.push_back({static_cast<int64_t>(encoded_inputs.attention_mask.size()), static_cast<int64_t>(encoded_inputs.attention_mask[0].size())});
+        if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
+            input_shapes.push_back({static_cast<int64_t>(encoded_inputs.token_type_ids.size()), static_cast<int64_t>(encoded_inputs.token_type_ids[0].size())});
         } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
             // dummy input for clip
             input_shapes.push_back({1, 3, 224, 224});
         }
-        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.input_ids.data(), encoded_input.input_ids.size(), input_shapes[0].data(), input_shapes[0].size()));
-        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.attention_mask.data(), encoded_input.attention_mask.size(), input_shapes[1].data(), input_shapes[1].size()));
+
+        std::vector<int64_t> input_ids_flatten;
+        std::vector<int64_t> attention_mask_flatten;
+        std::vector<int64_t> token_type_ids_flatten;
+
+        for (int i = 0; i < encoded_inputs.input_ids.size(); i++) {
+            for (int j = 0; j < encoded_inputs.input_ids[i].size(); j++) {
+                input_ids_flatten.push_back(encoded_inputs.input_ids[i][j]);
+            }
+        }
+
+        for (int i = 0; i < encoded_inputs.attention_mask.size(); i++) {
+            for (int j = 0; j < encoded_inputs.attention_mask[i].size(); j++) {
+                attention_mask_flatten.push_back(encoded_inputs.attention_mask[i][j]);
+            }
+        }
+
+        if(session_->GetInputCount() == 3) {
+            for (int i = 0; i < encoded_inputs.token_type_ids.size(); i++) {
+                for (int j = 0; j < encoded_inputs.token_type_ids[i].size(); j++) {
+                    token_type_ids_flatten.push_back(encoded_inputs.token_type_ids[i][j]);
+                }
+            }
+        }
+
+        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, input_ids_flatten.data(), input_ids_flatten.size(), input_shapes[0].data(), input_shapes[0].size()));
+        input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, attention_mask_flatten.data(), attention_mask_flatten.size(), input_shapes[1].data(), input_shapes[1].size()));
         if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-            input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, encoded_input.token_type_ids.data(), encoded_input.token_type_ids.size(), input_shapes[2].data(), input_shapes[2].size()));
+            input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, token_type_ids_flatten.data(), token_type_ids_flatten.size(), input_shapes[2].data(), input_shapes[2].size()));
         } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
             // dummy input for clip
             std::vector<float> pixel_values(3 * 224 * 224, 0.5);
@@ -162,8 +345,16 @@ embedding_res_t TextEmbedder::Embed(const std::string& text, const size_t remote
         //LOG(INFO) << "Running model";
         // create output tensor object
         std::vector<const char*> output_node_names = {output_tensor_name.c_str()};
+
+        // if seq length is 0, return empty vector
+        if(input_shapes[0][1] == 0) {
+            for(int i = 0; i < input_batch.size(); i++) {
+                outputs.push_back(embedding_res_t(400, nlohmann::json({{"error", "Invalid input: empty sequence"}})));
+            }
+            continue;
+        }
+
         auto output_tensor = session_->Run(Ort::RunOptions{nullptr}, input_node_names.data(), input_tensors.data(), input_tensors.size(), output_node_names.data(), output_node_names.size());
-        std::vector<std::vector<float>> output;
         float* data = output_tensor[0].GetTensorMutableData<float>();
         // print output tensor shape
         auto shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
@@ -172,137 +363,42 @@ embedding_res_t TextEmbedder::Embed(const std::string& text, const size_t remote
             // insert 1 to index 0
             shape.insert(shape.begin(), 1);
         }
-
-        for (int i = 0; i < shape[1]; i++) {
-            std::vector<float> temp;
-            for (int j = 0; j < shape[2]; j++) {
-                temp.push_back(data[i * shape[2] + j]);
-            }
-            // edge case for clip model
-            if(tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
-                return embedding_res_t(temp);
-            }
-            output.push_back(temp);
-        }
-        auto pooled_output = mean_pooling(output, encoded_input.attention_mask);
-        return embedding_res_t(pooled_output);
-    }
-}
-
-std::vector<embedding_res_t> TextEmbedder::batch_embed(const std::vector<std::string>& inputs, const size_t remote_embedding_batch_size,
-                                                       const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries) {
-    std::vector<embedding_res_t> outputs;
-    if(!is_remote()) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for(int i = 0; i < inputs.size(); i += 8) {
-            auto input_batch = std::vector<std::string>(inputs.begin() + i, inputs.begin() + std::min(i + 8, static_cast<int>(inputs.size())));
-            auto encoded_inputs = batch_encode(input_batch);
-            
-            // create input tensor object from data values
-            Ort::AllocatorWithDefaultOptions allocator;
-            Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-            std::vector<Ort::Value> input_tensors;
-            std::vector<std::vector<int64_t>> input_shapes;
-            std::vector<const char*> input_node_names = {"input_ids", "attention_mask"};
-            // If model is DistilBERT or sentencepiece, it has 2 inputs, else it has 3 inputs
-            if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-                input_node_names.push_back("token_type_ids");
-            } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
-                input_node_names.push_back("pixel_values");
-            }
-
-            input_shapes.push_back({static_cast<int64_t>(encoded_inputs.input_ids.size()), static_cast<int64_t>(encoded_inputs.input_ids[0].size())});
-            input_shapes.push_back({static_cast<int64_t>(encoded_inputs.attention_mask.size()), static_cast<int64_t>(encoded_inputs.attention_mask[0].size())});
-            if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-                input_shapes.push_back({static_cast<int64_t>(encoded_inputs.token_type_ids.size()), static_cast<int64_t>(encoded_inputs.token_type_ids[0].size())});
-            } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
-                // dummy input for clip
-                input_shapes.push_back({1, 3, 224, 224});
-            }
-
-            std::vector<int64_t> input_ids_flatten;
-            std::vector<int64_t> attention_mask_flatten;
-            std::vector<int64_t> token_type_ids_flatten;
-
-            for (int i = 0; i < encoded_inputs.input_ids.size(); i++) {
-                for (int j = 0; j < encoded_inputs.input_ids[i].size(); j++) {
-                    input_ids_flatten.push_back(encoded_inputs.input_ids[i][j]);
+        for (int i = 0; i < shape[0]; i++) {
+            std::vector<std::vector<float>> output;
+            for (int j = 0; j < shape[1]; j++) {
+                std::vector<float> output_row;
+                for (int k = 0; k < shape[2]; k++) {
+                    output_row.push_back(data[i * shape[1] * shape[2] + j * shape[2] + k]);
                 }
-            }
-
-            for (int i = 0; i < encoded_inputs.attention_mask.size(); i++) {
-                for (int j = 0; j < encoded_inputs.attention_mask[i].size(); j++) {
-                    attention_mask_flatten.push_back(encoded_inputs.attention_mask[i][j]);
+                if(tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
+                    // no mean pooling for clip
+                    outputs.push_back(embedding_res_t(output_row));
+                    continue;
                 }
+                output.push_back(output_row);
             }
-
-            if(session_->GetInputCount() == 3) {
-                for (int i = 0; i < encoded_inputs.token_type_ids.size(); i++) {
-                    for (int j = 0; j < encoded_inputs.token_type_ids[i].size(); j++) {
-                        token_type_ids_flatten.push_back(encoded_inputs.token_type_ids[i][j]);
-                    }
-                }
+            if(tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
+                outputs.push_back(embedding_res_t(mean_pooling(output, encoded_inputs.attention_mask[i])));
             }
+        }
+    }
 
-            input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, input_ids_flatten.data(), input_ids_flatten.size(), input_shapes[0].data(), input_shapes[0].size()));
-            input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, attention_mask_flatten.data(), attention_mask_flatten.size(), input_shapes[1].data(), input_shapes[1].size()));
-            if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-                input_tensors.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, token_type_ids_flatten.data(), token_type_ids_flatten.size(), input_shapes[2].data(), input_shapes[2].size()));
-            } else if(session_->GetInputCount() == 3 && tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
-                // dummy input for clip
-                std::vector<float> pixel_values(3 * 224 * 224, 0.5);
-                input_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info, pixel_values.data(), pixel_values.size(), input_shapes[2].data(), input_shapes[2].size()));
-            }
+    return outputs;
+}
 
-            //LOG(INFO) << "Running model";
-            // create output tensor object
-            std::vector<const char*> output_node_names = {output_tensor_name.c_str()};
+TextEmbedder::~TextEmbedder() {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        quit_scheduler_ = true;
+    }
 
-            // if seq length is 0, return empty vector
-            if(input_shapes[0][1] == 0) {
-                for(int i = 0; i < input_batch.size(); i++) {
-                    outputs.push_back(embedding_res_t(400, nlohmann::json({{"error", "Invalid input: empty sequence"}})));
-                }
-                continue;
-            }
+    pending_cv_.notify_all();
 
-            auto output_tensor = session_->Run(Ort::RunOptions{nullptr}, input_node_names.data(), input_tensors.data(), input_tensors.size(), output_node_names.data(), output_node_names.size());
-            float* data = output_tensor[0].GetTensorMutableData<float>();
-            // print output tensor shape
-            auto shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
-            // edge case for clip model
-            if(shape.size() == 2) {
-                // insert 1 to index 0
-                shape.insert(shape.begin(), 1);
-            }
-            for (int i = 0; i < shape[0]; i++) {
-                std::vector<std::vector<float>> output;
-                for (int j = 0; j < shape[1]; j++) {
-                    std::vector<float> output_row;
-                    for (int k = 0; k < shape[2]; k++) {
-                        output_row.push_back(data[i * shape[1] * shape[2] + j * shape[2] + k]);
-                    }
-                    if(tokenizer_->get_tokenizer_type() == TokenizerType::clip) {
-                        // no mean pooling for clip
-                        outputs.push_back(embedding_res_t(output_row));
-                        continue;
-                    }
-                    output.push_back(output_row);
-                }
-                if(tokenizer_->get_tokenizer_type() != TokenizerType::clip) {
-                    outputs.push_back(embedding_res_t(mean_pooling(output, encoded_inputs.attention_mask[i])));
-                }
-            }
-        }
-    } else {
-        outputs = std::move(remote_embedder_->batch_embed(inputs, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries));
+    if(batch_scheduler_.joinable()) {
+        batch_scheduler_.join();
     }
-    
-    return outputs;
 }
 
-TextEmbedder::~TextEmbedder() { }
-
 batch_encoded_input_t TextEmbedder::batch_encode(const std::vector<std::string>& inputs) {
     batch_encoded_input_t encoded_inputs;
     for(auto& input : inputs) {
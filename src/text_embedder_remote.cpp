@@ -1,4 +1,6 @@
 #include <http_proxy.h>
+#include <atomic>
+#include <thread>
 #include "text_embedder_remote.h"
 #include "embedder_manager.h"
 
@@ -12,6 +14,52 @@ Option<bool> RemoteEmbedder::validate_string_properties(const nlohmann::json& mo
     return Option<bool>(true);
 }
 
+std::vector<embedding_res_t> RemoteEmbedder::embed_in_batches(const std::vector<std::string>& inputs, size_t batch_size,
+                                                              const std::function<std::vector<embedding_res_t>(const std::vector<std::string>&)>& embed_batch,
+                                                              size_t max_concurrent_batches) {
+    batch_size = std::max<size_t>(batch_size, 1);
+    const size_t num_batches = (inputs.size() + batch_size - 1) / batch_size;
+    std::vector<std::vector<embedding_res_t>> batch_outputs(num_batches);
+    std::atomic<size_t> next_batch{0};
+
+    auto worker = [&]() {
+        size_t batch_index;
+        while((batch_index = next_batch++) < num_batches) {
+            const size_t begin = batch_index * batch_size;
+            const size_t end = std::min(begin + batch_size, inputs.size());
+            const std::vector<std::string> batch(inputs.begin() + begin, inputs.begin() + end);
+            batch_outputs[batch_index] = embed_batch(batch);
+
+            if(batch_outputs[batch_index].size() != batch.size()) {
+                batch_outputs[batch_index] = std::vector<embedding_res_t>(batch.size(),
+                                                embedding_res_t(500, "Got malformed response from remote API."));
+            }
+        }
+    };
+
+    // retries and back-off happen per request inside call_remote_api(), so a slow sub-batch only holds up its worker
+    const size_t num_workers = std::min(std::max<size_t>(max_concurrent_batches, 1), num_batches);
+    std::vector<std::thread> workers;
+    for(size_t i = 1; i < num_workers; i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for(auto& t: workers) {
+        t.join();
+    }
+
+    std::vector<embedding_res_t> outputs;
+    outputs.reserve(inputs.size());
+    for(auto& batch_output: batch_outputs) {
+        outputs.insert(outputs.end(), std::make_move_iterator(batch_output.begin()),
+                       std::make_move_iterator(batch_output.end()));
+    }
+
+    return outputs;
+}
+
 long RemoteEmbedder::call_remote_api(const std::string& method, const std::string& url, const std::string& req_body,
                                      std::string& res_body,
                                      std::map<std::string, std::string>& res_headers,
@@ -167,15 +215,11 @@ embedding_res_t OpenAIEmbedder::Embed(const std::string& text, const size_t remo
 
 std::vector<embedding_res_t> OpenAIEmbedder::batch_embed(const std::vector<std::string>& inputs, const size_t remote_embedding_batch_size,
                                                          const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries) {
-    // call recursively if inputs larger than remote_embedding_batch_size
+    // split into concurrently sent sub-batches if inputs larger than remote_embedding_batch_size
     if(inputs.size() > remote_embedding_batch_size) {
-        std::vector<embedding_res_t> outputs;
-        for(size_t i = 0; i < inputs.size(); i += remote_embedding_batch_size) {
-            auto batch = std::vector<std::string>(inputs.begin() + i, inputs.begin() + std::min(i + remote_embedding_batch_size, inputs.size()));
-            auto batch_outputs = batch_embed(batch, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries);
-            outputs.insert(outputs.end(), batch_outputs.begin(), batch_outputs.end());
-        }
-        return outputs;
+        return embed_in_batches(inputs, remote_embedding_batch_size, [&](const std::vector<std::string>& batch) {
+            return batch_embed(batch, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries);
+        });
     }
     nlohmann::json req_body;
     req_body["input"] = inputs;
@@ -355,21 +399,36 @@ embedding_res_t GoogleEmbedder::Embed(const std::string& text, const size_t remo
 
 std::vector<embedding_res_t> GoogleEmbedder::batch_embed(const std::vector<std::string>& inputs, const size_t remote_embedding_batch_size,
                                                          const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries) {
-    std::vector<embedding_res_t> outputs;
-    bool timeout_prev = false;
-    for(auto& input : inputs) {
-        auto res = Embed(input, remote_embedding_timeout_ms, remote_embedding_num_tries);
-        if(res.status_code == 408) {
-            if(timeout_prev) {
-                // fail whole batch if two consecutive timeouts,
-                nlohmann::json req_body;
-                req_body["text"] = input;
-               return std::vector<embedding_res_t>(inputs.size(), embedding_res_t(408, get_error_json(req_body, 408, "")));
+    // Google's API embeds one text per request, so every input is its own sub-batch
+    std::atomic<size_t> consecutive_timeouts{0};
+    std::atomic<bool> timed_out{false};
+
+    auto outputs = embed_in_batches(inputs, 1, [&](const std::vector<std::string>& batch) {
+        nlohmann::json req_body;
+        req_body["text"] = batch[0];
+
+        if(timed_out) {
+            // stop sending requests once the API has timed out twice in a row
+            return std::vector<embedding_res_t>{embedding_res_t(408, get_error_json(req_body, 408, ""))};
+        }
+
+        auto res = Embed(batch[0], remote_embedding_timeout_ms, remote_embedding_num_tries);
+        if(!res.success && res.status_code == 408) {
+            if(++consecutive_timeouts >= 2) {
+                timed_out = true;
             }
-            timeout_prev = true;
+        } else {
+            consecutive_timeouts = 0;
         }
-        timeout_prev = false;
-        outputs.push_back(res);
+
+        return std::vector<embedding_res_t>{res};
+    });
+
+    if(timed_out) {
+        // fail whole batch if two consecutive timeouts
+        nlohmann::json req_body;
+        req_body["text"] = inputs[0];
+        return std::vector<embedding_res_t>(inputs.size(), embedding_res_t(408, get_error_json(req_body, 408, "")));
     }
 
     return outputs;
@@ -486,8 +545,9 @@ embedding_res_t GCPEmbedder::Embed(const std::string& text, const size_t remote_
     nlohmann::json instance;
     instance["content"] = text;
     req_body["instances"].push_back(instance);
+    const std::string token = get_access_token();
     std::unordered_map<std::string, std::string> headers;
-    headers["Authorization"] = "Bearer " + access_token;
+    headers["Authorization"] = "Bearer " + token;
     headers["Content-Type"] = "application/json";
     headers["timeout_ms"] = std::to_string(remote_embedder_timeout_ms);
     headers["num_try"] = std::to_string(remote_embedding_num_tries);
@@ -498,15 +558,14 @@ embedding_res_t GCPEmbedder::Embed(const std::string& text, const size_t remote_
 
     if(res_code != 200) {
         if(res_code == 401) {
-            auto refresh_op = generate_access_token(refresh_token, client_id, client_secret);
+            auto refresh_op = refresh_access_token(token);
             if(!refresh_op.ok()) {
                 nlohmann::json embedding_res = nlohmann::json::object();
                 embedding_res["error"] = refresh_op.error();
                 return embedding_res_t(refresh_op.code(), embedding_res);
             }
-            access_token = refresh_op.get();
             // retry
-            headers["Authorization"] = "Bearer " + access_token;
+            headers["Authorization"] = "Bearer " + refresh_op.get();
             res_code = call_remote_api("POST", get_gcp_embedding_url(project_id, model_name), req_body.dump(), res, res_headers, headers);
         }
     }
@@ -528,12 +587,9 @@ std::vector<embedding_res_t> GCPEmbedder::batch_embed(const std::vector<std::str
                                                       const size_t remote_embedding_timeout_ms, const size_t remote_embedding_num_tries) {
     // GCP API has a limit of 5 instances per request
     if(inputs.size() > 5) {
-        std::vector<embedding_res_t> res;
-        for(size_t i = 0; i < inputs.size(); i += 5) {
-            auto batch_res = batch_embed(std::vector<std::string>(inputs.begin() + i, inputs.begin() + std::min(i + 5, inputs.size())));
-            res.insert(res.end(), batch_res.begin(), batch_res.end());
-        }
-        return res;
+        return embed_in_batches(inputs, 5, [&](const std::vector<std::string>& batch) {
+            return batch_embed(batch, remote_embedding_batch_size, remote_embedding_timeout_ms, remote_embedding_num_tries);
+        });
     }
     nlohmann::json req_body;
     req_body["instances"] = nlohmann::json::array();
@@ -542,8 +598,9 @@ std::vector<embedding_res_t> GCPEmbedder::batch_embed(const std::vector<std::str
         instance["content"] = input;
         req_body["instances"].push_back(instance);
     }
+    const std::string token = get_access_token();
     std::unordered_map<std::string, std::string> headers;
-    headers["Authorization"] = "Bearer " + access_token;
+    headers["Authorization"] = "Bearer " + token;
     headers["Content-Type"] = "application/json";
     headers["timeout_ms"] = std::to_string(remote_embedding_timeout_ms);
     headers["num_try"] = std::to_string(remote_embedding_num_tries);
@@ -552,7 +609,7 @@ std::vector<embedding_res_t> GCPEmbedder::batch_embed(const std::vector<std::str
     auto res_code = call_remote_api("POST", get_gcp_embedding_url(project_id, model_name), req_body.dump(), res, res_headers, headers);
     if(res_code != 200) {
         if(res_code == 401) {
-            auto refresh_op = generate_access_token(refresh_token, client_id, client_secret);
+            auto refresh_op = refresh_access_token(token);
             if(!refresh_op.ok()) {
                 nlohmann::json embedding_res = nlohmann::json::object();
                 embedding_res["error"] = refresh_op.error();
@@ -562,9 +619,8 @@ std::vector<embedding_res_t> GCPEmbedder::batch_embed(const std::vector<std::str
                 }
                 return outputs;
             }
-            access_token = refresh_op.get();
             // retry
-            headers["Authorization"] = "Bearer " + access_token;
+            headers["Authorization"] = "Bearer " + refresh_op.get();
             res_code = call_remote_api("POST", get_gcp_embedding_url(project_id, model_name), req_body.dump(), res, res_headers, headers);
         }
     }
@@ -637,6 +693,26 @@ nlohmann::json GCPEmbedder::get_error_json(const nlohmann::json& req_body, long
     return embedding_res;
 }
 
+std::string GCPEmbedder::get_access_token() {
+    std::lock_guard<std::mutex> lock(access_token_mutex);
+    return access_token;
+}
+
+Option<std::string> GCPEmbedder::refresh_access_token(const std::string& expired_token) {
+    std::lock_guard<std::mutex> lock(access_token_mutex);
+    if(access_token != expired_token) {
+        // another sub-batch has already refreshed the token
+        return Option<std::string>(access_token);
+    }
+
+    auto refresh_op = generate_access_token(refresh_token, client_id, client_secret);
+    if(refresh_op.ok()) {
+        access_token = refresh_op.get();
+    }
+
+    return refresh_op;
+}
+
 Option<std::string> GCPEmbedder::generate_access_token(const std::string& refresh_token, const std::string& client_id, const std::string& client_secret) {
     std::unordered_map<std::string, std::string> headers;
     headers["Content-Type"] = "application/x-www-form-urlencoded";
@@ -5,3 +5,8 @@ thread_local int64_t write_log_index = 0;
 thread_local uint64_t search_begin_us;
 thread_local uint64_t search_stop_us;
 thread_local bool search_cutoff = false;
+thread_local search_profile_t* search_profile = nullptr;
+thread_local uint64_t search_stage_us[NUM_SEARCH_STAGES] = {};
+thread_local uint32_t search_stages_entered = 0;
+thread_local uint64_t search_num_filter_ids = 0;
+thread_local uint64_t search_num_scored_candidates = 0;
@@ -25,6 +25,15 @@ Option<bool> Config::update_config(const nlohmann::json& req_json) {
         found_config = true;
     }
 
+    if(req_json.count("slow-query-log-time-ms") != 0) {
+        if(!req_json["slow-query-log-time-ms"].is_number_integer()) {
+            return Option<bool>(400, "Configuration `slow-query-log-time-ms` must be an integer.");
+        }
+
+        set_slow_query_log_time_ms(req_json["slow-query-log-time-ms"].get<int>());
+        found_config = true;
+    }
+
     if(req_json.count("enable-search-logging") != 0) {
         if(!req_json["enable-search-logging"].is_boolean()) {
             return Option<bool>(400, "Configuration `enable-search-logging` must be a boolean.");
@@ -202,6 +211,10 @@ void Config::load_config_env() {
         this->log_slow_searches_time_ms = std::stoi(get_env("TYPESENSE_LOG_SLOW_SEARCHES_TIME_MS"));
     }
 
+    if(!get_env("TYPESENSE_SLOW_QUERY_LOG_TIME_MS").empty()) {
+        this->slow_query_log_time_ms = std::stoi(get_env("TYPESENSE_SLOW_QUERY_LOG_TIME_MS"));
+    }
+
     if(!get_env("TYPESENSE_NUM_COLLECTIONS_PARALLEL_LOAD").empty()) {
         this->num_collections_parallel_load = std::stoi(get_env("TYPESENSE_NUM_COLLECTIONS_PARALLEL_LOAD"));
     }
@@ -226,6 +239,18 @@ void Config::load_config_env() {
         this->db_compaction_interval = std::stoi(get_env("TYPESENSE_DB_COMPACTION_INTERVAL"));
     }
 
+    if(!get_env("TYPESENSE_LOCAL_EMBEDDING_MAX_BATCH_SIZE").empty()) {
+        this->local_embedding_max_batch_size = std::stoi(get_env("TYPESENSE_LOCAL_EMBEDDING_MAX_BATCH_SIZE"));
+    }
+
+    if(!get_env("TYPESENSE_LOCAL_EMBEDDING_BATCH_WAIT_US").empty()) {
+        this->local_embedding_batch_wait_us = std::stoi(get_env("TYPESENSE_LOCAL_EMBEDDING_BATCH_WAIT_US"));
+    }
+
+    if(!get_env("TYPESENSE_NUM_SEARCH_PARTITIONS").empty()) {
+        this->num_search_partitions = std::stoi(get_env("TYPESENSE_NUM_SEARCH_PARTITIONS"));
+    }
+
     if(!get_env("TYPESENSE_THREAD_POOL_SIZE").empty()) {
         this->thread_pool_size = std::stoi(get_env("TYPESENSE_THREAD_POOL_SIZE"));
     }
@@ -383,6 +408,10 @@ void Config::load_config_file(cmdline::parser& options) {
         this->log_slow_searches_time_ms = (int) reader.GetInteger("server", "log-slow-searches-time-ms", 30*1000);
     }
 
+    if(reader.Exists("server", "slow-query-log-time-ms")) {
+        this->slow_query_log_time_ms = (int) reader.GetInteger("server", "slow-query-log-time-ms", -1);
+    }
+
     if(reader.Exists("server", "num-collections-parallel-load")) {
         this->num_collections_parallel_load = (int) reader.GetInteger("server", "num-collections-parallel-load", 0);
     }
@@ -407,6 +436,18 @@ void Config::load_config_file(cmdline::parser& options) {
         this->db_compaction_interval = (int) reader.GetInteger("server", "db-compaction-interval", 0);
     }
 
+    if(reader.Exists("server", "local-embedding-max-batch-size")) {
+        this->local_embedding_max_batch_size = (int) reader.GetInteger("server", "local-embedding-max-batch-size", 8);
+    }
+
+    if(reader.Exists("server", "local-embedding-batch-wait-us")) {
+        this->local_embedding_batch_wait_us = (int) reader.GetInteger("server", "local-embedding-batch-wait-us", 2000);
+    }
+
+    if(reader.Exists("server", "num-search-partitions")) {
+        this->num_search_partitions = (int) reader.GetInteger("server", "num-search-partitions", 4);
+    }
+
     if(reader.Exists("server", "thread-pool-size")) {
         this->thread_pool_size = (int) reader.GetInteger("server", "thread-pool-size", 0);
     }
@@ -561,6 +602,10 @@ void Config::load_config_cmd_args(cmdline::parser& options)  {
         this->log_slow_searches_time_ms = options.get<int>("log-slow-searches-time-ms");
     }
 
+    if(options.exist("slow-query-log-time-ms")) {
+        this->slow_query_log_time_ms = options.get<int>("slow-query-log-time-ms");
+    }
+
     if(options.exist("num-collections-parallel-load")) {
         this->num_collections_parallel_load = options.get<uint32_t>("num-collections-parallel-load");
     }
@@ -585,6 +630,18 @@ void Config::load_config_cmd_args(cmdline::parser& options)  {
         this->db_compaction_interval = options.get<uint32_t>("db-compaction-interval");
     }
 
+    if(options.exist("local-embedding-max-batch-size")) {
+        this->local_embedding_max_batch_size = options.get<uint32_t>("local-embedding-max-batch-size");
+    }
+
+    if(options.exist("local-embedding-batch-wait-us")) {
+        this->local_embedding_batch_wait_us = options.get<uint32_t>("local-embedding-batch-wait-us");
+    }
+
+    if(options.exist("num-search-partitions")) {
+        this->num_search_partitions = options.get<uint32_t>("num-search-partitions");
+    }
+
     if(options.exist("thread-pool-size")) {
         this->thread_pool_size = options.get<uint32_t>("thread-pool-size");
     }
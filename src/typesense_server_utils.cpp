@@ -15,6 +15,7 @@
 #include <ifaddrs.h>
 #include "analytics_manager.h"
 #include "housekeeper.h"
+#include "slow_query_log.h"
 
 #include "core_api.h"
 #include "ratelimit_manager.h"
@@ -109,11 +110,15 @@ void init_cmdline_options(cmdline::parser & options, int argc, char **argv) {
     options.add<bool>("reset-peers-on-error", '\0', "Reset node's peers on clustering error. Default: false.", false, false);
 
     options.add<int>("log-slow-searches-time-ms", '\0', "When >= 0, searches that take longer than this duration are logged.", false, 30*1000);
+    options.add<int>("slow-query-log-time-ms", '\0', "When >= 0, searches that take longer than this duration are recorded with their stage timings in the slow query log.", false, -1);
     options.add<int>("cache-num-entries", '\0', "Number of entries to cache.", false, 1000);
     options.add<uint32_t>("analytics-flush-interval", '\0', "Frequency of persisting analytics data to disk (in seconds).", false, 3600);
     options.add<uint32_t>("housekeeping-interval", '\0', "Frequency of housekeeping background job (in seconds).", false, 1800);
     options.add<bool>("enable-lazy-filter", '\0', "Filter clause will be evaluated lazily.", false, false);
     options.add<uint32_t>("db-compaction-interval", '\0', "Frequency of RocksDB compaction (in seconds).", false, 604800);
+    options.add<uint32_t>("local-embedding-max-batch-size", '\0', "Maximum number of concurrent queries embedded together by a local model.", false, 8);
+    options.add<uint32_t>("local-embedding-batch-wait-us", '\0', "Maximum time a query waits for others to fill a local embedding batch (in microseconds).", false, 2000);
+    options.add<uint32_t>("num-search-partitions", '\0', "Number of partitions of a collection's matches that a search scores in parallel.", false, 4);
 
     // DEPRECATED
     options.add<std::string>("listen-address", 'h', "[DEPRECATED: use `api-address`] Address to which Typesense API service binds.", false, "0.0.0.0");
@@ -496,6 +501,11 @@ int run_server(const Config & config, const std::string & version, void (*master
             HouseKeeper::get_instance().run();
         });
 
+        SlowQueryLog::get_instance().init(config.get_slow_query_log_path());
+        std::thread slow_query_log_thread([]() {
+            SlowQueryLog::get_instance().run();
+        });
+
         RemoteEmbedder::init(&replication_state);
 
         std::string path_to_nodes = config.get_nodes();
@@ -530,6 +540,10 @@ int run_server(const Config & config, const std::string & version, void (*master
         HouseKeeper::get_instance().stop();
         housekeeping_thread.join();
 
+        LOG(INFO) << "Waiting for slow query log thread to be done...";
+        SlowQueryLog::get_instance().stop();
+        slow_query_log_thread.join();
+
         LOG(INFO) << "Shutting down server_thread_pool";
 
         server_thread_pool.shutdown();
@@ -561,6 +575,7 @@ int run_server(const Config & config, const std::string & version, void (*master
 
     LOG(INFO) << "CURL clean up";
 
+    httpClient.dispose();
     curl_global_cleanup();
 
     LOG(INFO) << "Deleting server";
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <vector>
+#include <thread>
 #include <collection_manager.h>
 #include <analytics_manager.h>
 #include "collection.h"
@@ -107,6 +108,111 @@ TEST_F(AnalyticsManagerTest, AddSuggestion) {
     ASSERT_TRUE(analyticsManager.remove_rule("top_search_queries").ok());
 }
 
+TEST_F(AnalyticsManagerTest, AddSuggestionFromConcurrentSearches) {
+    nlohmann::json titles_schema = R"({
+            "name": "titles",
+            "fields": [
+                {"name": "title", "type": "string"}
+            ]
+        })"_json;
+
+    Collection* titles_coll = collectionManager.create_collection(titles_schema).get();
+
+    nlohmann::json suggestions_schema = R"({
+        "name": "top_queries",
+        "fields": [
+          {"name": "q", "type": "string" },
+          {"name": "count", "type": "int32" }
+        ]
+      })"_json;
+
+    Collection* suggestions_coll = collectionManager.create_collection(suggestions_schema).get();
+
+    nlohmann::json analytics_rule = R"({
+        "name": "top_search_queries",
+        "type": "popular_queries",
+        "params": {
+            "limit": 100,
+            "source": {
+                "collections": ["titles"]
+            },
+            "destination": {
+                "collection": "top_queries"
+            }
+        }
+    })"_json;
+
+    auto create_op = analyticsManager.create_rule(analytics_rule, false, true);
+    ASSERT_TRUE(create_op.ok());
+
+    // queries of collections without rules are not buffered
+    analyticsManager.add_suggestion("unknown", "foo", "foo", true, "1");
+
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < 8; i++) {
+        threads.emplace_back([&, i]() {
+            for(size_t j = 0; j < 50; j++) {
+                analyticsManager.add_suggestion("titles", "q" + std::to_string(j), "q" + std::to_string(j),
+                                                true, std::to_string(i));
+            }
+        });
+    }
+
+    for(auto& thread: threads) {
+        thread.join();
+    }
+
+    nlohmann::json stats;
+    analyticsManager.get_query_buffer_stats(stats);
+    ASSERT_EQ(400, stats["analytics_buffered_queries"].get<size_t>());
+
+    auto popularQueries = analyticsManager.get_popular_queries();
+    auto userQueries = popularQueries["top_queries"]->get_user_prefix_queries();
+
+    for(size_t i = 0; i < 8; i++) {
+        auto& queries = userQueries[std::to_string(i)];
+        ASSERT_EQ(50, queries.size());
+        // a user's queries are merged in the order they were made
+        for(size_t j = 0; j < 50; j++) {
+            ASSERT_EQ("q" + std::to_string(j), queries[j].query);
+        }
+    }
+
+    analyticsManager.get_query_buffer_stats(stats);
+    ASSERT_EQ(0, stats["analytics_buffered_queries"].get<size_t>());
+
+    // a user's queries made from several threads are still merged in order
+    threads.clear();
+    for(size_t i = 0; i < 4; i++) {
+        threads.emplace_back([&, i]() {
+            analyticsManager.add_suggestion("titles", "r" + std::to_string(i), "r" + std::to_string(i),
+                                            true, "shared");
+        });
+        threads.back().join();
+    }
+
+    popularQueries = analyticsManager.get_popular_queries();
+    userQueries = popularQueries["top_queries"]->get_user_prefix_queries();
+    ASSERT_EQ(4, userQueries["shared"].size());
+    for(size_t i = 0; i < 4; i++) {
+        ASSERT_EQ("r" + std::to_string(i), userQueries["shared"][i].query);
+    }
+
+    // queries beyond the capacity of a buffer are kept until the next merge, and none of them are lost
+    for(size_t i = 0; i < 10'000; i++) {
+        analyticsManager.add_suggestion("titles", "shoes", "shoes", false, "1");
+    }
+
+    analyticsManager.get_query_buffer_stats(stats);
+    ASSERT_EQ(10'000, stats["analytics_buffered_queries"].get<size_t>());
+
+    popularQueries = analyticsManager.get_popular_queries();
+    auto local_counts = popularQueries["top_queries"]->get_local_counts();
+    ASSERT_EQ(10'000, local_counts["shoes"]);
+
+    ASSERT_TRUE(analyticsManager.remove_rule("top_search_queries").ok());
+}
+
 TEST_F(AnalyticsManagerTest, AddSuggestionWithExpandedQuery) {
     nlohmann::json titles_schema = R"({
             "name": "titles",
@@ -43,3 +43,73 @@ TEST_F(AppMetricsTest, StatefulRemoveDocs) {
     ASSERT_EQ(result["rps"]["GET /collections"].get<double>(), 0.2);
     ASSERT_EQ(result["rps"]["GET /operations/vote"].get<double>(), 0.1);
 }
+
+TEST_F(AppMetricsTest, LatencyHistogramBuckets) {
+    // powers of two are bucket upper bounds
+    for(size_t exponent = 0; exponent < 30; exponent++) {
+        uint64_t bound = uint64_t(1) << exponent;
+        size_t index = latency_histogram_t::bucket_index(bound);
+        ASSERT_EQ(bound, latency_histogram_t::upper_bound(index));
+        ASSERT_EQ(index + 1, latency_histogram_t::bucket_index(bound + 1));
+    }
+
+    // every value falls in a bucket whose upper bound is at most 25% larger
+    for(uint64_t value = 1; value < 100000; value++) {
+        uint64_t bound = latency_histogram_t::upper_bound(latency_histogram_t::bucket_index(value));
+        ASSERT_GE(bound, value);
+        ASSERT_LE(bound, value + (value + 3) / 4);
+    }
+
+    ASSERT_EQ(latency_histogram_t::NUM_BUCKETS - 1, latency_histogram_t::bucket_index(UINT64_MAX));
+}
+
+TEST_F(AppMetricsTest, LatencyHistogramPercentiles) {
+    latency_histogram_t histogram;
+    ASSERT_EQ(0, histogram.percentile(99));
+
+    for(uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+
+    ASSERT_EQ(1000, histogram.get_count());
+    ASSERT_EQ(500500, histogram.get_sum_us());
+
+    ASSERT_EQ(512, histogram.percentile(50));
+    ASSERT_EQ(1024, histogram.percentile(99));
+    ASSERT_EQ(64, histogram.count_at_most(64));
+    ASSERT_EQ(1000, histogram.count_at_most(1024));
+}
+
+TEST_F(AppMetricsTest, PrometheusExposition) {
+    for(size_t i = 0; i < NUM_SEARCH_STAGES; i++) {
+        search_stage_us[i] = 100;
+        search_stages_entered |= (1U << i);
+    }
+
+    metrics.record_search(2000);
+    metrics.record_write_stage(WRITE_STAGE_INDEX, 30);
+
+    const std::string& text = metrics.get_prometheus_metrics();
+
+    ASSERT_NE(std::string::npos, text.find("# TYPE typesense_search_duration_seconds histogram\n"));
+    ASSERT_NE(std::string::npos, text.find("typesense_search_duration_seconds_bucket{le=\"0.002048\"} "));
+    ASSERT_NE(std::string::npos, text.find("typesense_search_stage_duration_seconds_bucket{stage=\"token_search\",le=\"+Inf\"} "));
+    ASSERT_NE(std::string::npos, text.find("typesense_write_stage_duration_seconds_count{stage=\"index\"} "));
+}
+
+TEST_F(AppMetricsTest, SearchRecordsOnlyEnteredStages) {
+    const uint64_t num_token_searches = metrics.get_search_stage_latency(SEARCH_STAGE_TOKEN_SEARCH).get_count();
+    const uint64_t num_facets = metrics.get_search_stage_latency(SEARCH_STAGE_FACETS).get_count();
+
+    std::fill(std::begin(search_stage_us), std::end(search_stage_us), 0);
+    search_stages_entered = 0;
+
+    {
+        search_stage_timer_t token_search_timer(SEARCH_STAGE_TOKEN_SEARCH);
+    }
+
+    metrics.record_search(1000);
+
+    ASSERT_EQ(num_token_searches + 1, metrics.get_search_stage_latency(SEARCH_STAGE_TOKEN_SEARCH).get_count());
+    ASSERT_EQ(num_facets, metrics.get_search_stage_latency(SEARCH_STAGE_FACETS).get_count());
+}
@@ -6,7 +6,9 @@
 #include <gtest/gtest.h>
 #include <art.h>
 #include <chrono>
+#include <random>
 #include <posting.h>
+#include "filter_result_iterator.h"
 
 #define words_file_path (std::string(ROOT_DIR) + std::string("external/libart/tests/words.txt")).c_str()
 #define uuid_file_path (std::string(ROOT_DIR) + std::string("external/libart/tests/uuid.txt")).c_str()
@@ -911,6 +913,322 @@ TEST(ArtTest, test_art_fuzzy_search_extra_chars) {
     ASSERT_TRUE(res == 0);
 }
 
+TEST(ArtTest, test_art_fuzzy_search_long_keys) {
+    art_tree t;
+    int res = art_tree_init(&t);
+    ASSERT_TRUE(res == 0);
+
+    // long keys ensure that costs far away from the diagonal are never needed for the match
+    std::vector<const char*> keys = {
+        "pneumonoultramicroscopicsilicovolcanoconiosis",
+        "pneumonoultramicroscopicsilicovolcanoconioses",
+        "supercalifragilisticexpialidocious",
+        "supercalifragilisticexpialidociously"
+    };
+
+    for(size_t i = 0; i < keys.size(); i++) {
+        art_document doc = get_document((uint32_t) i + 1);
+        ASSERT_TRUE(NULL == art_insert(&t, (unsigned char*)keys[i], strlen(keys[i])+1, &doc));
+    }
+
+    // typos at both ends of the key
+    const char* query = "pnuemonoultramicroscopicsilicovolcanoconiosus";
+    std::vector<art_leaf*> leaves;
+    exclude_leaves.clear();
+    art_fuzzy_search(&t, (unsigned char *)query, strlen(query) + 1, 0, 2, 10, FREQUENCY, false, false, "", nullptr, 0, leaves, exclude_leaves);
+    ASSERT_EQ(2, leaves.size());
+
+    // prefix with a typo
+    query = "supercalifragilistcexpiali";
+    leaves.clear();
+    exclude_leaves.clear();
+    art_fuzzy_search(&t, (unsigned char *)query, strlen(query), 0, 1, 10, FREQUENCY, true, false, "", nullptr, 0, leaves, exclude_leaves);
+    ASSERT_EQ(2, leaves.size());
+
+    // cost exceeds the budget
+    query = "sxpxrcalifragilisticexpialidocious";
+    leaves.clear();
+    exclude_leaves.clear();
+    art_fuzzy_search(&t, (unsigned char *)query, strlen(query) + 1, 0, 1, 10, FREQUENCY, false, false, "", nullptr, 0, leaves, exclude_leaves);
+    ASSERT_EQ(0, leaves.size());
+
+    res = art_tree_destroy(&t);
+    ASSERT_TRUE(res == 0);
+}
+
+// Decision of `fuzzy_search_state` (art.cpp) on a row of costs: -1 rejects the key, 1 accepts it and 0 continues.
+static int fuzzy_reference_state(const bool prefix, const int key_index, const unsigned char p, const unsigned char c,
+                                 const unsigned char* query, const int query_len,
+                                 const std::vector<int>& cost_row, const int min_cost, const int max_cost) {
+    const bool last_key_char = (c == '\0');
+    const int key_len = last_key_char ? key_index : key_index + 1;
+
+    if(last_key_char) {
+        if(cost_row[query_len] >= min_cost && cost_row[query_len] <= max_cost) {
+            return 1;
+        }
+
+        if(key_len > 5 && query_len > key_len && (query_len - key_len) <= max_cost &&
+           cost_row[key_len] >= min_cost && cost_row[key_len] <= max_cost-1) {
+            return 1;
+        }
+
+        return -1;
+    }
+
+    const int cost = cost_row[std::min(key_len, query_len)];
+
+    if(key_len >= query_len && prefix && cost >= min_cost && cost <= max_cost) {
+        return 1;
+    }
+
+    if(cost <= max_cost) {
+        return 0;
+    }
+
+    if(cost == 2 || cost == 3) {
+        if((key_index+1 < query_len && query[key_index+1] == c) || (key_index > 0 && query[key_index-1] == c)) {
+            return 0;
+        }
+    }
+
+    if(cost == 3 || cost == 4) {
+        if(key_index + 1 < query_len && p == query[key_index + 1] &&
+           key_index + 2 < query_len && c == query[key_index + 2]) {
+            return 0;
+        }
+
+        if(key_index > 1 && query[key_index-2] == c) {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+// Walks the characters of a single key with the full, unclipped optimal string alignment rows. The leaf of the key
+// hangs below its first `leaf_depth` characters, past which the tree search looks at no more than `term_len +
+// max_cost` characters.
+static bool fuzzy_reference_match(const std::string& key, const size_t leaf_depth,
+                                  const unsigned char* term, const int term_len,
+                                  const bool prefix, const int min_cost, const int max_cost) {
+    const size_t iter_len = std::min<size_t>(key.size() + 1, term_len + max_cost);
+    std::vector<std::vector<int>> rows(2, std::vector<int>(term_len + 1));
+    for(int column = 0; column <= term_len; column++) {
+        rows[0][column] = rows[1][column] = column;
+    }
+
+    unsigned char p = 0;
+    for(size_t depth = 0; depth <= key.size(); depth++) {
+        if(depth > leaf_depth && depth >= iter_len) {
+            return depth == leaf_depth + 1 &&
+                   fuzzy_reference_state(prefix, depth, '\0', '\0', term, term_len, rows.back(),
+                                         min_cost, max_cost) == 1;
+        }
+
+        const unsigned char c = key.c_str()[depth];
+
+        if(!prefix || c != '\0') {
+            const auto& irow = rows[rows.size() - 2];
+            const auto& jrow = rows[rows.size() - 1];
+            std::vector<int> krow(term_len + 1);
+            krow[0] = jrow[0] + 1;
+
+            for(int column = 1; column <= term_len; column++) {
+                const int cost = (c == term[column-1]) ? 0 : 1;
+                krow[column] = std::min(std::min(krow[column - 1] + 1, jrow[column] + 1), jrow[column - 1] + cost);
+                if(depth > 1 && column > 1 && c == term[column-2] && p == term[column-1]) {
+                    krow[column] = std::min(krow[column], irow[column-2] + 1);
+                }
+            }
+
+            rows.push_back(std::move(krow));
+        }
+
+        const int action = fuzzy_reference_state(prefix, depth, p, c, term, term_len, rows.back(),
+                                                 min_cost, max_cost);
+        if(action != 0) {
+            return action == 1;
+        }
+
+        p = c;
+    }
+
+    return false;
+}
+
+TEST(ArtTest, test_art_fuzzy_search_matches_brute_force) {
+    art_tree t;
+    ASSERT_EQ(0, art_tree_init(&t));
+
+    // a small alphabet produces plenty of keys within a few edits of each other
+    std::mt19937 rng(42);
+    const std::string alphabet = "abcde";
+    auto random_word = [&](size_t min_len, size_t max_len) {
+        std::string word(std::uniform_int_distribution<size_t>(min_len, max_len)(rng), ' ');
+        for(auto& ch: word) {
+            ch = alphabet[std::uniform_int_distribution<size_t>(0, alphabet.size() - 1)(rng)];
+        }
+        return word;
+    };
+
+    // keys stay shorter than MAX_PREFIX_LEN, so no compressed path is truncated
+    std::set<std::string> vocabulary;
+    while(vocabulary.size() < 600) {
+        vocabulary.insert(random_word(1, 7));
+    }
+
+    // a leaf hangs below the longest prefix that its key shares with another key
+    std::map<std::string, size_t> leaf_depths;
+    for(auto it = vocabulary.begin(); it != vocabulary.end(); it++) {
+        auto common_prefix_len = [](const std::string& a, const std::string& b) {
+            size_t len = 0;
+            while(len < a.size() && len < b.size() && a[len] == b[len]) {
+                len++;
+            }
+            return len;
+        };
+
+        size_t leaf_depth = 0;
+        if(it != vocabulary.begin()) {
+            leaf_depth = std::max(leaf_depth, common_prefix_len(*it, *std::prev(it)));
+        }
+        if(std::next(it) != vocabulary.end()) {
+            leaf_depth = std::max(leaf_depth, common_prefix_len(*it, *std::next(it)));
+        }
+        leaf_depths[*it] = leaf_depth;
+    }
+
+    uint32_t doc_id = 0;
+    for(const auto& key: vocabulary) {
+        art_document doc = get_document(doc_id++);
+        ASSERT_TRUE(NULL == art_insert(&t, (const unsigned char*) key.c_str(), key.size() + 1, &doc));
+    }
+
+    std::vector<std::string> queries;
+    for(size_t i = 0; i < 150; i++) {
+        // edit a word of the vocabulary, so that the query has matches at every cost
+        std::string query = *std::next(vocabulary.begin(),
+                                        std::uniform_int_distribution<size_t>(0, vocabulary.size() - 1)(rng));
+        const size_t num_edits = std::uniform_int_distribution<size_t>(0, 2)(rng);
+        for(size_t edit = 0; edit < num_edits; edit++) {
+            const size_t pos = std::uniform_int_distribution<size_t>(0, query.size() - 1)(rng);
+            const char ch = alphabet[std::uniform_int_distribution<size_t>(0, alphabet.size() - 1)(rng)];
+            switch(std::uniform_int_distribution<int>(0, 3)(rng)) {
+                case 0: query[pos] = ch; break;
+                case 1: query.insert(query.begin() + pos, ch); break;
+                case 2: if(query.size() > 1) { query.erase(pos, 1); } break;
+                default: if(pos + 1 < query.size()) { std::swap(query[pos], query[pos + 1]); } break;
+            }
+        }
+        queries.push_back(query);
+    }
+
+    for(size_t i = 0; i < 50; i++) {
+        queries.push_back(random_word(1, 7));
+    }
+
+    for(const auto& query: queries) {
+        // padding keeps the reads past the end of the term identical for both sides
+        std::string term_buffer = query + std::string(16, '\0');
+        const auto term = (const unsigned char*) term_buffer.c_str();
+
+        for(int max_cost = 0; max_cost <= 2; max_cost++) {
+            for(int min_cost: {0, max_cost}) {
+                for(bool prefix: {false, true}) {
+                    const int term_len = prefix ? query.size() : query.size() + 1;
+
+                    std::vector<art_leaf*> leaves;
+                    exclude_leaves.clear();
+                    art_fuzzy_search(&t, term, term_len, min_cost, max_cost, 100'000, FREQUENCY, prefix, false, "",
+                                     nullptr, 0, leaves, exclude_leaves);
+
+                    std::set<std::string> found_keys;
+                    for(auto leaf: leaves) {
+                        found_keys.emplace((const char*) leaf->key, leaf->key_len - 1);
+                    }
+
+                    std::set<std::string> expected_keys;
+                    for(const auto& key: vocabulary) {
+                        if(fuzzy_reference_match(key, leaf_depths.at(key), term, term_len, prefix,
+                                                 min_cost, max_cost)) {
+                            expected_keys.insert(key);
+                        }
+                    }
+
+                    ASSERT_EQ(expected_keys, found_keys) << "query: " << query << ", costs: " << min_cost << "-"
+                                                         << max_cost << ", prefix: " << prefix;
+                }
+            }
+        }
+    }
+
+    ASSERT_EQ(0, art_tree_destroy(&t));
+}
+
+TEST(ArtTest, test_art_prefix_topk_with_inserts_and_deletes) {
+    art_tree t;
+    art_tree_init(&t);
+
+    // 100 keys under the `a` prefix, scored by their number
+    for(uint32_t i = 0; i < 100; i++) {
+        std::string key = "a" + std::to_string(i);
+        art_document doc(i, i, {0});
+        ASSERT_TRUE(NULL == art_insert(&t, (const unsigned char*) key.c_str(), key.size() + 1, &doc));
+    }
+
+    auto prefix_search = [&](const std::string& prefix, size_t max_words) {
+        std::vector<art_leaf*> leaves;
+        std::set<std::string> excluded;
+        filter_result_iterator_t filter_iter(nullptr, 0);
+        art_fuzzy_search_i(&t, (const unsigned char*) prefix.c_str(), prefix.size(), 0, 0, max_words, MAX_SCORE,
+                           true, false, "", &filter_iter, leaves, excluded);
+
+        std::vector<std::string> keys;
+        for(auto leaf: leaves) {
+            keys.emplace_back((const char*) leaf->key, leaf->key_len - 1);
+        }
+        return keys;
+    };
+
+    ASSERT_EQ(std::vector<std::string>({"a99", "a98", "a97", "a96"}), prefix_search("a", 4));
+    // exact match goes first
+    ASSERT_EQ(std::vector<std::string>({"a9", "a99"}), prefix_search("a9", 2));
+
+    // a low scoring key scored up by a new document moves to the top
+    art_document doc(100, 500, {0});
+    ASSERT_TRUE(NULL != art_insert(&t, (const unsigned char*) "a1", 3, &doc));
+    ASSERT_EQ(std::vector<std::string>({"a1", "a99"}), prefix_search("a", 2));
+
+    // deleting the best keys refills the top leaves from the rest of the tree
+    for(uint32_t i = 99; i >= 75; i--) {
+        std::string key = "a" + std::to_string(i);
+        void* values = art_delete(&t, (const unsigned char*) key.c_str(), key.size() + 1);
+        posting_t::destroy_list(values);
+    }
+
+    ASSERT_EQ(std::vector<std::string>({"a1", "a74", "a73"}), prefix_search("a", 3));
+    ASSERT_EQ(std::vector<std::string>({"a9"}), prefix_search("a9", 2));
+
+    // more results than the precomputed lists hold
+    ASSERT_EQ(50, prefix_search("a", 50).size());
+
+    // typo matches outside of the prefix are still found when only the minimum cost is 0
+    art_document typo_doc(101, 1000, {0});
+    ASSERT_TRUE(NULL == art_insert(&t, (const unsigned char*) "b1", 3, &typo_doc));
+
+    std::vector<art_leaf*> leaves;
+    std::set<std::string> excluded;
+    filter_result_iterator_t filter_iter(nullptr, 0);
+    art_fuzzy_search_i(&t, (const unsigned char*) "a", 1, 0, 1, 2, MAX_SCORE, true, false, "", &filter_iter, leaves,
+                       excluded);
+    ASSERT_EQ(2, leaves.size());
+    ASSERT_EQ("b1", std::string((const char*) leaves[0]->key, leaves[0]->key_len - 1));
+    ASSERT_EQ("a1", std::string((const char*) leaves[1]->key, leaves[1]->key_len - 1));
+
+    art_tree_destroy(&t);
+}
+
 TEST(ArtTest, test_art_search_sku_like_tokens) {
     art_tree t;
     int res = art_tree_init(&t);
@@ -3501,6 +3501,123 @@ TEST_F(CollectionJoinTest, FilterByReferenceArrayField) {
     ASSERT_EQ("Corduroy", res_obj["hits"][2]["document"]["song.title"][0]);
 }
 
+TEST_F(CollectionJoinTest, FilterByReferenceBitmapJoin) {
+    auto schema_json =
+            R"({
+                "name": "genres",
+                "fields": [
+                    { "name": "name", "type": "string" },
+                    { "name": "rank", "type": "int32" }
+                ]
+            })"_json;
+    auto collection_create_op = collectionManager.create_collection(schema_json);
+    ASSERT_TRUE(collection_create_op.ok());
+    for (size_t i = 0; i < 10; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["name"] = "g" + std::to_string(i);
+        doc["rank"] = i;
+        ASSERT_TRUE(collection_create_op.get()->add(doc.dump()).ok());
+    }
+
+    schema_json =
+            R"({
+                "name": "songs",
+                "fields": [
+                    { "name": "title", "type": "string" },
+                    { "name": "genre", "type": "string", "reference": "genres.id"}
+                ]
+           })"_json;
+    collection_create_op = collectionManager.create_collection(schema_json);
+    ASSERT_TRUE(collection_create_op.ok());
+    for (size_t i = 0; i < 12; i++) {
+        nlohmann::json doc;
+        doc["title"] = "s" + std::to_string(i);
+        doc["genre"] = std::to_string(i % 10);
+        ASSERT_TRUE(collection_create_op.get()->add(doc.dump()).ok());
+    }
+
+    schema_json =
+            R"({
+                "name": "playlists",
+                "fields": [
+                    { "name": "title", "type": "string" },
+                    { "name": "genres", "type": "string[]", "reference": "genres.id"}
+                ]
+           })"_json;
+    collection_create_op = collectionManager.create_collection(schema_json);
+    ASSERT_TRUE(collection_create_op.ok());
+    for (size_t i = 0; i < 8; i++) {
+        nlohmann::json doc;
+        doc["title"] = "p" + std::to_string(i);
+        doc["genres"] = {std::to_string(i), std::to_string((i + 3) % 10)};
+        ASSERT_TRUE(collection_create_op.get()->add(doc.dump()).ok());
+    }
+
+    // The referenced side matches enough genres to join by scanning the reference helper field in chunks.
+    std::map<std::string, std::string> req_params = {
+            {"collection", "songs"},
+            {"q", "*"},
+            {"filter_by", "$genres(rank:>=5)"},
+            {"include_fields", "title, $genres(name, strategy:merge) as genre"},
+    };
+    nlohmann::json embedded_params;
+    std::string json_res;
+    auto now_ts = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto search_op_bool = collectionManager.do_search(req_params, embedded_params, json_res, now_ts);
+    ASSERT_TRUE(search_op_bool.ok());
+
+    auto res_obj = nlohmann::json::parse(json_res);
+    ASSERT_EQ(5, res_obj["found"].get<size_t>());
+    ASSERT_EQ(5, res_obj["hits"].size());
+    for (size_t i = 0; i < 5; i++) {
+        ASSERT_EQ("s" + std::to_string(9 - i), res_obj["hits"][i]["document"]["title"].get<std::string>());
+        ASSERT_EQ("g" + std::to_string(9 - i), res_obj["hits"][i]["document"]["genre.name"].get<std::string>());
+    }
+
+    req_params = {
+            {"collection", "playlists"},
+            {"q", "*"},
+            {"filter_by", "$genres(rank:>=5)"},
+            {"include_fields", "title, $genres(name, strategy:merge) as genre"},
+    };
+    search_op_bool = collectionManager.do_search(req_params, embedded_params, json_res, now_ts);
+    ASSERT_TRUE(search_op_bool.ok());
+
+    res_obj = nlohmann::json::parse(json_res);
+    ASSERT_EQ(6, res_obj["found"].get<size_t>());
+    ASSERT_EQ(6, res_obj["hits"].size());
+
+    std::vector<std::string> expected_titles = {"p7", "p6", "p5", "p4", "p3", "p2"};
+    std::vector<std::vector<std::string>> expected_genres = {{"g7"}, {"g6", "g9"}, {"g5", "g8"}, {"g7"}, {"g6"}, {"g5"}};
+    for (size_t i = 0; i < expected_titles.size(); i++) {
+        ASSERT_EQ(expected_titles[i], res_obj["hits"][i]["document"]["title"].get<std::string>());
+        ASSERT_EQ(expected_genres[i].size(), res_obj["hits"][i]["document"]["genre.name"].size());
+        for (size_t j = 0; j < expected_genres[i].size(); j++) {
+            ASSERT_EQ(expected_genres[i][j], res_obj["hits"][i]["document"]["genre.name"][j]);
+        }
+    }
+
+    // A single referenced id is joined by looking up its documents.
+    req_params = {
+            {"collection", "playlists"},
+            {"q", "*"},
+            {"filter_by", "$genres(rank:7)"},
+            {"include_fields", "title, $genres(name, strategy:merge) as genre"},
+    };
+    search_op_bool = collectionManager.do_search(req_params, embedded_params, json_res, now_ts);
+    ASSERT_TRUE(search_op_bool.ok());
+
+    res_obj = nlohmann::json::parse(json_res);
+    ASSERT_EQ(2, res_obj["found"].get<size_t>());
+    ASSERT_EQ("p7", res_obj["hits"][0]["document"]["title"].get<std::string>());
+    ASSERT_EQ("p4", res_obj["hits"][1]["document"]["title"].get<std::string>());
+    ASSERT_EQ(1, res_obj["hits"][1]["document"]["genre.name"].size());
+    ASSERT_EQ("g7", res_obj["hits"][1]["document"]["genre.name"][0]);
+}
+
 TEST_F(CollectionJoinTest, FilterByObjectReferenceField) {
     auto schema_json =
             R"({
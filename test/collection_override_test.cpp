@@ -4223,3 +4223,130 @@ TEST_F(CollectionOverrideTest, RetrieveOverideByID) {
     auto op = coll2->get_override("override1");
     ASSERT_TRUE(op.ok());
 }
+
+TEST_F(CollectionOverrideTest, IndexedRuleMatchingWithManyOverrides) {
+    Collection *coll1;
+
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, false)};
+
+    coll1 = collectionManager.get_collection("coll1").get();
+    if(coll1 == nullptr) {
+        coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+    }
+
+    nlohmann::json doc;
+    doc["id"] = "0";
+    doc["title"] = "Quick brown fox";
+    doc["points"] = 100;
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json override_json = {
+            {"id", "rule-" + std::to_string(i)},
+            {"rule", {
+                {"query", "phrase " + std::to_string(i)},
+                {"match", (i % 2 == 0) ? override_t::MATCH_EXACT : override_t::MATCH_CONTAINS}
+            }},
+            {"metadata", {{"rule", i}}}
+        };
+
+        override_t override;
+        ASSERT_TRUE(override_t::parse(override_json, "", override).ok());
+        coll1->add_override(override);
+    }
+
+    // exact rule
+    auto results = coll1->search("phrase 42", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(42, results["metadata"]["rule"].get<size_t>());
+
+    // exact rule must not match when query has extra tokens
+    results = coll1->search("big phrase 42", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(0, results.count("metadata"));
+
+    // contains rule
+    results = coll1->search("big phrase 43 today", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(43, results["metadata"]["rule"].get<size_t>());
+
+    // contains rule matched only on word boundaries
+    results = coll1->search("big phrase 433", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(433, results["metadata"]["rule"].get<size_t>());
+
+    results = coll1->search("big phrase 4333", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(0, results.count("metadata"));
+
+    // update the rule: old phrase must no longer match
+    nlohmann::json override_json = {
+        {"id", "rule-43"},
+        {"rule", {{"query", "other words"}, {"match", override_t::MATCH_CONTAINS}}},
+        {"metadata", {{"rule", 43}}}
+    };
+
+    override_t override;
+    ASSERT_TRUE(override_t::parse(override_json, "", override).ok());
+    coll1->add_override(override);
+
+    results = coll1->search("big phrase 43 today", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(0, results.count("metadata"));
+
+    results = coll1->search("some other words", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(43, results["metadata"]["rule"].get<size_t>());
+
+    // removed rule
+    ASSERT_TRUE(coll1->remove_override("rule-42").ok());
+    results = coll1->search("phrase 42", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_EQ(0, results.count("metadata"));
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionOverrideTest, IndexedRuleMatchingAfterQueryRewrite) {
+    Collection *coll1;
+
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, false)};
+
+    coll1 = collectionManager.get_collection("coll1").get();
+    if(coll1 == nullptr) {
+        coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+    }
+
+    std::vector<std::string> titles = {"Nike running shoes", "Nike cap", "Leather shoes"};
+    for(size_t i = 0; i < titles.size(); i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = titles[i];
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    // the second rule only matches the query left behind by the first one
+    nlohmann::json override_json = {
+        {"id", "rule-1"},
+        {"rule", {{"query", "nike"}, {"match", override_t::MATCH_CONTAINS}}},
+        {"remove_matched_tokens", true},
+        {"stop_processing", false},
+        {"includes", {{{"id", "1"}, {"position", 1}}}}
+    };
+
+    override_t override;
+    ASSERT_TRUE(override_t::parse(override_json, "", override).ok());
+    coll1->add_override(override);
+
+    override_json = {
+        {"id", "rule-2"},
+        {"rule", {{"query", "shoes"}, {"match", override_t::MATCH_EXACT}}},
+        {"includes", {{{"id", "2"}, {"position", 2}}}}
+    };
+
+    override_t override2;
+    ASSERT_TRUE(override_t::parse(override_json, "", override2).ok());
+    coll1->add_override(override2);
+
+    auto results = coll1->search("nike shoes", {"title"}, "", {}, {}, {0}).get();
+    ASSERT_LE(2, results["hits"].size());
+    ASSERT_EQ("1", results["hits"][0]["document"]["id"].get<std::string>());
+    ASSERT_EQ("2", results["hits"][1]["document"]["id"].get<std::string>());
+
+    collectionManager.drop_collection("coll1");
+}
@@ -3,8 +3,10 @@
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <random>
 #include <collection_manager.h>
 #include "collection.h"
+#include "thread_local_vars.h"
 
 class CollectionSortingTest : public ::testing::Test {
 protected:
@@ -1130,6 +1132,92 @@ TEST_F(CollectionSortingTest, GeoPointArraySorting) {
     collectionManager.drop_collection("coll1");
 }
 
+TEST_F(CollectionSortingTest, GeoPointSortingNearestNeighbours) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("loc", field_types::GEOPOINT, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    // scatter points around Bengaluru, with a dense cluster close to the sort origin
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> spread(-1.0, 1.0);
+    std::vector<S2LatLng> lat_lngs;
+
+    for(size_t i = 0; i < 2000; i++) {
+        const double scale = (i % 4 == 0) ? 0.05 : 2.0;
+        const double lat = 12.97 + spread(rng) * scale;
+        const double lng = 77.59 + spread(rng) * scale;
+
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = "Store " + std::to_string(i);
+        doc["loc"] = {lat, lng};
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+        S2LatLng lat_lng;
+        GeoPoint::unpack_lat_lng(GeoPoint::pack_lat_lng(lat, lng), lat_lng);
+        lat_lngs.push_back(lat_lng);
+    }
+
+    const S2LatLng origin = S2LatLng::FromDegrees(12.9716, 77.5946);
+
+    auto expected_distances = [&](const std::function<bool(size_t)>& matches) {
+        std::vector<int64_t> distances;
+        for(size_t i = 0; i < lat_lngs.size(); i++) {
+            if(matches(i)) {
+                distances.push_back(GeoPoint::distance(lat_lngs[i], origin));
+            }
+        }
+        std::sort(distances.begin(), distances.end());
+        return distances;
+    };
+
+    std::vector<sort_by> geo_sort_fields = { sort_by("loc(12.9716, 77.5946)", "ASC") };
+
+    // only the documents close to the origin must be scored, while `found` still counts every match
+    search_num_scored_candidates = 0;
+    auto results = coll1->search("*", {}, "", {}, geo_sort_fields, {0}, 10, 3, FREQUENCY).get();
+
+    ASSERT_EQ(2000, results["found"].get<size_t>());
+    ASSERT_EQ(10, results["hits"].size());
+    ASSERT_LT(search_num_scored_candidates, 2000);
+
+    auto all_distances = expected_distances([](size_t) { return true; });
+    for(size_t i = 0; i < results["hits"].size(); i++) {
+        ASSERT_EQ(all_distances[20 + i], results["hits"][i]["geo_distance_meters"]["loc"].get<int64_t>());
+    }
+
+    // filtered ids are intersected with the nearest candidates
+    search_num_scored_candidates = 0;
+    results = coll1->search("*", {}, "points:>=1000", {}, geo_sort_fields, {0}, 10, 1, FREQUENCY).get();
+
+    ASSERT_EQ(1000, results["found"].get<size_t>());
+    ASSERT_EQ(10, results["hits"].size());
+    ASSERT_LT(search_num_scored_candidates, 1000);
+
+    auto filtered_distances = expected_distances([](size_t i) { return i >= 1000; });
+    for(size_t i = 0; i < results["hits"].size(); i++) {
+        ASSERT_LE(1000, std::stoi(results["hits"][i]["document"]["id"].get<std::string>()));
+        ASSERT_EQ(filtered_distances[i], results["hits"][i]["geo_distance_meters"]["loc"].get<int64_t>());
+    }
+
+    // an exclude radius buckets the nearest points together, so every document is scored
+    geo_sort_fields = {
+        sort_by("loc(12.9716, 77.5946, exclude_radius: 5km)", "ASC"),
+        sort_by("points", "DESC"),
+    };
+
+    search_num_scored_candidates = 0;
+    results = coll1->search("*", {}, "", {}, geo_sort_fields, {0}, 10, 1, FREQUENCY).get();
+
+    ASSERT_EQ(2000, results["found"].get<size_t>());
+    ASSERT_EQ(2000, search_num_scored_candidates);
+
+    collectionManager.drop_collection("coll1");
+}
+
 TEST_F(CollectionSortingTest, SortByTitle) {
     Collection *coll1;
 
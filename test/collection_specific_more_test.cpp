@@ -3012,4 +3012,240 @@ TEST_F(CollectionSpecificMoreTest, TestFieldStore) {
     ASSERT_EQ(1, res.get()["hits"].size());
     ASSERT_EQ("store", res.get()["hits"][0]["document"]["word_to_store"].get<std::string>());
     ASSERT_TRUE(res.get()["hits"][0]["document"].count("word_not_to_store") == 0);
-}
\ No newline at end of file
+}
+TEST_F(CollectionSpecificMoreTest, RepeatedPrefixSearchReflectsWrites) {
+    nlohmann::json schema = R"({
+         "name": "words",
+         "fields": [
+           {"name": "word", "type": "string"}
+         ]
+    })"_json;
+
+    auto coll_res = collectionManager.create_collection(schema);
+    ASSERT_TRUE(coll_res.ok());
+    auto coll = coll_res.get();
+
+    ASSERT_TRUE(coll->add(R"({"id": "0", "word": "walk"})"_json.dump()).ok());
+
+    auto res = coll->search("wal", {"word"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {true}, 0).get();
+    ASSERT_EQ(1, res["hits"].size());
+
+    // new keys split the nodes that were matched by the earlier search
+    ASSERT_TRUE(coll->add(R"({"id": "1", "word": "walker"})"_json.dump()).ok());
+    ASSERT_TRUE(coll->add(R"({"id": "2", "word": "wall"})"_json.dump()).ok());
+
+    res = coll->search("wal", {"word"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {true}, 0).get();
+    ASSERT_EQ(3, res["hits"].size());
+
+    ASSERT_TRUE(coll->remove("0").ok());
+    ASSERT_TRUE(coll->remove("2").ok());
+
+    res = coll->search("wal", {"word"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {true}, 0).get();
+    ASSERT_EQ(1, res["hits"].size());
+    ASSERT_EQ("1", res["hits"][0]["document"]["id"].get<std::string>());
+
+    // typo variant
+    res = coll->search("wakler", {"word"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}, 0).get();
+    ASSERT_EQ(1, res["hits"].size());
+    res = coll->search("wakler", {"word"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}, 0).get();
+    ASSERT_EQ(1, res["hits"].size());
+}
+
+TEST_F(CollectionSpecificMoreTest, PartitionedTextMatchScoringMatchesSequential) {
+    nlohmann::json schema = R"({
+         "name": "coll1",
+         "fields": [
+           {"name": "title", "type": "string"},
+           {"name": "brand", "type": "string", "facet": true},
+           {"name": "points", "type": "int32"}
+         ]
+    })"_json;
+
+    auto coll_res = collectionManager.create_collection(schema);
+    ASSERT_TRUE(coll_res.ok());
+    auto coll1 = coll_res.get();
+
+    // enough matches to be scored across several partitions
+    std::vector<std::string> json_lines;
+    for(size_t i = 0; i < 4 * Index::SEARCH_PARTITION_MIN_SIZE; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = (i % 3 == 0) ? "running shoe" : "shoe for running";
+        doc["brand"] = "brand" + std::to_string(i % 11);
+        doc["points"] = (i * 7919) % 1000;
+        json_lines.push_back(doc.dump());
+    }
+
+    nlohmann::json insert_doc;
+    auto import_res = coll1->add_many(json_lines, insert_doc);
+    ASSERT_TRUE(import_res["success"].get<bool>());
+
+    std::vector<sort_by> sort_fields = {sort_by("_text_match", "DESC"), sort_by("points", "DESC")};
+
+    auto search = [&](const std::vector<std::string>& group_by_fields) {
+        return coll1->search("running shoe", {"title"}, "points:>= 10", {"brand"}, sort_fields, {0}, 25, 1,
+                             FREQUENCY, {false}, 0, spp::sparse_hash_set<std::string>(),
+                             spp::sparse_hash_set<std::string>(), 10, "", 30, 4, "", 20, {}, {},
+                             group_by_fields, group_by_fields.empty() ? 0 : 2).get();
+    };
+
+    // the partition count is global: restore it before any assertion can end the test
+    const size_t num_search_partitions = Config::get_instance().get_num_search_partitions();
+
+    Config::get_instance().set_num_search_partitions(1);
+    auto sequential_res = search({});
+    auto sequential_grouped_res = search({"brand"});
+
+    Config::get_instance().set_num_search_partitions(4);
+    auto partitioned_res = search({});
+    auto partitioned_grouped_res = search({"brand"});
+
+    Config::get_instance().set_num_search_partitions(num_search_partitions);
+
+    ASSERT_EQ(sequential_res["found"], partitioned_res["found"]);
+    ASSERT_EQ(25, partitioned_res["hits"].size());
+    for(size_t i = 0; i < partitioned_res["hits"].size(); i++) {
+        ASSERT_EQ(sequential_res["hits"][i]["document"]["id"], partitioned_res["hits"][i]["document"]["id"]);
+        ASSERT_EQ(sequential_res["hits"][i]["text_match"], partitioned_res["hits"][i]["text_match"]);
+    }
+
+    ASSERT_EQ(sequential_res["facet_counts"], partitioned_res["facet_counts"]);
+
+    ASSERT_EQ(sequential_grouped_res["found"], partitioned_grouped_res["found"]);
+    ASSERT_EQ(sequential_grouped_res["grouped_hits"].size(), partitioned_grouped_res["grouped_hits"].size());
+    for(size_t i = 0; i < partitioned_grouped_res["grouped_hits"].size(); i++) {
+        ASSERT_EQ(sequential_grouped_res["grouped_hits"][i]["group_key"],
+                  partitioned_grouped_res["grouped_hits"][i]["group_key"]);
+        ASSERT_EQ(sequential_grouped_res["grouped_hits"][i]["hits"],
+                  partitioned_grouped_res["grouped_hits"][i]["hits"]);
+    }
+}
+
+TEST_F(CollectionSpecificMoreTest, SearchProfile) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("brand", field_types::STRING, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields).get();
+
+    std::vector<std::string> titles = {"running shoe", "running jacket", "tennis shoe", "walking shoe"};
+    for(size_t i = 0; i < titles.size(); i++) {
+        nlohmann::json doc;
+        doc["title"] = titles[i];
+        doc["brand"] = (i % 2 == 0) ? "nike" : "adidas";
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    std::map<std::string, std::string> req_params = {
+        {"collection", "coll1"},
+        {"q", "shoe"},
+        {"query_by", "title"},
+        {"filter_by", "points:>0 && brand:nike"},
+        {"facet_by", "brand"},
+        {"profile", "true"},
+    };
+
+    nlohmann::json embedded_params;
+    std::string json_res;
+    auto now_ts = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto search_op = collectionManager.do_search(req_params, embedded_params, json_res, now_ts);
+    ASSERT_TRUE(search_op.ok());
+
+    auto res = nlohmann::json::parse(json_res);
+    ASSERT_EQ(1, res["found"].get<size_t>());
+    ASSERT_EQ(1, res.count("profile"));
+
+    const auto& profile = res["profile"];
+    ASSERT_EQ(1, profile["stages_us"].count("hit_fetch"));
+    ASSERT_EQ(1, profile["stages_us"].count("token_search"));
+
+    // The more selective sub-expression is evaluated first and placed on the left.
+    ASSERT_EQ("AND", profile["filter"]["operator"]);
+    ASSERT_EQ(2, profile["filter"]["children"].size());
+    ASSERT_EQ("brand", profile["filter"]["children"][0]["field"]);
+    ASSERT_EQ(2, profile["filter"]["children"][0]["estimated_ids_length"].get<size_t>());
+    ASSERT_EQ("materialized", profile["filter"]["children"][0]["plan"]);
+    ASSERT_EQ("points", profile["filter"]["children"][1]["field"]);
+    ASSERT_EQ(3, profile["filter"]["children"][1]["approx_filter_ids_length"].get<size_t>());
+    ASSERT_EQ(1, profile["filter"]["children"][1].count("time_us"));
+
+    ASSERT_EQ(1, profile["token_candidates"].size());
+    ASSERT_EQ("shoe", profile["token_candidates"][0]["tokens"][0]["token"]);
+    ASSERT_EQ(3, profile["token_candidates"][0]["tokens"][0]["fields"]["title"].get<size_t>());
+    ASSERT_EQ(1, profile["token_candidates"][0]["num_matches"].get<size_t>());
+
+    ASSERT_EQ(1, profile["scoring"]["num_candidates"].get<size_t>());
+
+    ASSERT_EQ(1, profile["facets"].size());
+    ASSERT_EQ("brand", profile["facets"][0]["field"]);
+
+    // not returned unless asked for
+    req_params.erase("profile");
+    search_op = collectionManager.do_search(req_params, embedded_params, json_res, now_ts);
+    ASSERT_TRUE(search_op.ok());
+    ASSERT_EQ(0, nlohmann::json::parse(json_res).count("profile"));
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionSpecificMoreTest, MemoryUsagePerField) {
+    nlohmann::json schema = R"({
+        "name": "coll1",
+        "fields": [
+            {"name": "title", "type": "string", "infix": true},
+            {"name": "brand", "type": "string", "facet": true},
+            {"name": "points", "type": "int32"},
+            {"name": "tags", "type": "string[]", "optional": true}
+        ]
+    })"_json;
+
+    Collection* coll1 = collectionManager.create_collection(schema).get();
+
+    auto empty_usage = coll1->get_memory_usage();
+
+    for(size_t i = 0; i < 200; i++) {
+        nlohmann::json doc;
+        doc["title"] = "running shoe model " + std::to_string(i);
+        doc["brand"] = "brand" + std::to_string(i % 10);
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    auto usage = coll1->get_memory_usage();
+    ASSERT_EQ("coll1", usage["name"]);
+    ASSERT_EQ(200, usage["num_documents"].get<size_t>());
+
+    const auto& fields = usage["fields"];
+    ASSERT_LT(0, fields["title"]["art_tree"].get<uint64_t>());
+    ASSERT_LT(0, fields["title"]["posting_lists"].get<uint64_t>());
+    ASSERT_LT(0, fields["title"]["infix_index"].get<uint64_t>());
+    ASSERT_LT(0, fields["brand"]["facet_index"].get<uint64_t>());
+    ASSERT_LT(0, fields["points"]["num_tree"].get<uint64_t>());
+    ASSERT_LT(0, fields["points"]["sort_index"].get<uint64_t>());
+
+    // totals add up across fields and across structures
+    uint64_t fields_total = usage["structures"]["seq_ids"].get<uint64_t>();
+    for(const auto& field_usage: fields) {
+        fields_total += field_usage["total_bytes"].get<uint64_t>();
+    }
+
+    uint64_t structures_total = 0;
+    for(const auto& structure_bytes: usage["structures"]) {
+        structures_total += structure_bytes.get<uint64_t>();
+    }
+
+    ASSERT_EQ(usage["total_bytes"].get<uint64_t>(), fields_total);
+    ASSERT_EQ(usage["total_bytes"].get<uint64_t>(), structures_total);
+    ASSERT_LT(empty_usage["total_bytes"].get<uint64_t>(), usage["total_bytes"].get<uint64_t>());
+
+    auto all_usage = collectionManager.get_memory_usage();
+    ASSERT_EQ(1, all_usage["collections"].size());
+    ASSERT_EQ("coll1", all_usage["collections"][0]["name"]);
+    ASSERT_EQ(0, all_usage["collections"][0].count("fields"));
+    ASSERT_EQ(usage["total_bytes"], all_usage["total_bytes"]);
+
+    collectionManager.drop_collection("coll1");
+}
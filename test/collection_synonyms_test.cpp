@@ -277,6 +277,54 @@ TEST_F(CollectionSynonymsTest, SynonymReductionOneWay) {
     }
 }
 
+TEST_F(CollectionSynonymsTest, SynonymReductionCacheInvalidation) {
+    std::vector<std::vector<std::string>> results;
+
+    nlohmann::json synonym1 = R"({
+        "id": "nyc-expansion",
+        "root": "nyc",
+        "synonyms": ["new york"]
+    })"_json;
+
+    coll_mul_fields->add_synonym(synonym1);
+
+    // cached empty result for a query without synonyms
+    coll_mul_fields->synonym_reduction({"red", "tshirt"}, results);
+    ASSERT_EQ(0, results.size());
+
+    // repeated lookups must return the same expansion
+    for(size_t i = 0; i < 2; i++) {
+        results.clear();
+        coll_mul_fields->synonym_reduction({"red", "nyc", "tshirt"}, results);
+        ASSERT_EQ(1, results.size());
+        ASSERT_EQ(4, results[0].size());
+    }
+
+    nlohmann::json synonym2 = R"({
+        "id": "red-crimson",
+        "root": "red",
+        "synonyms": ["crimson"]
+    })"_json;
+
+    coll_mul_fields->add_synonym(synonym2);
+
+    results.clear();
+    coll_mul_fields->synonym_reduction({"red", "tshirt"}, results);
+    ASSERT_EQ(1, results.size());
+    ASSERT_EQ("crimson", results[0][0]);
+
+    coll_mul_fields->remove_synonym("red-crimson");
+    coll_mul_fields->remove_synonym("nyc-expansion");
+
+    results.clear();
+    coll_mul_fields->synonym_reduction({"red", "tshirt"}, results);
+    ASSERT_EQ(0, results.size());
+
+    results.clear();
+    coll_mul_fields->synonym_reduction({"red", "nyc", "tshirt"}, results);
+    ASSERT_EQ(0, results.size());
+}
+
 TEST_F(CollectionSynonymsTest, SynonymReductionMultiWay) {
     nlohmann::json synonym1 = R"({
         "id": "ipod-synonyms",
@@ -5250,3 +5250,53 @@ TEST_F(CollectionTest, CatchPartialResponseFromRemoteEmbedding) {
     ASSERT_EQ(res["response"]["error"], "Malformed response from OpenAI API.");
     ASSERT_EQ(res["request"]["body"], req_body);
 }
+
+TEST_F(CollectionTest, RemoteEmbedderSubBatchesRunConcurrentlyInOrder) {
+    std::vector<std::string> inputs;
+    for(size_t i = 0; i < 23; i++) {
+        inputs.push_back(std::to_string(i));
+    }
+
+    std::atomic<size_t> in_flight = 0;
+    std::atomic<size_t> max_in_flight = 0;
+    std::atomic<size_t> num_calls = 0;
+
+    auto outputs = RemoteEmbedder::embed_in_batches(inputs, 5, [&](const std::vector<std::string>& batch) {
+        num_calls++;
+        size_t now_in_flight = ++in_flight;
+        size_t prev_max = max_in_flight;
+        while(now_in_flight > prev_max && !max_in_flight.compare_exchange_weak(prev_max, now_in_flight)) {}
+
+        // simulate a round trip to the remote API
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::vector<embedding_res_t> batch_outputs;
+        for(const auto& input: batch) {
+            batch_outputs.emplace_back(std::vector<float>{std::stof(input)});
+        }
+
+        in_flight--;
+        return batch_outputs;
+    }, 3);
+
+    ASSERT_EQ(5, num_calls.load());
+    ASSERT_LE(max_in_flight.load(), 3);
+    ASSERT_GT(max_in_flight.load(), 1);
+
+    ASSERT_EQ(inputs.size(), outputs.size());
+    for(size_t i = 0; i < outputs.size(); i++) {
+        ASSERT_TRUE(outputs[i].success);
+        ASSERT_EQ(float(i), outputs[i].embedding[0]);
+    }
+
+    // a sub-batch that returns the wrong number of results is marked as failed
+    outputs = RemoteEmbedder::embed_in_batches(inputs, 10, [&](const std::vector<std::string>& batch) {
+        return std::vector<embedding_res_t>{embedding_res_t(std::vector<float>{1.0})};
+    });
+
+    ASSERT_EQ(inputs.size(), outputs.size());
+    for(const auto& output: outputs) {
+        ASSERT_FALSE(output.success);
+        ASSERT_EQ(500, output.status_code);
+    }
+}
@@ -5,6 +5,7 @@
 #include "collection.h"
 #include <cstdlib>
 #include <ctime>
+#include <random>
 #include "conversation_manager.h"
 #include "conversation_model_manager.h"
 #include "index.h"
@@ -4444,4 +4445,317 @@ TEST_F(CollectionVectorTest, TestInvalidOpenAIURL) {
     auto collection_create_op = collectionManager.create_collection(schema_json);
     ASSERT_FALSE(collection_create_op.ok());
     ASSERT_EQ("OpenAI API error: ", collection_create_op.error());
-}
\ No newline at end of file
+}
+
+TEST_F(CollectionVectorTest, ConcurrentLocalQueryEmbeddingsAreBatched) {
+    nlohmann::json schema = R"({
+                "name": "coll1",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "embedding", "type":"float[]", "embed":{"from": ["title"],
+                        "model_config": {"model_name": "ts/e5-small"}}}
+                ]
+            })"_json;
+
+    EmbedderManager::set_model_dir("/tmp/typesense_test/models");
+    ASSERT_TRUE(collectionManager.create_collection(schema).ok());
+
+    nlohmann::json model_config = R"({"model_name": "ts/e5-small"})"_json;
+    auto embedder = EmbedderManager::get_instance().get_text_embedder(model_config).get();
+
+    std::vector<std::string> queries = {"butter", "peanut butter", "apple pie", "jam", "bread", "honey"};
+    std::vector<std::vector<float>> expected;
+
+    Config::get_instance().set_local_embedding_max_batch_size(1);
+    for(const auto& query: queries) {
+        auto res = embedder->Embed(query);
+        ASSERT_TRUE(res.success);
+        expected.push_back(res.embedding);
+    }
+
+    Config::get_instance().set_local_embedding_max_batch_size(4);
+
+    std::vector<embedding_res_t> results(queries.size() * 4);
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&, i]() {
+            results[i] = embedder->Embed(queries[i % queries.size()]);
+        });
+    }
+
+    for(auto& t: threads) {
+        t.join();
+    }
+
+    Config::get_instance().set_local_embedding_max_batch_size(8);
+
+    for(size_t i = 0; i < results.size(); i++) {
+        ASSERT_TRUE(results[i].success);
+        const auto& expected_embedding = expected[i % queries.size()];
+        ASSERT_EQ(expected_embedding.size(), results[i].embedding.size());
+        for(size_t j = 0; j < expected_embedding.size(); j++) {
+            // padding within a batch only perturbs the pooled embedding slightly
+            ASSERT_NEAR(expected_embedding[j], results[i].embedding[j], 1e-4);
+        }
+    }
+}
+
+TEST_F(CollectionVectorTest, RepeatedQueriesAreServedFromQueryEmbeddingCache) {
+    nlohmann::json schema = R"({
+                "name": "coll1",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "embedding", "type":"float[]", "embed":{"from": ["title"],
+                        "model_config": {"model_name": "ts/e5-small"}}}
+                ]
+            })"_json;
+
+    EmbedderManager::set_model_dir("/tmp/typesense_test/models");
+    auto coll1 = collectionManager.create_collection(schema).get();
+
+    nlohmann::json doc;
+    doc["title"] = "peanut butter";
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    auto& embedder_manager = EmbedderManager::get_instance();
+    embedder_manager.clear_query_embedding_cache();
+
+    nlohmann::json stats;
+    embedder_manager.get_query_embedding_cache_stats(stats);
+    const uint64_t hits_before = stats["query_embedding_cache_hits"].get<uint64_t>();
+    const uint64_t misses_before = stats["query_embedding_cache_misses"].get<uint64_t>();
+
+    for(size_t i = 0; i < 3; i++) {
+        auto results = coll1->search("butter", {"embedding"}, "", {}, {}, {0}).get();
+        ASSERT_EQ(1, results["hits"].size());
+    }
+
+    embedder_manager.get_query_embedding_cache_stats(stats);
+    ASSERT_EQ(misses_before + 1, stats["query_embedding_cache_misses"].get<uint64_t>());
+    ASSERT_EQ(hits_before + 2, stats["query_embedding_cache_hits"].get<uint64_t>());
+
+    // cached embedding is the same as a fresh one
+    nlohmann::json model_config = R"({"model_name": "ts/e5-small"})"_json;
+    auto embedder = embedder_manager.get_text_embedder(model_config).get();
+    auto query = embedder_manager.get_query_prefix(model_config) + "butter";
+    auto cached = embedder_manager.embed_query(model_config, embedder, query, 30000, 2);
+    auto fresh = embedder->Embed(query);
+    ASSERT_TRUE(cached.success);
+    ASSERT_EQ(fresh.embedding, cached.embedding);
+
+    // a TTL of 0 disables caching for the model
+    model_config["query_cache_ttl"] = 0;
+    embedder_manager.get_query_embedding_cache_stats(stats);
+    const uint64_t misses = stats["query_embedding_cache_misses"].get<uint64_t>();
+    const uint64_t hits = stats["query_embedding_cache_hits"].get<uint64_t>();
+    ASSERT_TRUE(embedder_manager.embed_query(model_config, embedder, query, 30000, 2).success);
+    embedder_manager.get_query_embedding_cache_stats(stats);
+    ASSERT_EQ(misses, stats["query_embedding_cache_misses"].get<uint64_t>());
+    ASSERT_EQ(hits, stats["query_embedding_cache_hits"].get<uint64_t>());
+
+    schema = R"({
+                "name": "coll2",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "embedding", "type":"float[]", "embed":{"from": ["title"],
+                        "model_config": {"model_name": "ts/e5-small", "query_cache_ttl": "1h"}}}
+                ]
+            })"_json;
+
+    auto create_op = collectionManager.create_collection(schema);
+    ASSERT_FALSE(create_op.ok());
+    ASSERT_EQ("Property `embed.model_config.query_cache_ttl` must be a non-negative integer.", create_op.error());
+}
+
+TEST_F(CollectionVectorTest, UpdateKeepsEmbeddingsOfUnchangedSources) {
+    nlohmann::json schema = R"({
+        "name": "objects",
+        "fields": [
+            {"name": "name", "type": "string"},
+            {"name": "about", "type": "string"},
+            {"name": "name_embedding", "type":"float[]", "embed":{"from": ["name"], "model_config": {"model_name": "ts/e5-small"}}},
+            {"name": "about_embedding", "type":"float[]", "embed":{"from": ["about"], "model_config": {"model_name": "ts/e5-small"}}}
+        ]
+    })"_json;
+
+    EmbedderManager::set_model_dir("/tmp/typesense_test/models");
+
+    auto op = collectionManager.create_collection(schema);
+    ASSERT_TRUE(op.ok());
+    Collection* coll = op.get();
+
+    // a stored vector that the model would never produce, so that re-embedding is detectable
+    std::vector<float> stored_name_embedding(384, 0.0f);
+    stored_name_embedding[0] = 1.0f;
+
+    nlohmann::json object;
+    object["id"] = "0";
+    object["name"] = "butter";
+    object["about"] = "about butter";
+    object["name_embedding"] = stored_name_embedding;
+
+    ASSERT_TRUE(coll->add(object.dump(), CREATE).ok());
+
+    auto doc = coll->get("0").get();
+    ASSERT_EQ(stored_name_embedding, doc["name_embedding"].get<std::vector<float>>());
+    auto about_embedding = doc["about_embedding"].get<std::vector<float>>();
+
+    std::vector<index_operation_t> ops = {UPDATE, EMPLACE, UPSERT};
+    for(size_t i = 0; i < ops.size(); i++) {
+        nlohmann::json update_object;
+        update_object["id"] = "0";
+        update_object["name"] = "butter";
+        update_object["about"] = "something about butter " + std::to_string(i);
+        ASSERT_TRUE(coll->add(update_object.dump(), ops[i]).ok());
+
+        doc = coll->get("0").get();
+        ASSERT_EQ(stored_name_embedding, doc["name_embedding"].get<std::vector<float>>());
+        ASSERT_NE(about_embedding, doc["about_embedding"].get<std::vector<float>>());
+        about_embedding = doc["about_embedding"].get<std::vector<float>>();
+    }
+
+    // changing the source text re-embeds the field
+    nlohmann::json update_object;
+    update_object["id"] = "0";
+    update_object["name"] = "ghee";
+    ASSERT_TRUE(coll->add(update_object.dump(), UPDATE).ok());
+
+    doc = coll->get("0").get();
+    ASSERT_NE(stored_name_embedding, doc["name_embedding"].get<std::vector<float>>());
+    ASSERT_EQ(about_embedding, doc["about_embedding"].get<std::vector<float>>());
+}
+
+TEST_F(CollectionVectorTest, HybridSearchIsSameWithAndWithoutThreadPool) {
+    nlohmann::json schema = R"({
+        "name": "coll1",
+        "fields": [
+            {"name": "title", "type": "string"},
+            {"name": "points", "type": "int32"},
+            {"name": "vec", "type": "float[]", "num_dim": 4}
+        ]
+    })"_json;
+
+    Collection* coll1 = collectionManager.create_collection(schema).get();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(0, 1);
+
+    for(size_t i = 0; i < 200; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = (i % 3 == 0) ? "running shoes " + std::to_string(i) : "walking boots " + std::to_string(i);
+        doc["points"] = i;
+        doc["vec"] = std::vector<float>{dist(rng), dist(rng), dist(rng), dist(rng)};
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    auto hybrid_search = [&](const std::string& filter_by) {
+        auto results_op = coll1->search("shoes", {"title"}, filter_by, {}, {}, {0}, 50, 1, FREQUENCY, {true},
+                                        Index::DROP_TOKENS_THRESHOLD,
+                                        spp::sparse_hash_set<std::string>(),
+                                        spp::sparse_hash_set<std::string>(), 10, "", 30, 5,
+                                        "", 10, {}, {}, {}, 0,
+                                        "<mark>", "</mark>", {}, 1000, true, false, true, "", false, 6000 * 1000, 4, 7,
+                                        fallback,
+                                        4, {off}, 32767, 32767, 2,
+                                        false, true, "vec:([0.5, 0.25, 0.75, 0.1], k: 50)");
+        EXPECT_TRUE(results_op.ok());
+        return results_op.get();
+    };
+
+    for(const std::string filter_by: {"", "points:>50"}) {
+        auto results = hybrid_search(filter_by);
+
+        coll1->_get_index()->_set_thread_pool(nullptr);
+        auto sequential_results = hybrid_search(filter_by);
+        coll1->_get_index()->_set_thread_pool(collectionManager.get_thread_pool());
+
+        ASSERT_LT(0, results["hits"].size());
+        ASSERT_EQ(sequential_results["found"], results["found"]);
+        ASSERT_EQ(sequential_results["hits"].size(), results["hits"].size());
+
+        for(size_t i = 0; i < results["hits"].size(); i++) {
+            const auto& hit = results["hits"][i];
+            const auto& sequential_hit = sequential_results["hits"][i];
+            ASSERT_EQ(sequential_hit["document"]["id"], hit["document"]["id"]);
+            ASSERT_EQ(sequential_hit.count("vector_distance"), hit.count("vector_distance"));
+            if(hit.count("vector_distance") != 0) {
+                ASSERT_FLOAT_EQ(sequential_hit["vector_distance"].get<float>(), hit["vector_distance"].get<float>());
+            }
+        }
+    }
+}
+
+TEST_F(CollectionVectorTest, BulkBuiltVectorIndexMatchesSequentialInserts) {
+    nlohmann::json schema = R"({
+        "name": "bulk",
+        "fields": [
+            {"name": "title", "type": "string"},
+            {"name": "vec", "type": "float[]", "num_dim": 4}
+        ]
+    })"_json;
+
+    Collection* bulk_coll = collectionManager.create_collection(schema).get();
+
+    schema["name"] = "sequential";
+    Collection* sequential_coll = collectionManager.create_collection(schema).get();
+
+    std::mt19937 rng;
+    rng.seed(47);
+    std::uniform_real_distribution<> distrib;
+
+    // spans many chunks of a bulk build
+    const size_t n = 1000;
+    ASSERT_LE(hnsw_index_t::BULK_BUILD_MIN_BATCH, n);
+    ASSERT_LT(4 * hnsw_index_t::BULK_BUILD_CHUNK_SIZE, n);
+
+    std::vector<std::string> import_records;
+    for(size_t i = 0; i < n; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = std::to_string(i) + " title";
+        doc["vec"] = std::vector<float>{float(distrib(rng)), float(distrib(rng)), float(distrib(rng)),
+                                        float(distrib(rng))};
+        import_records.push_back(doc.dump());
+        ASSERT_TRUE(sequential_coll->add(doc.dump()).ok());
+    }
+
+    nlohmann::json document;
+    nlohmann::json import_response = bulk_coll->add_many(import_records, document);
+    ASSERT_TRUE(import_response["success"].get<bool>());
+    ASSERT_EQ(n, import_response["num_imported"].get<int>());
+
+    ASSERT_EQ(n, bulk_coll->_get_index()->_get_vector_index().at("vec")->num_bulk_built_points.load());
+    ASSERT_EQ(0, sequential_coll->_get_index()->_get_vector_index().at("vec")->num_bulk_built_points.load());
+
+    for(size_t q = 0; q < 20; q++) {
+        std::string query_vec = "vec:([" + std::to_string(distrib(rng)) + ", " + std::to_string(distrib(rng)) + ", " +
+                                std::to_string(distrib(rng)) + ", " + std::to_string(distrib(rng)) +
+                                "], k: 10, ef: 200)";
+
+        nlohmann::json results[2];
+        Collection* colls[2] = {bulk_coll, sequential_coll};
+
+        for(size_t c = 0; c < 2; c++) {
+            auto results_op = colls[c]->search("*", {}, "", {}, {}, {0}, 10, 1, FREQUENCY, {true},
+                                               Index::DROP_TOKENS_THRESHOLD,
+                                               spp::sparse_hash_set<std::string>(),
+                                               spp::sparse_hash_set<std::string>(), 10, "", 30, 5,
+                                               "", 10, {}, {}, {}, 0,
+                                               "<mark>", "</mark>", {}, 1000, true, false, true, "", false, 6000 * 1000,
+                                               4, 7, fallback, 4, {off}, 32767, 32767, 2,
+                                               false, true, query_vec);
+            ASSERT_TRUE(results_op.ok());
+            results[c] = results_op.get();
+        }
+
+        ASSERT_EQ(10, results[0]["hits"].size());
+        ASSERT_EQ(results[1]["hits"].size(), results[0]["hits"].size());
+
+        for(size_t i = 0; i < results[0]["hits"].size(); i++) {
+            ASSERT_EQ(results[1]["hits"][i]["document"]["id"], results[0]["hits"][i]["document"]["id"]);
+            ASSERT_FLOAT_EQ(results[1]["hits"][i]["vector_distance"].get<float>(),
+                            results[0]["hits"][i]["vector_distance"].get<float>());
+        }
+    }
+}
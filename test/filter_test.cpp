@@ -863,3 +863,244 @@ TEST_F(FilterTest, FilterTreeIteratorTimeout) {
     ASSERT_EQ(count, result->count); // With `override_timeout` true, we should get result.
     delete result;
 }
+
+TEST_F(FilterTest, NumericRangeFilterIterator) {
+    nlohmann::json schema =
+            R"({
+                "name": "Collection",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "points", "type": "int32", "range_index": true},
+                    {"name": "ratings", "type": "float[]", "range_index": true}
+                ]
+            })"_json;
+
+    Collection* coll = collectionManager.create_collection(schema).get();
+
+    for (size_t i = 0; i < 10; i++) {
+        nlohmann::json doc;
+        doc["title"] = (i % 3 == 0) ? "foo" : "bar";
+        doc["points"] = i;
+        doc["ratings"] = {i * 0.5, 1.0};
+
+        ASSERT_TRUE(coll->add(doc.dump()).ok());
+    }
+
+    const std::string doc_id_prefix = std::to_string(coll->get_collection_id()) + "_" + Collection::DOC_ID_PREFIX + "_";
+    filter_node_t* filter_tree_root = nullptr;
+    Option<bool> filter_op = filter::parse_filter_query("points: [2..7]", coll->get_schema(), store, doc_id_prefix,
+                                                        filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    auto iter_range_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_range_test.init_status().ok());
+    ASSERT_FALSE(iter_range_test._get_is_filter_result_initialized());
+    ASSERT_EQ(6, iter_range_test.approx_filter_ids_length);
+
+    std::vector<uint32_t> expected = {2, 3, 4, 5, 6, 7};
+    for (auto const& i : expected) {
+        ASSERT_EQ(filter_result_iterator_t::valid, iter_range_test.validity);
+        ASSERT_EQ(i, iter_range_test.seq_id);
+        iter_range_test.next();
+    }
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_range_test.validity);
+
+    iter_range_test.reset();
+    iter_range_test.skip_to(5);
+    ASSERT_EQ(filter_result_iterator_t::valid, iter_range_test.validity);
+    ASSERT_EQ(5, iter_range_test.seq_id);
+
+    ASSERT_EQ(1, iter_range_test.is_valid(6));
+    ASSERT_EQ(-1, iter_range_test.is_valid(8));
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_range_test.validity);
+
+    iter_range_test.reset();
+    iter_range_test.compute_iterators();
+    ASSERT_TRUE(iter_range_test._get_is_filter_result_initialized());
+
+    uint32_t* filter_ids = nullptr;
+    auto filter_ids_length = iter_range_test.to_filter_id_array(filter_ids);
+    std::unique_ptr<uint32_t[]> filter_ids_guard(filter_ids);
+    ASSERT_EQ(6, filter_ids_length);
+    for (uint32_t i = 0; i < filter_ids_length; i++) {
+        ASSERT_EQ(expected[i], filter_ids[i]);
+    }
+    delete filter_tree_root;
+
+    // Every document has the rating 1.0, ids are not repeated although they are present under both ratings.
+    filter_tree_root = nullptr;
+    filter_op = filter::parse_filter_query("ratings: >= 1.0 && title: foo", coll->get_schema(), store, doc_id_prefix,
+                                           filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    auto iter_and_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_and_test.init_status().ok());
+
+    expected = {0, 3, 6, 9};
+    for (auto const& i : expected) {
+        ASSERT_EQ(filter_result_iterator_t::valid, iter_and_test.validity);
+        ASSERT_EQ(i, iter_and_test.seq_id);
+        iter_and_test.next();
+    }
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_and_test.validity);
+    delete filter_tree_root;
+
+    // Filters with more than one comparison are still materialized.
+    filter_tree_root = nullptr;
+    filter_op = filter::parse_filter_query("points: [<2, >7]", coll->get_schema(), store, doc_id_prefix,
+                                           filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    auto iter_multi_value_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_multi_value_test.init_status().ok());
+    ASSERT_TRUE(iter_multi_value_test._get_is_filter_result_initialized());
+
+    expected = {0, 1, 8, 9};
+    for (auto const& i : expected) {
+        ASSERT_EQ(filter_result_iterator_t::valid, iter_multi_value_test.validity);
+        ASSERT_EQ(i, iter_multi_value_test.seq_id);
+        iter_multi_value_test.next();
+    }
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_multi_value_test.validity);
+    delete filter_tree_root;
+}
+
+TEST_F(FilterTest, FilterTreePlanning) {
+    nlohmann::json schema =
+            R"({
+                "name": "Collection",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "points", "type": "int32"}
+                ]
+            })"_json;
+
+    Collection* coll = collectionManager.create_collection(schema).get();
+
+    for (size_t i = 0; i < 20; i++) {
+        nlohmann::json doc;
+        doc["title"] = (i % 4 == 0) ? "foo" : "bar";
+        doc["points"] = i;
+
+        ASSERT_TRUE(coll->add(doc.dump()).ok());
+    }
+
+    const std::string doc_id_prefix = std::to_string(coll->get_collection_id()) + "_" + Collection::DOC_ID_PREFIX + "_";
+    filter_node_t* filter_tree_root = nullptr;
+    Option<bool> filter_op = filter::parse_filter_query("points: >= 0 && title: foo", coll->get_schema(), store,
+                                                        doc_id_prefix, filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    auto iter_estimate_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_estimate_test.init_status().ok());
+
+    auto profile = iter_estimate_test.get_profile();
+    ASSERT_EQ(0, profile.count("estimated_ids_length"));
+    ASSERT_EQ(2, profile["children"].size());
+    ASSERT_EQ(5, profile["children"][0]["estimated_ids_length"]);
+    ASSERT_EQ("title", profile["children"][0]["field"]);
+    ASSERT_EQ(20, profile["children"][1]["estimated_ids_length"]);
+    ASSERT_EQ("points", profile["children"][1]["field"]);
+
+    std::vector<uint32_t> expected = {0, 4, 8, 12, 16};
+    for (auto const& i : expected) {
+        ASSERT_EQ(filter_result_iterator_t::valid, iter_estimate_test.validity);
+        ASSERT_EQ(i, iter_estimate_test.seq_id);
+        iter_estimate_test.next();
+    }
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_estimate_test.validity);
+    delete filter_tree_root;
+
+    // The sub-expression that is estimated to match fewer ids is evaluated first. Since it does not match any document,
+    // the other sub-expression is not evaluated at all.
+    for (const auto& filter_query: {"title: foo && points: > 100", "points: > 100 && title: foo"}) {
+        filter_tree_root = nullptr;
+        filter_op = filter::parse_filter_query(filter_query, coll->get_schema(), store, doc_id_prefix, filter_tree_root);
+        ASSERT_TRUE(filter_op.ok());
+
+        auto iter_skip_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+        ASSERT_TRUE(iter_skip_test.init_status().ok());
+        ASSERT_EQ(filter_result_iterator_t::invalid, iter_skip_test.validity);
+        ASSERT_EQ(0, iter_skip_test.approx_filter_ids_length);
+
+        profile = iter_skip_test.get_profile();
+        for (const auto& child: profile["children"]) {
+            if (child["field"] == "title") {
+                ASSERT_EQ("skipped", child["plan"]);
+                ASSERT_EQ(5, child["estimated_ids_length"]);
+            } else {
+                ASSERT_EQ("empty", child["plan"]);
+                ASSERT_EQ(0, child["estimated_ids_length"]);
+            }
+        }
+
+        iter_skip_test.reset();
+        ASSERT_EQ(filter_result_iterator_t::invalid, iter_skip_test.validity);
+
+        iter_skip_test.compute_iterators();
+        uint32_t* filter_ids = nullptr;
+        ASSERT_EQ(0, iter_skip_test.to_filter_id_array(filter_ids));
+        delete[] filter_ids;
+        delete filter_tree_root;
+    }
+
+    // Skipped sub-expressions can be nested.
+    filter_tree_root = nullptr;
+    filter_op = filter::parse_filter_query("points: < 0 && (title: foo || points: [2..4])", coll->get_schema(), store,
+                                           doc_id_prefix, filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    auto iter_nested_skip_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_nested_skip_test.init_status().ok());
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_nested_skip_test.validity);
+
+    profile = iter_nested_skip_test.get_profile();
+    ASSERT_EQ("skipped", profile["children"][1]["plan"]);
+    ASSERT_EQ("OR", profile["children"][1]["operator"]);
+    ASSERT_EQ("empty", profile["children"][0]["plan"]);
+    ASSERT_EQ(8, profile["children"][1]["estimated_ids_length"]);
+    ASSERT_EQ(0, profile["children"][1].count("children"));
+    delete filter_tree_root;
+}
+
+TEST_F(FilterTest, FilterTreeEstimatesEachLeafOnce) {
+    nlohmann::json schema =
+            R"({
+                "name": "Collection",
+                "fields": [
+                    {"name": "title", "type": "string"},
+                    {"name": "points", "type": "int32"}
+                ]
+            })"_json;
+
+    Collection* coll = collectionManager.create_collection(schema).get();
+
+    for (size_t i = 0; i < 20; i++) {
+        nlohmann::json doc;
+        doc["title"] = (i % 4 == 0) ? "foo" : "bar";
+        doc["points"] = i;
+
+        ASSERT_TRUE(coll->add(doc.dump()).ok());
+    }
+
+    const std::string doc_id_prefix = std::to_string(coll->get_collection_id()) + "_" + Collection::DOC_ID_PREFIX + "_";
+    filter_node_t* filter_tree_root = nullptr;
+    Option<bool> filter_op = filter::parse_filter_query("points: >= 0 && title: foo && points: < 12 && points: > 2",
+                                                        coll->get_schema(), store, doc_id_prefix, filter_tree_root);
+    ASSERT_TRUE(filter_op.ok());
+
+    // The estimates of the sub-expressions are computed once for the whole tree, not again at each level.
+    const uint32_t num_leaf_estimates = filter_result_iterator_t::num_leaf_estimates.load();
+    auto iter_estimate_test = filter_result_iterator_t(coll->get_name(), coll->_get_index(), filter_tree_root);
+    ASSERT_TRUE(iter_estimate_test.init_status().ok());
+    ASSERT_EQ(num_leaf_estimates + 4, filter_result_iterator_t::num_leaf_estimates.load());
+
+    std::vector<uint32_t> expected = {4, 8};
+    for (auto const& i : expected) {
+        ASSERT_EQ(filter_result_iterator_t::valid, iter_estimate_test.validity);
+        ASSERT_EQ(i, iter_estimate_test.seq_id);
+        iter_estimate_test.next();
+    }
+    ASSERT_EQ(filter_result_iterator_t::invalid, iter_estimate_test.validity);
+    delete filter_tree_root;
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <s2/s2cap.h>
+#include <s2/s2earth.h>
+#include <s2/s2loop.h>
+#include "field.h"
+#include "geo_point_verifier.h"
+#include "logger.h"
+
+static std::vector<int64_t> random_points(std::mt19937& rng, double lat, double lng, double spread, size_t n) {
+    std::uniform_real_distribution<double> offset(-spread, spread);
+    std::vector<int64_t> points;
+
+    for(size_t i = 0; i < n; i++) {
+        double point_lat = std::max(-90.0, std::min(90.0, lat + offset(rng)));
+        double point_lng = lng + offset(rng);
+        if(point_lng > 180) {
+            point_lng -= 360;
+        } else if(point_lng < -180) {
+            point_lng += 360;
+        }
+
+        points.push_back(GeoPoint::pack_lat_lng(point_lat, point_lng));
+    }
+
+    return points;
+}
+
+static void assert_same_as_region(const S2Region& region, const geo_point_verifier_t& verifier,
+                                  const std::vector<int64_t>& points) {
+    std::vector<uint8_t> matches(points.size());
+    verifier.verify(points.data(), points.size(), matches.data());
+
+    for(size_t i = 0; i < points.size(); i++) {
+        S2LatLng lat_lng;
+        GeoPoint::unpack_lat_lng(points[i], lat_lng);
+        ASSERT_EQ(region.Contains(lat_lng.ToPoint()), bool(matches[i]));
+    }
+}
+
+TEST(GeoPointVerifierTest, CircleMatchesExactContainment) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat_dist(-89, 89);
+    std::uniform_real_distribution<double> lng_dist(-180, 180);
+    const std::vector<double> radii_meters = {5, 250, 2000, 50000, 1000000, 8000000};
+
+    for(size_t i = 0; i < 50; i++) {
+        for(const auto radius_meters: radii_meters) {
+            const double lat = lat_dist(rng), lng = lng_dist(rng);
+            S2Cap cap(S2LatLng::FromDegrees(lat, lng).ToPoint(),
+                      S1Angle::Radians(S2Earth::MetersToRadians(radius_meters)));
+            geo_point_verifier_t verifier(cap);
+
+            // sample around the boundary of the circle, including an odd tail that misses the SIMD lanes
+            const double spread = std::min(180.0, radius_meters / 111000 * 1.5 + 0.0001);
+            assert_same_as_region(cap, verifier, random_points(rng, lat, lng, spread, 1003));
+        }
+    }
+
+    // a circle spanning the antimeridian
+    S2Cap cap(S2LatLng::FromDegrees(-17.7, 179.9).ToPoint(), S1Angle::Radians(S2Earth::MetersToRadians(50000)));
+    geo_point_verifier_t verifier(cap);
+    assert_same_as_region(cap, verifier, random_points(rng, -17.7, 179.9, 1, 1000));
+}
+
+TEST(GeoPointVerifierTest, PolygonMatchesExactContainment) {
+    std::mt19937 rng(42);
+
+    std::vector<S2Point> vertices = {
+        S2LatLng::FromDegrees(48.875223042424125, 2.323509661928681).ToPoint(),
+        S2LatLng::FromDegrees(48.85745408145392, 2.3267084486160856).ToPoint(),
+        S2LatLng::FromDegrees(48.859636574404355, 2.351469427048221).ToPoint(),
+        S2LatLng::FromDegrees(48.87756059389807, 2.3443610121873206).ToPoint(),
+    };
+
+    S2Loop loop(vertices, S2Debug::DISABLE);
+    loop.Normalize();
+    geo_point_verifier_t verifier(loop);
+
+    assert_same_as_region(loop, verifier, random_points(rng, 48.866, 2.337, 0.05, 5000));
+}
+
+TEST(GeoPointVerifierTest, DISABLED_Benchmark) {
+    // dense urban dataset: 1M points within ~25 km of the center of Paris
+    std::mt19937 rng(42);
+    auto points = random_points(rng, 48.8566, 2.3522, 0.25, 1000000);
+
+    S2Cap cap(S2LatLng::FromDegrees(48.8566, 2.3522).ToPoint(), S1Angle::Radians(S2Earth::MetersToRadians(10000)));
+    geo_point_verifier_t verifier(cap);
+    std::vector<uint8_t> matches(points.size());
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    size_t num_matched = 0;
+
+    for(auto point: points) {
+        S2LatLng lat_lng;
+        GeoPoint::unpack_lat_lng(point, lat_lng);
+        num_matched += cap.Contains(lat_lng.ToPoint());
+    }
+
+    long long int timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken to verify " << points.size() << " points one by one: " << timeMicros
+              << "us, matched: " << num_matched;
+
+    begin = std::chrono::high_resolution_clock::now();
+    verifier.verify(points.data(), points.size(), matches.data());
+    num_matched = std::count(matches.begin(), matches.end(), 1);
+
+    timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken to verify " << points.size() << " points in batches: " << timeMicros
+              << "us, matched: " << num_matched;
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <map>
+#include "http_client.h"
+
+TEST(HttpClientTest, ReusesPooledHandles) {
+    HttpClient::get_instance().init("abcd");
+
+    nlohmann::json stats;
+    HttpClient::get_pool_stats(stats);
+    const uint64_t num_requests = stats["http_client_requests"].get<uint64_t>();
+    const uint64_t num_reused_handles = stats["http_client_reused_handles"].get<uint64_t>();
+    const uint64_t num_reused_connections = stats["http_client_reused_connections"].get<uint64_t>();
+
+    // nothing listens on this port: the requests fail right away, but their handles still go back to the pool
+    for(size_t i = 0; i < 3; i++) {
+        std::string response;
+        std::map<std::string, std::string> res_headers;
+        long status_code = HttpClient::get_response("http://127.0.0.1:1/", response, res_headers, {}, 1000);
+        ASSERT_EQ(500, status_code);
+    }
+
+    HttpClient::get_pool_stats(stats);
+    ASSERT_EQ(num_requests + 3, stats["http_client_requests"].get<uint64_t>());
+    ASSERT_LE(num_reused_handles + 2, stats["http_client_reused_handles"].get<uint64_t>());
+
+    // a failed request has no connection to reuse
+    ASSERT_EQ(num_reused_connections, stats["http_client_reused_connections"].get<uint64_t>());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "int64_btree.h"
+
+TEST(Int64BTreeTest, MatchesOrderedMap) {
+    std::mt19937_64 rng(42);
+
+    for(int64_t key_range: {50, 5000, 1000000}) {
+        int64_btree_t tree;
+        std::map<int64_t, void*> expected;
+
+        for(size_t i = 0; i < 100000; i++) {
+            const int64_t key = int64_t(rng() % key_range) - key_range / 2;
+            const auto op = rng() % 10;
+
+            if(op < 5) {
+                if(expected.count(key) == 0) {
+                    expected.emplace(key, (void*) (key + key_range));
+                    tree.insert(key, (void*) (key + key_range));
+                }
+            } else if(op < 8) {
+                ASSERT_EQ(expected.erase(key) == 1, tree.erase(key));
+            } else {
+                void** value = tree.find(key);
+                ASSERT_EQ(expected.count(key) == 1, value != nullptr);
+
+                auto it = tree.lower_bound(key);
+                auto expected_it = expected.lower_bound(key);
+                ASSERT_EQ(expected_it != expected.end(), it.valid());
+                if(it.valid()) {
+                    ASSERT_EQ(expected_it->first, it.key());
+                    ASSERT_EQ(expected_it->second, it.value());
+                }
+            }
+
+            ASSERT_EQ(expected.size(), tree.size());
+        }
+
+        auto expected_it = expected.begin();
+        for(auto it = tree.begin(); it.valid(); it.next(), ++expected_it) {
+            ASSERT_EQ(expected_it->first, it.key());
+        }
+        ASSERT_TRUE(expected_it == expected.end());
+
+        auto expected_rit = expected.rbegin();
+        for(auto it = tree.last(); it.valid(); it.prev(), ++expected_rit) {
+            ASSERT_EQ(expected_rit->first, it.key());
+        }
+        ASSERT_TRUE(expected_rit == expected.rend());
+
+        for(const auto& kv: expected) {
+            ASSERT_TRUE(tree.erase(kv.first));
+        }
+
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.begin().valid());
+        ASSERT_EQ(0, tree.memory_used());
+    }
+}
+
+TEST(Int64BTreeTest, BulkLoad) {
+    std::vector<std::pair<int64_t, void*>> sorted_kvs;
+    for(int64_t key = -100000; key < 100000; key += 3) {
+        sorted_kvs.emplace_back(key, (void*) (key + 100000));
+    }
+
+    int64_btree_t tree;
+    tree.bulk_load(sorted_kvs);
+    ASSERT_EQ(sorted_kvs.size(), tree.size());
+
+    size_t i = 0;
+    for(auto it = tree.begin(); it.valid(); it.next(), i++) {
+        ASSERT_EQ(sorted_kvs[i].first, it.key());
+        ASSERT_EQ(sorted_kvs[i].second, it.value());
+    }
+    ASSERT_EQ(sorted_kvs.size(), i);
+
+    ASSERT_EQ(-100000, tree.lower_bound(-100001).key());
+    ASSERT_EQ(-99997, tree.lower_bound(-99999).key());
+    ASSERT_FALSE(tree.lower_bound(100000).valid());
+    ASSERT_EQ(nullptr, tree.find(-99999));
+    ASSERT_EQ((void*) 3, *tree.find(-99997));
+
+    // the bulk loaded leaves have room for inserts, and split once they fill up
+    for(int64_t key = -99999; key < -90000; key += 3) {
+        tree.insert(key, nullptr);
+    }
+
+    int64_t prev_key = INT64_MIN;
+    for(auto it = tree.begin(); it.valid(); it.next()) {
+        ASSERT_LT(prev_key, it.key());
+        prev_key = it.key();
+    }
+
+    ASSERT_EQ(sorted_kvs.size() + 3333, tree.size());
+}
@@ -168,3 +168,82 @@ TEST(NumTreeTest, Iterator) {
     iterator.skip_to(100);
     ASSERT_FALSE(iterator.is_valid);
 }
+
+TEST(NumTreeTest, InsertBatch) {
+    // values 0..499 each get the seq ids of their multiples, with value 0 exceeding the compact list threshold
+    std::vector<std::pair<int64_t, uint32_t>> value_ids;
+    for(uint32_t seq_id = 0; seq_id < 1000; seq_id++) {
+        value_ids.emplace_back(seq_id % 500, seq_id);
+        value_ids.emplace_back(0, seq_id + 1000);
+    }
+
+    std::reverse(value_ids.begin(), value_ids.end());
+
+    num_tree_t tree;
+    tree.insert_batch(value_ids);
+    ASSERT_EQ(500, tree.size());
+
+    uint32_t* ids = nullptr;
+    size_t ids_len = 0;
+
+    tree.search(NUM_COMPARATOR::EQUALS, 0, &ids, ids_len);
+    ASSERT_EQ(1002, ids_len);
+    delete [] ids;
+    ids = nullptr;
+    ids_len = 0;
+
+    tree.search(NUM_COMPARATOR::LESS_THAN, 250, &ids, ids_len);
+    ASSERT_EQ(1500, ids_len);
+    delete [] ids;
+    ids = nullptr;
+    ids_len = 0;
+
+    tree.range_inclusive_search(100, 199, &ids, ids_len);
+    ASSERT_EQ(200, ids_len);
+    ASSERT_EQ(100, ids[0]);
+    ASSERT_EQ(699, ids[199]);
+    delete [] ids;
+    ids = nullptr;
+    ids_len = 0;
+
+    // batches into a non-empty tree are merged with the existing values
+    value_ids = {{499, 2000}, {1000, 2001}};
+    tree.insert_batch(value_ids);
+    ASSERT_EQ(501, tree.size());
+
+    tree.search(NUM_COMPARATOR::GREATER_THAN_EQUALS, 499, &ids, ids_len);
+    ASSERT_EQ(4, ids_len);
+    ASSERT_EQ(499, ids[0]);
+    ASSERT_EQ(999, ids[1]);
+    ASSERT_EQ(2000, ids[2]);
+    ASSERT_EQ(2001, ids[3]);
+    delete [] ids;
+}
+
+TEST(NumTreeTest, RangeInclusiveForEach) {
+    num_tree_t tree;
+    for(uint32_t seq_id = 0; seq_id < 200; seq_id++) {
+        tree.insert(seq_id / 2, seq_id);
+    }
+
+    std::vector<int64_t> values;
+    std::vector<std::vector<uint32_t>> value_ids;
+    tree.range_inclusive_for_each(10, 12, [&](int64_t value, const std::vector<uint32_t>& ids) {
+        values.push_back(value);
+        value_ids.push_back(ids);
+    });
+
+    ASSERT_EQ(3, values.size());
+    for(size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(10 + i, values[i]);
+        ASSERT_EQ(2, value_ids[i].size());
+        ASSERT_EQ(values[i] * 2, value_ids[i][0]);
+        ASSERT_EQ(values[i] * 2 + 1, value_ids[i][1]);
+    }
+
+    values.clear();
+    tree.range_inclusive_for_each(100, 200, [&](int64_t value, const std::vector<uint32_t>& ids) {
+        values.push_back(value);
+    });
+    ASSERT_TRUE(values.empty());
+}
@@ -639,6 +639,67 @@ TEST_F(NumericRangeTrieTest, IterateSearchEqualTo) {
     ASSERT_EQ(false, iterator.is_valid);
 }
 
+TEST_F(NumericRangeTrieTest, IterateSearchRange) {
+    auto trie = new NumericTrie();
+    std::unique_ptr<NumericTrie> trie_guard(trie);
+
+    // Matched nodes hold both compact and full id lists and every id is present under two values.
+    for (uint32_t seq_id = 0; seq_id < 1000; seq_id++) {
+        trie->insert((int32_t) (seq_id % 300) - 150, seq_id);
+        trie->insert((int32_t) (seq_id % 7) * 1000, seq_id);
+    }
+
+    uint32_t* ids = nullptr;
+    uint32_t ids_length = 0;
+    trie->search_range(-100, true, 2000, true, ids, ids_length);
+    std::unique_ptr<uint32_t[]> ids_guard(ids);
+    ASSERT_EQ(885, ids_length);
+
+    auto iterator = trie->search_range(-100, true, 2000, true);
+    ASSERT_TRUE(iterator.is_valid);
+    ASSERT_LE(ids_length, iterator.approx_filter_ids_length);
+
+    for (uint32_t i = 0; i < ids_length; i++) {
+        ASSERT_TRUE(iterator.is_valid);
+        ASSERT_EQ(ids[i], iterator.seq_id);
+        iterator.next();
+    }
+    ASSERT_FALSE(iterator.is_valid);
+
+    reset(ids, ids_length);
+    ids_guard.release();
+    trie->search_range(-10, true, 10, false, ids, ids_length);
+    ids_guard.reset(ids);
+    ASSERT_EQ(194, ids_length);
+
+    iterator = trie->search_range(-10, true, 10, false);
+    for (uint32_t target = 0; target < 1000; target += 97) {
+        iterator.skip_to(target);
+
+        auto const expected = std::lower_bound(ids, ids + ids_length, target);
+        if (expected == ids + ids_length) {
+            ASSERT_FALSE(iterator.is_valid);
+            break;
+        }
+
+        ASSERT_TRUE(iterator.is_valid);
+        ASSERT_EQ(*expected, iterator.seq_id);
+    }
+
+    iterator.reset();
+    ASSERT_TRUE(iterator.is_valid);
+    ASSERT_EQ(ids[0], iterator.seq_id);
+
+    // skip_to an id that is behind the iterator is a no-op.
+    iterator.skip_to(ids[2]);
+    iterator.skip_to(ids[1]);
+    ASSERT_EQ(ids[2], iterator.seq_id);
+
+    iterator = trie->search_range(6001, true, 8000, true);
+    ASSERT_FALSE(iterator.is_valid);
+    ASSERT_EQ(0, iterator.approx_filter_ids_length);
+}
+
 TEST_F(NumericRangeTrieTest, MultivalueData) {
     auto trie = new NumericTrie();
     std::unique_ptr<NumericTrie> trie_guard(trie);
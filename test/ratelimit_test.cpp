@@ -817,3 +817,47 @@ TEST_F(RateLimitManagerTest, TestOneToManyFillTest) {
 
     EXPECT_FALSE(manager->is_rate_limited({RateLimitedEntityType::api_key, "test1"}, {RateLimitedEntityType::ip, "0.0.0.1"}));
 }
+
+TEST_F(RateLimitManagerTest, TestConcurrentRequestsAcrossThreads) {
+    manager->add_rule({
+        {"action", "throttle"},
+        {"ip_addresses", nlohmann::json::array({".*"})},
+        {"max_requests_1m", 1000},
+        {"max_requests_1h", 100000},
+        {"apply_limit_per_entity", true}
+    });
+
+    const size_t requests_per_thread = 1500;
+
+    for(size_t num_threads: {1, 2, 4, 8, 16, 32}) {
+        std::vector<std::thread> threads;
+        std::vector<size_t> allowed(num_threads, 0);
+
+        auto begin = std::chrono::high_resolution_clock::now();
+
+        for(size_t i = 0; i < num_threads; i++) {
+            threads.emplace_back([&, i]() {
+                const std::string ip = "10.0." + std::to_string(num_threads) + "." + std::to_string(i);
+                for(size_t j = 0; j < requests_per_thread; j++) {
+                    if(!manager->is_rate_limited({RateLimitedEntityType::api_key, "test"}, {RateLimitedEntityType::ip, ip})) {
+                        allowed[i]++;
+                    }
+                }
+            });
+        }
+
+        for(auto& thread: threads) {
+            thread.join();
+        }
+
+        auto time_micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - begin).count();
+        LOG(INFO) << "threads: " << num_threads << ", requests/s: "
+                  << (num_threads * requests_per_thread * 1000 * 1000) / std::max<int64_t>(time_micros, 1);
+
+        // every IP is counted on its own
+        for(size_t i = 0; i < num_threads; i++) {
+            ASSERT_EQ(1000, allowed[i]);
+        }
+    }
+}
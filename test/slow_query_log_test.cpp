@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <thread>
+#include "slow_query_log.h"
+
+class SlowQueryLogTest : public ::testing::Test {
+protected:
+    std::string log_dir = "/tmp/typesense_test/slow_query_log_test";
+    std::string log_path = log_dir + "/slow.log";
+
+    virtual void SetUp() {
+        system(("rm -rf " + log_dir + " && mkdir -p " + log_dir).c_str());
+    }
+
+    virtual void TearDown() {
+        SlowQueryLog::get_instance().init("");
+    }
+
+    static std::vector<std::string> read_lines(const std::string& path) {
+        std::vector<std::string> lines;
+        std::ifstream infile(path);
+        std::string line;
+        while(std::getline(infile, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+TEST_F(SlowQueryLogTest, RecordsAreDroppedWhenDisabled) {
+    SlowQueryLog::get_instance().init("");
+    ASSERT_FALSE(SlowQueryLog::get_instance().is_enabled());
+    ASSERT_FALSE(SlowQueryLog::get_instance().log(R"({"collection": "coll1"})"));
+}
+
+TEST_F(SlowQueryLogTest, WritesRecordsInTheBackground) {
+    SlowQueryLog::get_instance().init(log_path);
+    ASSERT_TRUE(SlowQueryLog::get_instance().is_enabled());
+
+    std::thread writer([]() {
+        SlowQueryLog::get_instance().run();
+    });
+
+    // no ASSERTs while the writer runs: returning early with a joinable thread would terminate the test binary
+    EXPECT_TRUE(SlowQueryLog::get_instance().log(R"({"collection": "coll1", "time_us": 1200})"));
+    EXPECT_TRUE(SlowQueryLog::get_instance().log(R"({"collection": "coll2", "time_us": 3400})"));
+
+    // pending records are written before the writer stops
+    SlowQueryLog::get_instance().stop();
+    writer.join();
+
+    auto lines = read_lines(log_path);
+    ASSERT_EQ(2, lines.size());
+    ASSERT_EQ(R"({"collection": "coll1", "time_us": 1200})", lines[0]);
+    ASSERT_EQ(R"({"collection": "coll2", "time_us": 3400})", lines[1]);
+
+    ASSERT_FALSE(SlowQueryLog::get_instance().log(R"({"collection": "coll3"})"));
+}
+
+TEST_F(SlowQueryLogTest, RotatesBySize) {
+    const std::string record = std::string(40, 'x');
+    SlowQueryLog::get_instance().init(log_path, 100);
+
+    std::thread writer([]() {
+        SlowQueryLog::get_instance().run();
+    });
+
+    // two records fit in a file
+    for(size_t i = 0; i < 2 * (SlowQueryLog::NUM_ROTATED_FILES + 2); i++) {
+        EXPECT_TRUE(SlowQueryLog::get_instance().log(std::string(record)));
+    }
+
+    SlowQueryLog::get_instance().stop();
+    writer.join();
+
+    ASSERT_EQ(2, read_lines(log_path).size());
+    for(size_t i = 1; i <= SlowQueryLog::NUM_ROTATED_FILES; i++) {
+        ASSERT_EQ(2, read_lines(log_path + "." + std::to_string(i)).size());
+    }
+
+    // the oldest file is discarded
+    ASSERT_FALSE(std::ifstream(log_path + "." + std::to_string(SlowQueryLog::NUM_ROTATED_FILES + 1)).good());
+}